@@ -1,12 +1,17 @@
 #include "ble/bin_receive.h"
 #include "ble/ble_bridge.h"
+#include "console/serial_transport.h"
 #include "core/sys_paths.h"
 #include "core/app_manager.h"
+#include "core/app_index.h"
+#include "utils/icon_cache.h"
 #include "utils/log_config.h"
+#include "utils/mem_tags.h"
 #include "utils/name_gen.h"
 #include <Arduino.h>
 #include <esp_heap_caps.h>
 #include <LittleFS.h>
+#include <esp_rom_crc.h>
 #include <cstring>
 
 static const char* TAG = "BinReceive";
@@ -28,6 +33,19 @@ static uint32_t   s_fileCount = 0;
 static bool       s_multiMode = false;
 static bool       s_readyToSave = false;  // deferred save — BLE callback sets, main loop processes
 
+// File window mode (file write)
+static bool       s_fileMode = false;
+static char       s_path[128] = {};
+static uint32_t   s_fileOffset = 0;
+static uint32_t   s_fileCrc = 0;
+static bool       s_checkCrc = false;
+static bool       s_serial = false;       // data and reply on Serial
+static uint32_t   s_windowId = 0;
+static uint32_t   s_lastData = 0;         // millis() of attach / last Serial bytes
+
+// Serial window with no bytes for this long is dropped (host gone or short)
+static const uint32_t SERIAL_IDLE_MS = 3000;
+
 // ─── validation ───────────────────────────────────────────────────────────
 
 /// Simple XML validation: check that <app> and </app> are present and balanced
@@ -145,6 +163,10 @@ static bool saveOneFile(const char* appName, const char* fileName, const uint8_t
         return false;
     }
 
+    // Replaced icon: drop its decoded copy
+    const char* dot = strrchr(fullPath, '.');
+    if (dot && strcmp(dot, ".png") == 0) IconCache::invalidate(fullPath);
+
     LOG_I(Log::APP, "Saved %s (%u bytes)", fullPath, size);
     return true;
 }
@@ -172,20 +194,54 @@ static bool saveMultiFiles() {
 
 static void cleanup() {
     if (s_buffer) {
-        heap_caps_free(s_buffer);
+        MemTags::free(s_buffer);
         s_buffer = nullptr;
     }
     s_active = false;
     s_readyToSave = false;
+    s_fileMode = false;
+    s_serial = false;
 }
 
 /// Send result back on text channel
 static void sendResult(bool ok, const char* msg) {
-    // JSON on text char: {"cmd":"push","status":"ok"/"error","msg":"..."}
+    // JSON on text char: {"cmd":"push"|"write","status":"ok"/"error","msg":"..."}
     char buf[128];
-    snprintf(buf, sizeof(buf), "{\"cmd\":\"push\",\"status\":\"%s\",\"msg\":\"%s\"}",
-             ok ? "ok" : "error", msg);
-    BLEBridge::send(P::String(buf));
+    snprintf(buf, sizeof(buf), "{\"cmd\":\"%s\",\"status\":\"%s\",\"msg\":\"%s\"}",
+             s_fileMode ? "write" : "push", ok ? "ok" : "error", msg);
+    if (s_serial) Console::SerialTransport::instance().sendText(buf);
+    else BLEBridge::send(P::String(buf));
+}
+
+/// Write the received window at its offset (offset 0 truncates)
+static bool saveWindow() {
+    File f;
+    if (s_fileOffset == 0) {
+        f = LittleFS.open(s_path, "w");
+    } else {
+        f = LittleFS.open(s_path, "r+");
+        if (f && f.size() < s_fileOffset) {
+            LOG_E(Log::APP, "Write at %u past end of %s (%u)", s_fileOffset, s_path, (unsigned)f.size());
+            f.close();
+            return false;
+        }
+        if (f) f.seek(s_fileOffset);
+    }
+    if (!f) {
+        LOG_E(Log::APP, "Failed to open %s for writing", s_path);
+        return false;
+    }
+    size_t written = f.write(s_buffer, s_received);
+    f.close();
+    if (written != s_received) {
+        LOG_E(Log::APP, "Write failed: %u/%u bytes", (unsigned)written, s_received);
+        return false;
+    }
+
+    const char* dot = strrchr(s_path, '.');
+    if (dot && strcmp(dot, ".png") == 0) IconCache::invalidate(s_path);
+    LOG_I(Log::APP, "Wrote %s @%u (%u bytes)", s_path, s_fileOffset, s_received);
+    return true;
 }
 
 // ─── public API ───────────────────────────────────────────────────────────
@@ -201,7 +257,7 @@ bool start(const char* appName, const char* fileName, uint32_t expectedSize) {
         return false;
     }
 
-    s_buffer = (uint8_t*)heap_caps_malloc(expectedSize, MALLOC_CAP_SPIRAM);
+    s_buffer = (uint8_t*)MemTags::alloc(MemTags::Ble, expectedSize, MALLOC_CAP_SPIRAM);
     if (!s_buffer) {
         LOG_E(Log::BLE, "Failed to allocate %u bytes", expectedSize);
         return false;
@@ -237,7 +293,7 @@ bool startMulti(const char* appName, const FileEntry* files, uint32_t fileCount,
         return false;
     }
 
-    s_buffer = (uint8_t*)heap_caps_malloc(totalSize, MALLOC_CAP_SPIRAM);
+    s_buffer = (uint8_t*)MemTags::alloc(MemTags::Ble, totalSize, MALLOC_CAP_SPIRAM);
     if (!s_buffer) {
         LOG_E(Log::BLE, "Failed to allocate %u bytes", totalSize);
         return false;
@@ -256,6 +312,66 @@ bool startMulti(const char* appName, const FileEntry* files, uint32_t fileCount,
     return true;
 }
 
+bool startFile(const char* path, uint32_t offset, uint32_t size, uint32_t crc, bool checkCrc) {
+    if (s_active) {
+        LOG_W(Log::BLE, "BinReceive already active, cancelling");
+        cancel();
+    }
+
+    if (size == 0 || size > FILE_WINDOW || strlen(path) >= sizeof(s_path)) {
+        LOG_E(Log::BLE, "Invalid file window: %s, %u bytes", path, size);
+        return false;
+    }
+
+    s_buffer = (uint8_t*)MemTags::alloc(MemTags::Ble, size, MALLOC_CAP_SPIRAM);
+    if (!s_buffer) {
+        LOG_E(Log::BLE, "Failed to allocate %u bytes", size);
+        return false;
+    }
+
+    strcpy(s_path, path);
+    s_fileOffset = offset;
+    s_fileCrc = crc;
+    s_checkCrc = checkCrc;
+    s_fileMode = true;
+    s_serial = false;
+    if (++s_windowId == 0) s_windowId = 1;
+    s_expectedSize = size;
+    s_received = 0;
+    s_expectedChunk = 0;
+    s_multiMode = false;
+    s_fileCount = 0;
+    s_active = true;
+
+    LOG_I(Log::BLE, "BinReceive file: %s @%u, %u bytes", path, offset, size);
+    return true;
+}
+
+uint32_t fileWindow() {
+    return s_active && s_fileMode ? s_windowId : 0;
+}
+
+void attachSerial() {
+    if (!s_active) return;
+    s_serial = true;
+    s_lastData = millis();
+}
+
+uint32_t serialPending() {
+    if (!s_active || !s_serial || s_readyToSave) return 0;
+    return s_expectedSize - s_received;
+}
+
+void onData(const uint8_t* data, uint32_t len) {
+    if (!s_active || !s_buffer || s_readyToSave) return;
+
+    if (s_received + len > s_expectedSize) len = s_expectedSize - s_received;
+    memcpy(s_buffer + s_received, data, len);
+    s_received += len;
+    s_lastData = millis();
+    if (s_received >= s_expectedSize) s_readyToSave = true;
+}
+
 void onChunk(const uint8_t* data, uint32_t len) {
     if (!s_active || !s_buffer) return;
 
@@ -306,9 +422,32 @@ bool isInProgress() {
 }
 
 void process() {
+    // Stalled Serial window: give the console back instead of eating it
+    if (s_active && s_serial && !s_readyToSave && millis() - s_lastData > SERIAL_IDLE_MS) {
+        LOG_W(Log::APP, "Serial window timed out: %u/%u bytes", s_received, s_expectedSize);
+        sendResult(false, "timeout");
+        cleanup();
+        return;
+    }
     if (!s_readyToSave) return;
     s_readyToSave = false;
 
+    if (s_fileMode) {
+        bool ok = s_received == s_expectedSize;
+        const char* msg = ok ? "written" : "size mismatch";
+        if (ok && s_checkCrc && esp_rom_crc32_le(0, s_buffer, s_received) != s_fileCrc) {
+            ok = false;
+            msg = "crc mismatch";
+        }
+        if (ok && !saveWindow()) {
+            ok = false;
+            msg = "write failed";
+        }
+        sendResult(ok, msg);
+        cleanup();
+        return;
+    }
+
     bool valid = validate();
     bool saved = false;
     if (valid) {
@@ -328,6 +467,7 @@ void process() {
 
     // Refresh launcher so new/updated app appears immediately
     if (saved) {
+        AppIndex::invalidate(s_appName);
         App::Manager::instance().refreshApps();
     }
 }
@@ -13,6 +13,13 @@
  *   BinReceive::startMulti("weather", {{"weather.bax",1984},{"icon.png",512}}, 2496)
  *   Blob is split by sizes and each file saved separately.
  *
+ * File window (file write):
+ *   BinReceive::startFile("/data/log.csv", offset, size, crc)
+ *   One window (<= FILE_WINDOW) is buffered, CRC-checked, then written at
+ *   offset — large files go as several windows, memory stays constant.
+ *   Over Serial the window's raw bytes follow the command line (onData);
+ *   a Serial window that gets no bytes for 3 s is dropped ("timeout" result).
+ *
  * Chunk format: [2B chunk_id LE][up to 250B data]
  * Completes when received bytes == expected size.
  */
@@ -29,6 +36,23 @@ bool start(const char* appName, const char* fileName, uint32_t expectedSize);
 /// Start multi-file receive (app push *)
 bool startMulti(const char* appName, const FileEntry* files, uint32_t fileCount, uint32_t totalSize);
 
+static constexpr uint32_t FILE_WINDOW = 32 * 1024;
+
+/// Start file window receive (file write). checkCrc: verify crc32 (zlib) before writing
+bool startFile(const char* path, uint32_t offset, uint32_t size, uint32_t crc, bool checkCrc);
+
+/// Id of the open file window, 0 if none (new id on every startFile)
+uint32_t fileWindow();
+
+/// Window bytes come from Serial, reply goes to Serial
+void attachSerial();
+
+/// Bytes still expected from Serial (0 = not feeding from Serial)
+uint32_t serialPending();
+
+/// Raw bytes without chunk header (Serial)
+void onData(const uint8_t* data, uint32_t len);
+
 /// Called from BIN_CHAR write callback
 void onChunk(const uint8_t* data, uint32_t len);
 
@@ -1,5 +1,6 @@
 #include "ble/bin_transfer.h"
 #include "ble/ble_bridge.h"
+#include "console/console.h"
 #include "utils/log_config.h"
 #include <esp_heap_caps.h>
 #include <Arduino.h>
@@ -12,11 +13,27 @@ namespace BinTransfer {
 static const uint32_t CHUNK_DATA_SIZE = 250;  // NimBLE max notify (252) - 2B header
 
 static uint8_t*  s_buffer = nullptr;
+static Console::PayloadSource* s_source = nullptr;
 static uint32_t  s_totalSize = 0;
 static uint32_t  s_offset = 0;
 static uint16_t  s_chunkId = 0;
 static bool      s_active = false;
 
+// Current chunk, kept until BLE accepts it (a source cannot re-read)
+static uint8_t   s_packet[252];
+static uint32_t  s_packetLen = 0;
+
+static void release() {
+    if (s_buffer) {
+        heap_caps_free(s_buffer);
+        s_buffer = nullptr;
+    }
+    delete s_source;
+    s_source = nullptr;
+    s_packetLen = 0;
+    s_active = false;
+}
+
 void start(uint8_t* buffer, uint32_t size) {
     if (s_active) cancel();
 
@@ -24,35 +41,59 @@ void start(uint8_t* buffer, uint32_t size) {
     s_totalSize = size;
     s_offset = 0;
     s_chunkId = 0;
+    s_packetLen = 0;
     s_active = true;
 
     LOG_I(Log::BLE, "BinTransfer start: %u bytes, buf=%p, ble_connected=%d",
           size, buffer, BLEBridge::isConnected() ? 1 : 0);
 }
 
+void startStream(Console::PayloadSource* source) {
+    if (s_active) cancel();
+    if (!source) return;
+
+    s_source = source;
+    s_totalSize = source->size();
+    s_offset = 0;
+    s_chunkId = 0;
+    s_packetLen = 0;
+    s_active = true;
+
+    LOG_I(Log::BLE, "BinTransfer stream: %u bytes, ble_connected=%d",
+          s_totalSize, BLEBridge::isConnected() ? 1 : 0);
+}
+
 bool sendNextChunk() {
-    if (!s_active || !s_buffer) return false;
+    if (!s_active || (!s_buffer && !s_source)) return false;
 
     // All data sent — done
     if (s_offset >= s_totalSize) {
         LOG_I(Log::BLE, "BinTransfer done: %u chunks, %u bytes", s_chunkId, s_totalSize);
-
-        heap_caps_free(s_buffer);
-        s_buffer = nullptr;
-        s_active = false;
+        release();
         return false;
     }
 
-    uint32_t remaining = s_totalSize - s_offset;
-    uint32_t dataSize = (remaining < CHUNK_DATA_SIZE) ? remaining : CHUNK_DATA_SIZE;
-
-    // [2B chunk_id LE][data]
-    uint8_t packet[252];
-    packet[0] = s_chunkId & 0xFF;
-    packet[1] = (s_chunkId >> 8) & 0xFF;
-    memcpy(packet + 2, s_buffer + s_offset, dataSize);
+    if (!s_packetLen) {
+        uint32_t remaining = s_totalSize - s_offset;
+        uint32_t want = (remaining < CHUNK_DATA_SIZE) ? remaining : CHUNK_DATA_SIZE;
+        uint32_t got = want;
+
+        // [2B chunk_id LE][data]
+        s_packet[0] = s_chunkId & 0xFF;
+        s_packet[1] = (s_chunkId >> 8) & 0xFF;
+        if (s_source) got = s_source->read(s_packet + 2, want);
+        else memcpy(s_packet + 2, s_buffer + s_offset, want);
+
+        if (got != want) {
+            LOG_E(Log::BLE, "BinTransfer source ended at %u/%u", s_offset + got, s_totalSize);
+            release();
+            return false;
+        }
+        s_packetLen = 2 + got;
+    }
+    uint32_t dataSize = s_packetLen - 2;
 
-    bool ok = BLEBridge::sendBinary(packet, 2 + dataSize);
+    bool ok = BLEBridge::sendBinary(s_packet, s_packetLen);
     LOG_D(Log::BLE, "BinTransfer chunk[%u]: %u bytes, offset=%u/%u, sent=%d",
           s_chunkId, dataSize, s_offset, s_totalSize, ok ? 1 : 0);
 
@@ -64,6 +105,7 @@ bool sendNextChunk() {
 
     s_offset += dataSize;
     s_chunkId++;
+    s_packetLen = 0;
     return true;
 }
 
@@ -74,11 +116,7 @@ bool isInProgress() {
 void cancel() {
     if (s_active) {
         LOG_W(Log::BLE, "BinTransfer cancelled");
-        if (s_buffer) {
-            heap_caps_free(s_buffer);
-            s_buffer = nullptr;
-        }
-        s_active = false;
+        release();
     }
 }
 
@@ -3,11 +3,14 @@
 #include <cstdint>
 #include <cstddef>
 
+namespace Console { class PayloadSource; }
+
 /**
  * BinTransfer — generic binary chunk sender over BLE BIN_CHAR
  *
  * Usage:
  *   BinTransfer::start(buffer, size);  // takes ownership of buffer (PSRAM)
+ *   BinTransfer::startStream(source);  // or: reads each chunk from source
  *   // in loop():
  *   BinTransfer::sendNextChunk();      // sends one chunk per call
  *
@@ -19,6 +22,9 @@ namespace BinTransfer {
 /// Start transfer. Buffer must be heap_caps_malloc'd (will be freed on completion).
 void start(uint8_t* buffer, uint32_t size);
 
+/// Start streamed transfer. Takes ownership of source (deleted on completion).
+void startStream(Console::PayloadSource* source);
+
 /// Send next chunk. Returns true if more to send.
 bool sendNextChunk();
 
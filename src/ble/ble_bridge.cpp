@@ -4,6 +4,7 @@
 #include "console/console.h"
 #include "console/ble_transport.h"
 #include "utils/log_config.h"
+#include "utils/mem_tags.h"
 #include "esp_heap_caps.h"
 #include <queue>
 #include <map>
@@ -54,6 +55,7 @@ class ServerCallbacks : public NimBLEServerCallbacks {
 // RX characteristic callbacks
 class RxCallbacks : public NimBLECharacteristicCallbacks {
     void onWrite(NimBLECharacteristic* pChar, NimBLEConnInfo& connInfo) override {
+        MEM_SCOPE(Ble);
         P::String value(pChar->getValue().c_str());
         if (!value.empty()) {
             LOG_D(Log::BLE, "RX: %d bytes", (int)value.length());
@@ -181,6 +183,7 @@ int sendFetchRequest(const char* method, const char* url, const char* body,
                      bool authorize, const char* format, 
                      const P::Array<P::String>& fields,
                      ResponseCallback callback) {
+    MEM_SCOPE(Ble);
     int id = ++g_requestId;
     
     LOG_D(Log::BLE, "fetch[%d] %s %s (fields=%d)", id, method, url, (int)fields.size());
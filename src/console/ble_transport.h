@@ -55,7 +55,9 @@ public:
         BLEBridge::send(json);
         
         // Deliver payload via BinTransfer (both StringData and BinaryData)
-        if (result.type != Console::ResponseType::Short && result.payload && result.payloadSize > 0) {
+        if (result.source) {
+            BinTransfer::startStream(result.source);
+        } else if (result.type != Console::ResponseType::Short && result.payload && result.payloadSize > 0) {
             BinTransfer::start(result.payload, result.payloadSize);
         }
     }
@@ -5,23 +5,33 @@
  */
 
 #include "console/console.h"
+#include "console/serial_transport.h"
 #include "core/sys_paths.h"
 #include "ble/bin_receive.h"
 #ifndef NO_BLE
 #include "ble/ble_bridge.h"
 #endif
 #include "core/app_manager.h"
+#include "core/app_index.h"
 #include "core/state_store.h"
+#include "core/persist.h"
+#include "engines/lua/lua_csv.h"
 #include "ui/ui_engine.h"
 #include "ui/ui_touch.h"
 #include "utils/screenshot.h"
 #include "utils/log_config.h"
+#include "utils/mirror.h"
+#include "utils/trace.h"
+#include "utils/mem_tags.h"
 #include "hal/display_hal.h"
+#include "hal/render_stats.h"
 #include <lvgl.h>
 #include <LittleFS.h>
+#include <esp_rom_crc.h>
+#include <esp_heap_caps.h>
 
 // OS version constants
-static constexpr const char* PROTOCOL_VERSION = "2.7";
+static constexpr const char* PROTOCOL_VERSION = "2.13";
 static constexpr const char* OS_VERSION = "0.4.0";
 
 static const char* TAG = "Console";
@@ -292,9 +302,26 @@ static Result execSys(const char* cmd, JsonArray args) {
         return r;
     }
     
+    // sys serial [text|framed] — Serial output mode (applies to this reply)
+    if (strcmp(cmd, "serial") == 0) {
+        auto& serial = SerialTransport::instance();
+        if (args.size() > 0) {
+            const char* mode = argStr(args, 0);
+            if (strcmp(mode, "framed") == 0) serial.setFramed(true);
+            else if (strcmp(mode, "text") == 0) serial.setFramed(false);
+            else return Result::errInvalid("Usage: sys serial [text|framed]");
+        }
+        auto r = Result::ok();
+        r.data["mode"] = serial.isFramed() ? "framed" : "text";
+        r.data["chunk"] = (int)SerialFrame::CHUNK;
+        return r;
+    }
+    
     // sys reboot
     if (strcmp(cmd, "reboot") == 0) {
         LOG_W(Log::APP, "Reboot requested");
+        Persist::flush();
+        LuaCSV::flushAll();
         ESP.restart();
         return Result::ok("Rebooting...");
     }
@@ -314,7 +341,7 @@ static Result execSys(const char* cmd, JsonArray args) {
         r.data["w"] = cap.width;
         r.data["h"] = cap.height;
         r.data["color"] = cap.color;
-        r.data["format"] = "lz4";
+        r.data["format"] = cap.format;
         r.data["raw_size"] = cap.rawSize;
         r.withBinaryData(cap.buffer, cap.size);
         
@@ -647,6 +674,8 @@ static Result execApp(const char* cmd, JsonArray args) {
             }
         }
         LittleFS.rmdir(path.c_str());
+        AppIndex::invalidate(name);
+        AppIndex::save();
         
         LOG_I(Log::APP, "app delete %s", name);
         return Result::ok();
@@ -672,6 +701,139 @@ static Result execApp(const char* cmd, JsonArray args) {
     return Result::errInvalid("Unknown app command");
 }
 
+// === File Subsystem ===
+
+// Unsigned number: decimal or 0x-hex (crc32 does not fit argInt)
+static bool argU32(JsonArray args, int idx, uint32_t& out) {
+    if (idx >= (int)args.size()) return false;
+    if (args[idx].is<uint32_t>()) {
+        out = args[idx].as<uint32_t>();
+        return true;
+    }
+    const char* s = argStr(args, idx);
+    char* end = nullptr;
+    unsigned long v = strtoul(s, &end, 0);
+    if (!s[0] || *end) return false;
+    out = (uint32_t)v;
+    return true;
+}
+
+// Range [offset, offset+len) of an open file, read as the transport asks
+class FileSource : public PayloadSource {
+public:
+    FileSource(File f, uint32_t len) : m_file(f), m_left(len), m_size(len) {}
+    ~FileSource() override { m_file.close(); }
+    
+    uint32_t size() const override { return m_size; }
+    
+    size_t read(uint8_t* dst, size_t max) override {
+        size_t total = 0;
+        while (total < max && m_left > 0) {
+            size_t want = max - total < m_left ? max - total : m_left;
+            size_t n = m_file.read(dst + total, want);
+            if (n == 0) break;
+            total += n;
+            m_left -= n;
+        }
+        return total;
+    }
+    
+private:
+    File m_file;
+    uint32_t m_left;
+    uint32_t m_size;
+};
+
+// Open path and clamp [offset, offset+len) to the file; len 0 = to the end
+static Result openRange(JsonArray args, File& f, uint32_t& offset, uint32_t& len) {
+    const char* path = argStr(args, 0);
+    if (path[0] != '/') return Result::errInvalid("Path must start with /");
+    
+    f = LittleFS.open(path, "r");
+    if (!f || f.isDirectory()) return Result::errNotFound("File not found");
+    
+    uint32_t size = f.size();
+    offset = 0;
+    len = 0;
+    argU32(args, 1, offset);
+    argU32(args, 2, len);
+    if (offset > size) offset = size;
+    if (len == 0 || len > size - offset) len = size - offset;
+    if (offset && !f.seek(offset)) return Result::errServer("Seek failed");
+    
+    auto r = Result::ok();
+    r.data["path"] = path;
+    r.data["size"] = size;
+    r.data["offset"] = offset;
+    r.data["len"] = len;
+    return r;
+}
+
+static Result execFile(const char* cmd, JsonArray args) {
+    // file read <path> [offset] [len] — streamed, constant memory
+    if (strcmp(cmd, "read") == 0) {
+        File f;
+        uint32_t offset, len;
+        Result r = openRange(args, f, offset, len);
+        if (!r.success) return r;
+        
+        r.withStream(new FileSource(f, len));
+        LOG_I(Log::APP, "file read %s @%u +%u", argStr(args, 0), offset, len);
+        return r;
+    }
+    
+    // file crc <path> [offset] [len] — crc32 (zlib) of the range
+    if (strcmp(cmd, "crc") == 0) {
+        File f;
+        uint32_t offset, len;
+        Result r = openRange(args, f, offset, len);
+        if (!r.success) return r;
+        
+        static uint8_t window[1024];
+        uint32_t crc = 0;
+        uint32_t left = len;
+        while (left > 0) {
+            size_t n = f.read(window, left < sizeof(window) ? left : sizeof(window));
+            if (n == 0) break;
+            crc = esp_rom_crc32_le(crc, window, n);
+            left -= n;
+        }
+        f.close();
+        if (left) return Result::errServer("Read failed");
+        
+        char hex[11];
+        snprintf(hex, sizeof(hex), "0x%08x", (unsigned)crc);
+        r.data["crc32"] = hex;
+        return r;
+    }
+    
+    // file write <path> <offset> <size> [crc32] — one window; data follows
+    // on BIN (BLE) or as raw bytes after the command line (Serial)
+    if (strcmp(cmd, "write") == 0) {
+        const char* path = argStr(args, 0);
+        uint32_t offset, size, crc = 0;
+        if (path[0] != '/' || !argU32(args, 1, offset) || !argU32(args, 2, size)) {
+            return Result::errInvalid("Usage: file write <path> <offset> <size> [crc32]");
+        }
+        bool checkCrc = argU32(args, 3, crc);
+        if (size == 0 || size > BinReceive::FILE_WINDOW) {
+            return Result::errInvalid("Window size must be 1..32768");
+        }
+        if (!BinReceive::startFile(path, offset, size, crc, checkCrc)) {
+            return Result::errMemory("Cannot start receive");
+        }
+        
+        auto r = Result::ok();
+        r.data["path"] = path;
+        r.data["offset"] = offset;
+        r.data["size"] = size;
+        r.data["window"] = BinReceive::FILE_WINDOW;
+        return r;
+    }
+    
+    return Result::errInvalid("Unknown file command");
+}
+
 // === Log Subsystem ===
 
 static Result execLog(const char* cmd, JsonArray args) {
@@ -679,6 +841,30 @@ static Result execLog(const char* cmd, JsonArray args) {
     // log                  — show all levels
     // log verbose          — set all to verbose
     // log ui debug         — set UI to debug
+    // log deferred on|off  — binary ring instead of printf
+    // log dump             — raw ring records (tools/log_decode.py)
+    
+    if (strcmp(cmd, "deferred") == 0) {
+        const char* v = argStr(args, 0, "on");
+        bool on = strcmp(v, "off") != 0 && strcmp(v, "0") != 0;
+        if (!Log::setDeferred(on)) return Result::errMemory("No memory for log ring");
+        if (!on) Log::drain(Log::RING_SLOTS);
+        auto r = Result::ok();
+        r.data["deferred"] = on;
+        r.data["dropped"] = Log::dropped();
+        return r;
+    }
+    
+    if (strcmp(cmd, "dump") == 0) {
+        uint32_t size;
+        uint8_t* buf = Log::dump(size);
+        if (!buf) return Result::errInvalid("Deferred log was never enabled");
+        auto r = Result::ok();
+        r.data["format"] = "blog";
+        r.data["dropped"] = Log::dropped();
+        r.withBinaryData(buf, size);
+        return r;
+    }
     
     if (!cmd[0] || strcmp(cmd, "show") == 0) {
         // Show current levels
@@ -688,6 +874,7 @@ static Result execLog(const char* cmd, JsonArray args) {
         r.data["STATE"] = Log::levelName(Log::get(Log::STATE));
         r.data["APP"] = Log::levelName(Log::get(Log::APP));
         r.data["BLE"] = Log::levelName(Log::get(Log::BLE));
+        r.data["deferred"] = Log::deferred();
         return r;
     }
     
@@ -740,6 +927,162 @@ static Result execLog(const char* cmd, JsonArray args) {
     return r;
 }
 
+// === Mirror Subsystem ===
+
+static Result execMirror(const char* cmd, JsonArray args) {
+    // mirror start [fps]  — stream screen deltas as 'M' frames (Serial framed)
+    // mirror stop
+    // mirror [status]
+    if (strcmp(cmd, "start") == 0) {
+        SerialTransport::instance().setFramed(true);
+        if (!Mirror::start(argInt(args, 0, 10))) return Result::errMemory("No memory for mirror shadow");
+    } else if (strcmp(cmd, "stop") == 0) {
+        Mirror::stop();
+    } else if (cmd[0] && strcmp(cmd, "status") != 0) {
+        return Result::errInvalid("Usage: mirror start [fps] | stop | status");
+    }
+
+    const auto& st = Mirror::stats();
+    auto r = Result::ok();
+    r.data["active"] = Mirror::active();
+    r.data["w"] = SCREEN_WIDTH;
+    r.data["h"] = SCREEN_HEIGHT;
+    r.data["fps"] = Mirror::fps();
+    r.data["frames"] = st.frames;
+    r.data["strips"] = st.strips;
+    r.data["raw"] = st.rawBytes;
+    r.data["sent"] = st.sentBytes;
+    r.data["waits"] = st.waits;
+    r.data["merges"] = st.merges;
+    return r;
+}
+
+// === Perf Subsystem ===
+
+static void putHistogram(JsonObject o, const RenderStats::Histogram& h) {
+    o["n"] = h.count;
+    o["avg"] = h.count ? (uint32_t)(h.sum / h.count) : 0;
+    o["max"] = h.max;
+    o["p50"] = h.percentile(50);
+    o["p95"] = h.percentile(95);
+    o["base"] = h.base;
+    JsonArray buckets = o["hist"].to<JsonArray>();
+    for (uint32_t b : h.buckets) buckets.add(b);
+}
+
+static Result execPerf(const char* cmd, JsonArray args) {
+    // perf [show]  — render statistics since on/reset
+    // perf on|off  — register/unregister the display event hook
+    // perf reset
+    if (strcmp(cmd, "on") == 0) RenderStats::enable(true);
+    else if (strcmp(cmd, "off") == 0) RenderStats::enable(false);
+    else if (strcmp(cmd, "reset") == 0) RenderStats::reset();
+    else if (cmd[0] && strcmp(cmd, "show") != 0) return Result::errInvalid("Usage: perf [show|on|off|reset]");
+
+    auto rep = RenderStats::report();
+    auto r = Result::ok();
+    r.data["enabled"] = rep.enabled;
+    if (!rep.enabled) return r;
+    r.data["ms"] = rep.ms;
+    r.data["frames"] = rep.frames;
+    r.data["fps"] = rep.ms ? (float)rep.frames * 1000.0f / rep.ms : 0.0f;
+    r.data["flushes"] = rep.flushes;
+    putHistogram(r.data["frame_us"].to<JsonObject>(), *rep.frameUs);
+    putHistogram(r.data["flush_us"].to<JsonObject>(), *rep.flushUs);
+    putHistogram(r.data["pixels"].to<JsonObject>(), *rep.pixels);
+    putHistogram(r.data["handler_us"].to<JsonObject>(), *rep.handlerUs);
+    return r;
+}
+
+// === Trace Subsystem ===
+
+static Result execTrace(const char* cmd, JsonArray args) {
+    // trace [status]
+    // trace on|off  — record spans (off keeps them for dump)
+    // trace clear
+    // trace dump    — Chrome Trace Event JSON (Perfetto)
+    if (strcmp(cmd, "dump") == 0) {
+        Console::PayloadSource* src = Trace::dumpJson();
+        if (!src) return Result::errInvalid("Tracing was never enabled");
+        auto r = Result::ok();
+        r.data["format"] = "chrome-trace";
+        r.data["recorded"] = Trace::recorded();
+        r.withStream(src);
+        return r;
+    }
+    
+    if (strcmp(cmd, "on") == 0) {
+        if (!Trace::setEnabled(true)) return Result::errMemory("No memory for trace ring");
+    } else if (strcmp(cmd, "off") == 0) {
+        Trace::setEnabled(false);
+    } else if (strcmp(cmd, "clear") == 0) {
+        Trace::clear();
+    } else if (cmd[0] && strcmp(cmd, "status") != 0) {
+        return Result::errInvalid("Usage: trace [status|on|off|clear|dump]");
+    }
+    
+    auto r = Result::ok();
+    r.data["on"] = Trace::enabled();
+    r.data["compiled"] = (bool)TRACE_ENABLED;
+    r.data["recorded"] = Trace::recorded();
+    r.data["capacity"] = Trace::RING_EVENTS;
+    return r;
+}
+
+// === Mem Subsystem ===
+
+static void putDelta(JsonObject o, const MemTags::Snapshot& d) {
+    for (int i = 0; i < MemTags::COUNT; i++) {
+        if (!d.bytes[i] && !d.blocks[i]) continue;
+        JsonObject t = o[MemTags::name((MemTags::Tag)i)].to<JsonObject>();
+        t["bytes"] = d.bytes[i];
+        t["blocks"] = d.blocks[i];
+    }
+}
+
+static Result execMem(const char* cmd, JsonArray args) {
+    // mem [show]  — bytes/peak/blocks/allocs per tag
+    // mem reset   — peak = current, allocs = 0
+    // mem mark    — remember current usage
+    // mem diff    — change since mark (non-zero tags)
+    // mem leaks   — last launcher -> app -> launcher comparison
+    auto r = Result::ok();
+    if (strcmp(cmd, "diff") == 0) {
+        if (!MemTags::marked()) return Result::errInvalid("No mark (mem mark)");
+        putDelta(r.data["diff"].to<JsonObject>(), MemTags::sinceMark());
+        return r;
+    }
+    if (strcmp(cmd, "leaks") == 0) {
+        const auto& c = MemTags::lastCycle();
+        r.data["cycles"] = c.count;
+        r.data["app"] = c.app;
+        putDelta(r.data["diff"].to<JsonObject>(), c.delta);
+        return r;
+    }
+    
+    if (strcmp(cmd, "reset") == 0) {
+        MemTags::resetPeaks();
+    } else if (strcmp(cmd, "mark") == 0) {
+        MemTags::mark();
+    } else if (cmd[0] && strcmp(cmd, "show") != 0) {
+        return Result::errInvalid("Usage: mem [show|reset|mark|diff|leaks]");
+    }
+    
+    r.data["compiled"] = (bool)MEM_TAGS;
+    JsonObject tags = r.data["tags"].to<JsonObject>();
+    for (int i = 0; i < MemTags::COUNT; i++) {
+        const auto& c = MemTags::g_counters[i];
+        JsonObject t = tags[MemTags::name((MemTags::Tag)i)].to<JsonObject>();
+        t["bytes"] = c.bytes.load(std::memory_order_relaxed);
+        t["peak"] = c.peak.load(std::memory_order_relaxed);
+        t["blocks"] = c.blocks.load(std::memory_order_relaxed);
+        t["allocs"] = c.allocs.load(std::memory_order_relaxed);
+    }
+    r.data["dram_free"] = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    r.data["psram_free"] = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    return r;
+}
+
 // === Main Entry Points ===
 
 Result exec(const char* subsystem, const char* cmd, JsonArray args) {
@@ -747,6 +1090,11 @@ Result exec(const char* subsystem, const char* cmd, JsonArray args) {
     if (strcmp(subsystem, "sys") == 0) return execSys(cmd, args);
     if (strcmp(subsystem, "app") == 0) return execApp(cmd, args);
     if (strcmp(subsystem, "log") == 0) return execLog(cmd, args);
+    if (strcmp(subsystem, "file") == 0) return execFile(cmd, args);
+    if (strcmp(subsystem, "mirror") == 0) return execMirror(cmd, args);
+    if (strcmp(subsystem, "perf") == 0) return execPerf(cmd, args);
+    if (strcmp(subsystem, "trace") == 0) return execTrace(cmd, args);
+    if (strcmp(subsystem, "mem") == 0) return execMem(cmd, args);
     
     return Result::errInvalid("Unknown subsystem");
 }
@@ -32,6 +32,19 @@ enum class ResponseType {
     BinaryData   // Raw bytes — BLE: BinTransfer chunks, Serial: base64
 };
 
+/**
+ * Streamed payload — transport pulls it in fixed windows instead of
+ * holding the whole thing in memory (file read). Owned and deleted by
+ * the transport once attached to a Result.
+ */
+class PayloadSource {
+public:
+    virtual ~PayloadSource() = default;
+    virtual uint32_t size() const = 0;
+    /// Fills up to max bytes (fewer only at the end), 0 at end or on error
+    virtual size_t read(uint8_t* dst, size_t max) = 0;
+};
+
 /**
  * Command execution result
  */
@@ -50,6 +63,9 @@ struct Result {
     uint8_t* payload = nullptr;
     uint32_t payloadSize = 0;
     
+    // Streamed payload (instead of payload buffer)
+    PayloadSource* source = nullptr;
+    
     // Constructors
     static Result ok(const char* msg = "ok") {
         Result r;
@@ -110,6 +126,14 @@ struct Result {
         return *this;
     }
     
+    // Attach streamed binary output (BLE: BinTransfer reads per chunk, Serial: per window)
+    Result& withStream(PayloadSource* src) {
+        type = ResponseType::BinaryData;
+        source = src;
+        payloadSize = src->size();
+        return *this;
+    }
+    
     // Backward compat alias
     Result& withBinary(uint8_t* buf, uint32_t size) {
         return withBinaryData(buf, size);
@@ -119,7 +143,7 @@ struct Result {
 /**
  * Execute command
  * 
- * @param subsystem  "ui", "sys", "app", "log"
+ * @param subsystem  "ui", "sys", "app", "log", "file"
  * @param cmd        command name
  * @param args       JSON array of arguments
  * @return Result with status and optional binary
@@ -0,0 +1,93 @@
+#include "console/serial_frame.h"
+#include "console/console.h"
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+
+namespace SerialFrame {
+
+// Streaming COBS: one block (code + up to 254 non-zero bytes) at a time
+class CobsWriter {
+public:
+    void put(const uint8_t* p, size_t len) {
+        while (len--) {
+            uint8_t b = *p++;
+            if (b == 0) {
+                flushBlock();
+                continue;
+            }
+            m_block[m_n++] = b;
+            if (m_n == 0xFF) flushBlock();
+        }
+    }
+
+    void finish() {
+        flushBlock();
+        Serial.write((uint8_t)0);
+    }
+
+private:
+    uint8_t m_block[256];
+    size_t m_n = 1;             // m_block[0] = code
+
+    void flushBlock() {
+        m_block[0] = (uint8_t)m_n;
+        Serial.write(m_block, m_n);
+        m_n = 1;
+    }
+};
+
+void send(Type type, uint16_t id, uint16_t seq, const uint8_t* data, size_t len) {
+    if (len > 0xFFFF) len = 0xFFFF;
+
+    uint8_t head[7] = {
+        type,
+        (uint8_t)id, (uint8_t)(id >> 8),
+        (uint8_t)seq, (uint8_t)(seq >> 8),
+        (uint8_t)len, (uint8_t)(len >> 8),
+    };
+    uint32_t crc = esp_rom_crc32_le(0, head, sizeof(head));
+    if (len) crc = esp_rom_crc32_le(crc, data, len);
+    uint8_t tail[4] = { (uint8_t)crc, (uint8_t)(crc >> 8), (uint8_t)(crc >> 16), (uint8_t)(crc >> 24) };
+
+    Serial.write((uint8_t)0);
+    CobsWriter w;
+    w.put(head, sizeof(head));
+    if (len) w.put(data, len);
+    w.put(tail, sizeof(tail));
+    w.finish();
+}
+
+static void sendEnd(uint16_t id, uint16_t seq, uint32_t len, uint32_t crc) {
+    uint8_t end[8] = {
+        (uint8_t)len, (uint8_t)(len >> 8), (uint8_t)(len >> 16), (uint8_t)(len >> 24),
+        (uint8_t)crc, (uint8_t)(crc >> 8), (uint8_t)(crc >> 16), (uint8_t)(crc >> 24),
+    };
+    send(End, id, seq, end, sizeof(end));
+}
+
+void sendPayload(Type type, uint16_t id, const uint8_t* data, size_t len) {
+    uint32_t crc = 0;
+    uint16_t seq = 0;
+    for (size_t off = 0; off < len; off += CHUNK, seq++) {
+        size_t n = len - off < CHUNK ? len - off : CHUNK;
+        send(type, id, seq, data + off, n);
+        crc = esp_rom_crc32_le(crc, data + off, n);
+    }
+    sendEnd(id, seq, len, crc);
+}
+
+void sendStream(Type type, uint16_t id, Console::PayloadSource& source) {
+    static uint8_t window[CHUNK];
+    uint32_t crc = 0;
+    uint32_t total = 0;
+    uint16_t seq = 0;
+    size_t n;
+    while ((n = source.read(window, CHUNK)) > 0) {
+        send(type, id, seq++, window, n);
+        crc = esp_rom_crc32_le(crc, window, n);
+        total += n;
+    }
+    sendEnd(id, seq, total, crc);
+}
+
+} // namespace SerialFrame
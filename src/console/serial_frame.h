@@ -0,0 +1,42 @@
+/**
+ * SerialFrame - COBS-framed binary output for SerialTransport
+ *
+ * Frame on the wire:  0x00  COBS(body)  0x00
+ * body:  [type u8][id u16][seq u16][len u16][data: len][crc32 u32]
+ *        all LE, crc32 (zlib) over type..data
+ *
+ * Leading 0x00 closes any text (log lines) written between frames, so the
+ * host simply splits on 0x00 and treats segments that fail COBS/CRC as text.
+ *
+ * Encoding streams through a 256-byte block buffer: payloads are sent
+ * straight from the source buffer, no full-size copy.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Console { class PayloadSource; }
+
+namespace SerialFrame {
+
+enum Type : uint8_t {
+    Json   = 'J',   // v2 response: [id, "ok"|"error", {...}]
+    Binary = 'B',   // BinaryData chunk
+    Text   = 'T',   // StringData chunk
+    End    = 'E',   // data: u32 total bytes, u32 crc32 of the whole payload
+    Mirror = 'M',   // screen strip, see utils/mirror.h
+};
+
+static constexpr size_t CHUNK = 1024;
+
+/// One frame (len <= 65535)
+void send(Type type, uint16_t id, uint16_t seq, const uint8_t* data, size_t len);
+
+/// Payload as CHUNK-sized frames + End frame
+void sendPayload(Type type, uint16_t id, const uint8_t* data, size_t len);
+
+/// Same, pulling CHUNK bytes at a time from source (End carries bytes actually sent)
+void sendStream(Type type, uint16_t id, Console::PayloadSource& source);
+
+} // namespace SerialFrame
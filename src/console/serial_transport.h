@@ -1,13 +1,21 @@
 /**
  * SerialTransport - Serial/USB implementation of Console::Transport
  * 
- * Text output + base64 binary.
+ * Text mode (default): text output + base64 binary.
+ * Framed mode ("sys serial framed"): v2 JSON + raw payload in COBS frames
+ * with CRC, streamed from the payload buffer — see serial_frame.h.
+ *
+ * Payload buffers are owned by the transport and freed after sending
+ * (as BinTransfer does on BLE).
  */
 #pragma once
 
 #include "console/transport.h"
+#include "console/serial_frame.h"
+#include "utils/psram_json.h"
 #include <Arduino.h>
 #include <base64.h>
+#include <esp_heap_caps.h>
 
 namespace Console {
 
@@ -18,7 +26,47 @@ public:
         return inst;
     }
     
+    void setFramed(bool on) { m_framed = on; }
+    bool isFramed() const { return m_framed; }
+    
     void sendResult(int requestId, const Result& result) override {
+        if (m_framed) {
+            sendFramed(requestId, result);
+        } else {
+            sendTextResult(requestId, result);
+        }
+        if (result.payload) heap_caps_free(result.payload);
+        delete result.source;
+    }
+    
+    void sendText(const char* text) override {
+        if (m_framed) {
+            // Same shape as BleTransport: {"text": ...}
+            auto resp = PsramJsonDoc();
+            resp["text"] = text;
+            P::String json;
+            serializeJson(resp, json);
+            SerialFrame::send(SerialFrame::Json, 0, 0, (const uint8_t*)json.data(), json.size());
+            return;
+        }
+        Serial.println(text);
+    }
+    
+    bool supportsBinary() const override { return true; }
+    
+    bool isConnected() const override { return true; }
+    
+    const char* name() const override { return "Serial"; }
+    
+private:
+    SerialTransport() = default;
+    
+    bool m_framed = false;
+    
+    // Base64 in 3-byte aligned pieces: same single line, no full-size String
+    static constexpr size_t B64_PIECE = 768;
+    
+    void sendTextResult(int requestId, const Result& result) {
         // Format: [id] status: message
         Serial.printf("[%d] %s", requestId, result.success ? "OK" : "ERROR");
         
@@ -38,13 +86,27 @@ public:
             Serial.println();
         }
         
+        if (result.source) {
+            Serial.printf("  [binary: %u bytes]\n", result.payloadSize);
+            Serial.print("  base64: ");
+            uint8_t piece[B64_PIECE];
+            size_t n;
+            while ((n = result.source->read(piece, sizeof(piece))) > 0) {
+                Serial.print(base64::encode(piece, n));
+            }
+            Serial.println();
+        }
+        
         // Deliver payload based on type
         if (result.payload && result.payloadSize > 0) {
             if (result.type == Console::ResponseType::BinaryData) {
                 Serial.printf("  [binary: %u bytes]\n", result.payloadSize);
                 Serial.print("  base64: ");
-                String b64 = base64::encode(result.payload, result.payloadSize);
-                Serial.println(b64);
+                for (uint32_t off = 0; off < result.payloadSize; off += B64_PIECE) {
+                    size_t n = result.payloadSize - off < B64_PIECE ? result.payloadSize - off : B64_PIECE;
+                    Serial.print(base64::encode(result.payload + off, n));
+                }
+                Serial.println();
             }
             else if (result.type == Console::ResponseType::StringData) {
                 Serial.printf("  [string: %u bytes]\n", result.payloadSize);
@@ -54,18 +116,45 @@ public:
         }
     }
     
-    void sendText(const char* text) override {
-        Serial.println(text);
+    void sendFramed(int requestId, const Result& result) {
+        // v2 JSON, as on BLE: [id, "ok"|"error", data|{code,message,http}]
+        auto resp = PsramJsonDoc();
+        JsonArray out = resp.to<JsonArray>();
+        out.add(requestId);
+        out.add(result.success ? "ok" : "error");
+        
+        bool hasPayload = result.type != Console::ResponseType::Short && result.payloadSize > 0 &&
+                          (result.payload || result.source);
+        if (result.success) {
+            JsonObject dataObj = out.add<JsonObject>();
+            for (auto kv : result.data.as<JsonObjectConst>()) {
+                dataObj[kv.key()] = kv.value();
+            }
+            if (hasPayload) {
+                dataObj["bytes"] = result.payloadSize;
+                dataObj["type"] = (result.type == Console::ResponseType::BinaryData) ? "binary" : "string";
+            }
+        } else {
+            JsonObject errObj = out.add<JsonObject>();
+            errObj["code"] = result.errorCode.c_str();
+            errObj["message"] = result.errorMessage.c_str();
+            if (result.httpCode > 0) {
+                errObj["http"] = result.httpCode;
+            }
+        }
+        
+        P::String json;
+        serializeJson(resp, json);
+        uint16_t id = (uint16_t)requestId;
+        SerialFrame::send(SerialFrame::Json, id, 0, (const uint8_t*)json.data(), json.size());
+        
+        if (hasPayload) {
+            SerialFrame::Type t = (result.type == Console::ResponseType::BinaryData)
+                ? SerialFrame::Binary : SerialFrame::Text;
+            if (result.source) SerialFrame::sendStream(t, id, *result.source);
+            else SerialFrame::sendPayload(t, id, result.payload, result.payloadSize);
+        }
     }
-    
-    bool supportsBinary() const override { return true; }
-    
-    bool isConnected() const override { return true; }
-    
-    const char* name() const override { return "Serial"; }
-    
-private:
-    SerialTransport() = default;
 };
 
 } // namespace Console
@@ -0,0 +1,148 @@
+#include "core/app_index.h"
+#include "core/sys_paths.h"
+#include "utils/log_config.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <algorithm>
+
+namespace AppIndex {
+
+static const char* TAG = "AppIndex";
+static const char* INDEX_PATH = SYS_APPS ".index";
+static const char* HEADER = "#appindex 1\n";
+static constexpr int FIELDS = 9;
+
+static P::Map<P::String, Entry> s_entries;
+static bool s_loaded = false;
+static bool s_dirty = false;
+
+// Attribute values never hold tabs/newlines in practice — make sure
+static void appendField(P::String& out, const P::String& v) {
+    for (char c : v) out += (c == '\t' || c == '\n' || c == '\r') ? ' ' : c;
+}
+
+static void appendNum(P::String& out, uint32_t v) {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%u", (unsigned)v);
+    out += buf;
+}
+
+// One complete line (without '\n') -> entry
+static bool parseLine(const char* p, const char* end, Entry& e) {
+    P::String f[FIELDS];
+    int n = 0;
+    const char* start = p;
+    for (; p <= end; p++) {
+        if (p == end || *p == '\t') {
+            if (n == FIELDS) return false;
+            f[n++] = P::String(start, p - start);
+            start = p + 1;
+        }
+    }
+    if (n != FIELDS || f[0].empty()) return false;
+
+    e.name = f[0];
+    e.size = strtoul(f[1].c_str(), nullptr, 10);
+    e.mtime = strtoul(f[2].c_str(), nullptr, 10);
+    e.iconSize = strtoul(f[3].c_str(), nullptr, 10);
+    e.iconMtime = strtoul(f[4].c_str(), nullptr, 10);
+    e.title = f[5];
+    e.category = f[6];
+    e.icon = f[7];
+    e.version = f[8];
+    return true;
+}
+
+void load() {
+    if (s_loaded) return;
+    s_loaded = true;
+    s_entries.clear();
+    s_dirty = false;
+
+    File f = LittleFS.open(INDEX_PATH, FILE_READ);
+    if (!f) {
+        LOG_I(Log::APP, "No index, full scan");
+        s_dirty = true;
+        return;
+    }
+    size_t size = f.size();
+    P::String buf(size, '\0');
+    f.read((uint8_t*)&buf[0], size);
+    f.close();
+
+    size_t hlen = strlen(HEADER);
+    if (buf.compare(0, hlen, HEADER) != 0) {
+        LOG_W(Log::APP, "Index version mismatch, rebuilding");
+        s_dirty = true;
+        return;
+    }
+
+    // A line without '\n' is a torn write — ignored, rebuilt on scan
+    const char* p = buf.c_str() + hlen;
+    const char* end = buf.c_str() + buf.size();
+    while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        if (!nl) break;
+        Entry e;
+        if (parseLine(p, nl, e)) s_entries[e.name] = e;
+        else s_dirty = true;
+        p = nl + 1;
+    }
+    LOG_D(Log::APP, "Index: %d entries", (int)s_entries.size());
+}
+
+const Entry* find(const P::String& name) {
+    auto it = s_entries.find(name);
+    return it != s_entries.end() ? &it->second : nullptr;
+}
+
+void put(const Entry& entry) {
+    s_entries[entry.name] = entry;
+    s_dirty = true;
+}
+
+void invalidate(const char* name) {
+    load();
+    if (s_entries.erase(P::String(name))) s_dirty = true;
+}
+
+void retain(const P::Array<P::String>& names) {
+    for (auto it = s_entries.begin(); it != s_entries.end();) {
+        if (!std::binary_search(names.begin(), names.end(), it->first)) {
+            it = s_entries.erase(it);
+            s_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void save() {
+    if (!s_dirty) return;
+
+    P::String out = HEADER;
+    for (const auto& kv : s_entries) {
+        const Entry& e = kv.second;
+        appendField(out, e.name);     out += '\t';
+        appendNum(out, e.size);       out += '\t';
+        appendNum(out, e.mtime);      out += '\t';
+        appendNum(out, e.iconSize);   out += '\t';
+        appendNum(out, e.iconMtime);  out += '\t';
+        appendField(out, e.title);    out += '\t';
+        appendField(out, e.category); out += '\t';
+        appendField(out, e.icon);     out += '\t';
+        appendField(out, e.version);  out += '\n';
+    }
+
+    File f = LittleFS.open(INDEX_PATH, FILE_WRITE);
+    if (!f) {
+        LOG_E(Log::APP, "Cannot write %s", INDEX_PATH);
+        return;
+    }
+    f.write((const uint8_t*)out.data(), out.size());
+    f.close();
+    s_dirty = false;
+    LOG_D(Log::APP, "Index saved: %d entries, %d bytes", (int)s_entries.size(), (int)out.size());
+}
+
+} // namespace AppIndex
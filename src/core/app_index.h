@@ -0,0 +1,51 @@
+#pragma once
+
+#include "utils/psram_alloc.h"
+
+/**
+ * AppIndex — manifest /apps/.index caching per-app metadata between boots.
+ *
+ * One text line per HTML app (tab separated):
+ *   name  baxSize  baxMtime  pngSize  pngMtime  title  category  icon  version
+ *
+ * scanApps lists /apps once and stat()s <name>.bax (and icon.png when the
+ * app has no icon attribute); an entry is reused while size/mtime match,
+ * otherwise only that app is re-read. BinReceive and `app delete` drop
+ * entries explicitly, so a same-size rewrite within one second (mtime
+ * granularity, no RTC) is never missed for files pushed by the host.
+ *
+ * The index is a cache: unreadable or foreign-version files mean a rebuild.
+ */
+namespace AppIndex {
+
+struct Entry {
+    P::String name;
+    P::String title;
+    P::String category;
+    P::String icon;             // from icon="" attribute (LVGL path), empty = none
+    P::String version;
+    uint32_t size = 0;          // <name>.bax
+    uint32_t mtime = 0;
+    uint32_t iconSize = 0;      // icon.png, 0 = absent (only when icon is empty)
+    uint32_t iconMtime = 0;
+};
+
+/// Read /apps/.index once (later calls are no-ops)
+void load();
+
+/// Cached entry or nullptr
+const Entry* find(const P::String& name);
+
+/// Insert or replace
+void put(const Entry& entry);
+
+/// Drop entry: app changed (BinReceive) or deleted
+void invalidate(const char* name);
+
+/// Drop entries whose app dir is gone. names must be sorted.
+void retain(const P::Array<P::String>& names);
+
+/// Write the file if anything changed since load/save
+void save();
+
+} // namespace AppIndex
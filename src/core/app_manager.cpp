@@ -15,7 +15,14 @@
 #include "engines/lua/lua_engine.h"
 #include "engines/lua/lua_system.h"
 #include "engines/bf/bf_engine.h"
+#include "core/persist.h"
+#include "engines/lua/lua_csv.h"
+#include "core/app_index.h"
+#include "utils/file_utils.h"
+#include "utils/icon_cache.h"
 #include "utils/log_config.h"
+#include "utils/trace.h"
+#include "utils/mem_tags.h"
 #include "_generated_icons.h"
 #include "esp_heap_caps.h"
 #include <Arduino.h>
@@ -24,17 +31,28 @@
 #include <sys/stat.h>
 #include <cstring>
 
-// lodepng is compiled into LVGL — declare extern to use directly
-extern "C" {
-    unsigned lodepng_decode32(unsigned char** out, unsigned* w, unsigned* h,
-                              const unsigned char* in, size_t insize);
-}
 #include <algorithm>
 #include <cctype>
 #include <functional>
 
 static const char* TAG = "AppMgr";
 
+// Hot app cache: suspend only with headroom (LVGL small objects live in DRAM)
+static constexpr uint32_t HOT_MIN_DRAM = 40 * 1024;
+static constexpr uint32_t HOT_MIN_PSRAM = 512 * 1024;
+static constexpr uint32_t HOT_EVICT_DRAM = 24 * 1024;
+
+// Tap-to-first-frame measurement: armed by loadApp, reported on next refresh
+static uint32_t s_tapAt = 0;
+static bool s_tapPreloaded = false;
+
+static void onRefrReady(lv_event_t* e) {
+    if (!s_tapAt) return;
+    LOG_I(Log::APP, "Tap to first frame: %u ms (%s)", (unsigned)(millis() - s_tapAt),
+          s_tapPreloaded ? "preloaded" : "cold");
+    s_tapAt = 0;
+}
+
 // ============================================
 // State Machine
 // ============================================
@@ -83,16 +101,12 @@ static void cleanupScreen() {
 
 // ============================================
 // Extract metadata from app file (first 512 bytes)
-// Returns: title, icon, version from <app title="..." icon="..." version="...">
+// Returns: title, icon, category, version from
+// <app title="..." icon="..." category="..." version="...">
 // ============================================
-struct AppMeta {
-    P::String title;
-    P::String icon;
-    P::String version;
-};
-
-static AppMeta extractMeta(const P::String& filepath, const P::String& defaultName) {
-    AppMeta meta;
+static AppIndex::Entry extractMeta(const P::String& filepath, const P::String& defaultName) {
+    AppIndex::Entry meta;
+    meta.name = defaultName;
     meta.title = defaultName;
     if (!meta.title.empty()) {
         meta.title[0] = toupper(meta.title[0]);
@@ -147,41 +161,12 @@ static AppMeta extractMeta(const P::String& filepath, const P::String& defaultNa
         }
     }
     
-    // Extract version
+    meta.category = getAttr("category");
     meta.version = getAttr("version");
     
     return meta;
 }
 
-// ============================================
-// Extract category from app file
-// ============================================
-static P::String extractCategory(const P::String& filepath) {
-    File f = LittleFS.open(filepath.c_str(), "r");
-    if (!f) return "";
-    
-    char buf[256];
-    size_t len = f.readBytes(buf, sizeof(buf) - 1);
-    f.close();
-    buf[len] = '\0';
-    
-    const char* appTag = strstr(buf, "<app");
-    if (appTag) {
-        const char* tagEnd = strchr(appTag, '>');
-        if (tagEnd) {
-            const char* catAttr = strstr(appTag + 4, "category=\"");
-            if (catAttr && catAttr < tagEnd) {
-                catAttr += 10;
-                const char* end = strchr(catAttr, '"');
-                if (end && end <= tagEnd) {
-                    return P::String(catAttr, end - catAttr);
-                }
-            }
-        }
-    }
-    return "";
-}
-
 static lv_obj_t* s_confirmOverlay = nullptr;
 
 static void hideCloseConfirm() {
@@ -294,11 +279,10 @@ void Manager::init() {
     }
 
     Shade::applyConfig();
+    
+    lv_display_add_event_cb(lv_display_get_default(), onRefrReady, LV_EVENT_REFR_READY, nullptr);
 
     scanApps();
-#if defined(PRELOAD_ICONS_TO_PSRAM) && !defined(NO_PNG_ICONS)
-    preloadIcons();
-#endif
     printAppList();
     showLauncher();
     
@@ -318,14 +302,31 @@ void Manager::mountLittleFS() {
     LOG_I(Log::APP, "LittleFS: %d/%d bytes", (int)used, (int)total);
 }
 
+static void freeIcon(AppInfo& app) {
+    if (app.iconData) {
+        lv_image_cache_drop(&app.iconDsc);
+        free(app.iconData);
+    }
+    app.iconData = nullptr;
+    app.iconDsc = {};
+    app.hasIcon = false;
+    app.iconTried = false;
+}
+
 void Manager::scanApps() {
+    for (auto& app : m_apps) freeIcon(app);
     m_apps.clear();
     
-    // Scan .bax apps from filesystem
+    // Scan .bax apps from filesystem: one dir listing + stat() per app,
+    // file contents are read only for apps missing from /apps/.index
     File appsDir = LittleFS.open(SYS_APPS);
     if (!appsDir || !appsDir.isDirectory()) {
         LOG_W(Log::APP, SYS_APPS " not found");
     } else {
+        AppIndex::load();
+        P::Array<P::String> seen;
+        int rebuilt = 0;
+        
         File entry;
         while ((entry = appsDir.openNextFile())) {
             if (!entry.isDirectory()) continue;
@@ -337,49 +338,57 @@ void Manager::scanApps() {
             
             char pathBuf[64];
             snprintf(pathBuf, sizeof(pathBuf), SYS_APPS "%s/%s.bax", name.c_str(), name.c_str());
-            if (!LittleFS.exists(pathBuf)) continue;
+            uint32_t size, mtime;
+            if (!fs_stat(pathBuf, size, mtime)) continue;
+            seen.push_back(name);
+            
+            // icon.png only matters without icon="" — stat it lazily
+            char pngBuf[64];
+            snprintf(pngBuf, sizeof(pngBuf), SYS_APPS "%s/icon.png", name.c_str());
+            auto statIcon = [&](AppIndex::Entry& e) {
+                if (!fs_stat(pngBuf, e.iconSize, e.iconMtime)) e.iconSize = e.iconMtime = 0;
+            };
+            
+            const AppIndex::Entry* cached = AppIndex::find(name);
+            if (!cached || cached->size != size || cached->mtime != mtime) {
+                AppIndex::Entry e = extractMeta(pathBuf, name);
+                e.size = size;
+                e.mtime = mtime;
+                if (e.icon.empty()) statIcon(e);
+                AppIndex::put(e);
+                cached = AppIndex::find(name);
+                rebuilt++;
+            } else if (cached->icon.empty()) {
+                AppIndex::Entry e = *cached;
+                statIcon(e);
+                if (e.iconSize != cached->iconSize || e.iconMtime != cached->iconMtime) {
+                    AppIndex::put(e);
+                    cached = AppIndex::find(name);
+                }
+            }
             
             AppInfo app;
             app.name = name;
-            
-            AppMeta meta = extractMeta(pathBuf, name);
-            app.title = meta.title;
-            app.category = extractCategory(pathBuf);
+            app.title = cached->title;
+            app.category = cached->category;
+            app.version = cached->version;
             app.source = AppInfo::HTML;
             
-            if (!meta.icon.empty()) {
-                app.iconPath = meta.icon;
-            } else {
-                // Check for icon.png by listing app dir (silent, no VFS open() errors)
-                bool hasIcon = false;
-                char dirBuf[64];
-                snprintf(dirBuf, sizeof(dirBuf), SYS_APPS "%s", name.c_str());
-                File appDir = LittleFS.open(dirBuf);
-                if (appDir && appDir.isDirectory()) {
-                    File f;
-                    while ((f = appDir.openNextFile())) {
-                        P::String fname = f.name();
-                        // f.name() may return full path or just filename
-                        auto slash = fname.rfind('/');
-                        if (slash != P::String::npos) fname = fname.substr(slash + 1);
-                        if (fname == "icon.png") {
-                            hasIcon = true;
-                            f.close();
-                            break;
-                        }
-                        f.close();
-                    }
-                }
-                if (hasIcon) {
-                    snprintf(pathBuf, sizeof(pathBuf), SYS_LVGL_PREFIX SYS_APPS "%s/icon.png", name.c_str());
-                    app.iconPath = pathBuf;
-                }
-                // else iconPath stays empty → launcher uses category/builtin fallback
+            if (!cached->icon.empty()) {
+                app.iconPath = cached->icon;
+            } else if (cached->iconSize) {
+                app.iconPath = P::String(SYS_LVGL_PREFIX) + pngBuf;
             }
+            // else iconPath stays empty → launcher uses category/builtin fallback
             
             m_apps.push_back(app);
             LOG_D(Log::APP, "Found: %s (%s)", app.name.c_str(), app.title.c_str());
         }
+        
+        std::sort(seen.begin(), seen.end());
+        AppIndex::retain(seen);
+        AppIndex::save();
+        LOG_I(Log::APP, "Index: %d apps, %d re-read", (int)seen.size(), rebuilt);
     }
     
     // Add native apps from registry
@@ -477,120 +486,26 @@ void Manager::printAppList() {
     log_printf("================================\n");
 }
 
-void Manager::preloadIcons() {
-    LOG_I(Log::APP, "Preloading icons to PSRAM...");
-    
-    int loaded = 0;
-    int skipped = 0;
-    int embedded = 0;
-    size_t totalBytes = 0;
-    
-    for (auto& app : m_apps) {
-        // Use iconPath from app metadata (may be system: resolved or custom path)
+// Launcher asks only for icons of built pages: the builtin (flash) icon
+// checks run before this, so fresh embedded icons are never decoded.
+const lv_image_dsc_t* Manager::iconFor(size_t idx) {
+    if (idx >= m_apps.size()) return nullptr;
+    AppInfo& app = m_apps[idx];
+    if (!app.hasIcon && !app.iconTried && !app.iconPath.empty()) {
+        app.iconTried = true;
         // Convert LVGL path (C:/...) to LittleFS path (/...)
         P::String fsPath = app.iconPath;
         if (fsPath.size() > 2 && fsPath[0] == 'C' && fsPath[1] == ':') {
             fsPath = fsPath.substr(2);
         }
-        
-        // --- Hybrid: skip if embedded icon is still fresh ---
-#ifdef USE_BUILTIN_ICONS
-        {
-            // Check app icon by name
-            const BuiltinIcon* entry = findBuiltinEntry(app.name.c_str());
-            
-            // Check system icon if app icon not found
-            if (!entry && !app.iconPath.empty()) {
-                const char* sysPrefix = SYS_LVGL_PREFIX SYS_ICONS;
-                if (strncmp(app.iconPath.c_str(), sysPrefix, strlen(sysPrefix)) == 0) {
-                    const char* nameStart = app.iconPath.c_str() + strlen(sysPrefix);
-                    P::String iconName(nameStart);
-                    size_t dotPos = iconName.rfind('.');
-                    if (dotPos != P::String::npos) iconName = iconName.substr(0, dotPos);
-                    entry = findSystemEntry(iconName.c_str());
-                }
-            }
-            
-            if (entry) {
-                // Compare FS file size with build-time png_size
-                bool stale = false;
-                if (!fsPath.empty() && LittleFS.exists(fsPath.c_str())) {
-                    File f = LittleFS.open(fsPath.c_str(), "r");
-                    if (f) {
-                        stale = ((uint32_t)f.size() != entry->png_size);
-                        f.close();
-                    }
-                }
-                if (!stale) {
-                    // Embedded is up-to-date — skip PSRAM decode
-                    embedded++;
-                    continue;
-                }
-                LOG_I(Log::APP, "Icon changed on FS: %s (decode from disk)", app.name.c_str());
-            }
-        }
-#endif
-        
-        if (!LittleFS.exists(fsPath.c_str())) { skipped++; continue; }
-        
-        File f = LittleFS.open(fsPath.c_str(), "r");
-        if (!f) continue;
-        
-        size_t fileSize = f.size();
-        uint8_t* pngData = (uint8_t*)ps_malloc(fileSize);
-        if (!pngData) {
-            f.close();
-            continue;
-        }
-        
-        f.read(pngData, fileSize);
-        f.close();
-        
-        unsigned char* pixels = nullptr;
-        unsigned w, h;
-        unsigned error = lodepng_decode32(&pixels, &w, &h, pngData, fileSize);
-        free(pngData);
-        
-        if (error || !pixels) {
-            continue;
-        }
-        
-        size_t pixelCount = w * h;
-        size_t dataSize = pixelCount * 2;
-        uint8_t* rgb565 = (uint8_t*)ps_malloc(dataSize);
-        
-        if (!rgb565) {
-            free(pixels);
-            continue;
-        }
-        
-        uint16_t* dst = (uint16_t*)rgb565;
-        uint8_t* src = pixels;
-        for (size_t i = 0; i < pixelCount; i++) {
-            uint8_t r = src[0];
-            uint8_t g = src[1];
-            uint8_t b = src[2];
-            src += 4;
-            
-            uint16_t c = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
-            dst[i] = c;
-        }
-        free(pixels);
-        
-        app.iconData = rgb565;
-        app.iconDsc.header.w = w;
-        app.iconDsc.header.h = h;
-        app.iconDsc.header.cf = LV_COLOR_FORMAT_RGB565;
-        app.iconDsc.data = rgb565;
-        app.iconDsc.data_size = dataSize;
-        app.hasIcon = true;
-        
-        loaded++;
-        totalBytes += dataSize;
+        // Decoded once into <icon>.bin, later loads only inflate LZ4
+        app.hasIcon = IconCache::load(fsPath.c_str(), app.iconDsc, app.iconData);
     }
-    
-    LOG_I(Log::APP, "Icons: %d loaded (%d KB PSRAM), %d embedded (flash), %d skipped", 
-           loaded, (int)(totalBytes / 1024), embedded, skipped);
+    return app.hasIcon ? &app.iconDsc : nullptr;
+}
+
+void Manager::releaseIcon(size_t idx) {
+    if (idx < m_apps.size()) freeIcon(m_apps[idx]);
 }
 
 
@@ -598,6 +513,8 @@ void Manager::showLauncher() {
     LOG_I(Log::APP, "State: %s -> TRANSITIONING -> LAUNCHER", stateToStr(s_appState));
     s_appState = AppState::TRANSITIONING;
     
+    P::String leaving = m_currentApp;
+    P::String leavingTitle = m_currentAppTitle;
     m_currentApp.clear();
     m_currentAppTitle.clear();
     m_inLauncher = true;
@@ -607,6 +524,10 @@ void Manager::showLauncher() {
         m_currentNative = nullptr;
     }
     
+    if (!leaving.empty() && hotAllowed()) {
+        suspendApp(leaving, leavingTitle);
+    }
+    
     if (m_scriptMgr) {
         m_scriptMgr->shutdown();
         m_scriptMgr.reset();
@@ -617,10 +538,16 @@ void Manager::showLauncher() {
     
     display_lock();
     
-    WidgetCallbacks::cleanup();
-    cleanupScreen();
-    ui_engine().clear();
-    lv_image_cache_drop(NULL);
+    if (m_hot.screen) {
+        // Launcher is on its own screen, suspended app UI stays untouched
+        cleanupScreen();
+        lv_obj_clean(lv_screen_active());
+    } else {
+        WidgetCallbacks::cleanup();
+        cleanupScreen();
+        ui_engine().clear();
+        lv_image_cache_drop(NULL);
+    }
     
     LOG_I(Log::APP, "Heap before launcher: %d bytes", (int)ESP.getFreeHeap());
     
@@ -639,15 +566,27 @@ void Manager::showLauncher() {
         info.title = app.title;
         info.category = app.category;
         info.iconPath = app.iconPath;
-        info.iconDsc = app.hasIcon ? &app.iconDsc : nullptr;
-        info.hasIcon = app.hasIcon;
         launcherApps.push_back(info);
     }
     
     m_launcher.show(launcherApps);
     
+    if (m_hot.screen && heap_caps_get_free_size(MALLOC_CAP_INTERNAL) < HOT_EVICT_DRAM) {
+        evictHot();
+    }
+    
     display_unlock();
     
+    // Leak check: nothing of the app may be left once it is gone for good
+    // (its name strings included, the boot baseline has none)
+    if (!m_hot.screen) {
+        char left[48];
+        snprintf(left, sizeof(left), "%s", leaving.empty() ? leavingTitle.c_str() : leaving.c_str());
+        P::String().swap(leaving);
+        P::String().swap(leavingTitle);
+        MemTags::launcherCheckpoint(left);
+    }
+    
     m_inLauncher = true;
     s_appState = AppState::LAUNCHER;
     LOG_I(Log::APP, "State: LAUNCHER | %d apps", (int)m_apps.size());
@@ -655,10 +594,13 @@ void Manager::showLauncher() {
 
 void Manager::refreshApps() {
     LOG_I(Log::APP, "Refreshing app list...");
+    // App files may have changed — never resume a stale copy
+    if (m_hot.screen) {
+        display_lock();
+        evictHot();
+        display_unlock();
+    }
     scanApps();
-#if defined(PRELOAD_ICONS_TO_PSRAM) && !defined(NO_PNG_ICONS)
-    preloadIcons();
-#endif
     if (m_inLauncher) {
         showLauncher();
     }
@@ -680,12 +622,21 @@ bool Manager::launch(const P::String& name) {
 
 bool Manager::launchNative(NativeApp* app) {
     if (!app) return false;
+    TRACE_SCOPE("app.native");
     
     LOG_I(Log::APP, "Launching native: %s", app->name());
     s_appState = AppState::TRANSITIONING;
     
     display_lock();
     
+    // Suspended app is torn down below like a running one
+    if (m_hot.screen) wakeHot();
+    if (m_scriptMgr) {
+        m_scriptMgr->shutdown();
+        m_scriptMgr.reset();
+    }
+    m_scriptEngine.reset();
+    
     m_launcher.cleanup();
     WidgetCallbacks::cleanup();
     cleanupScreen();
@@ -707,9 +658,21 @@ bool Manager::launchNative(NativeApp* app) {
 }
 
 bool Manager::loadApp(const P::String& path) {
+    TRACE_SCOPE("app.load");
+    if (m_hot.screen) {
+        if (m_hot.path == path) return resumeHot();
+        // Different app: tear the suspended one down below like a running one
+        display_lock();
+        wakeHot();
+        display_unlock();
+    }
+    
     LOG_I(Log::APP, "Loading: %s", path.c_str());
     s_appState = AppState::TRANSITIONING;
     
+    bool preloaded = m_preload.path == path;
+    if (!preloaded) cancelPreload();
+    
     m_launcher.cleanup();
     
     if (m_scriptMgr) {
@@ -729,25 +692,36 @@ bool Manager::loadApp(const P::String& path) {
     
     display_unlock();
     
-    File f = LittleFS.open(path.c_str(), "r");
-    if (!f) {
-        LOG_E(Log::APP, "Failed to open: %s", path.c_str());
-        s_appState = AppState::LAUNCHER;
-        return false;
+    P::String html;
+    if (preloaded) {
+        html = std::move(m_preload.html);
+    } else {
+        File f = LittleFS.open(path.c_str(), "r");
+        if (!f) {
+            LOG_E(Log::APP, "Failed to open: %s", path.c_str());
+            s_appState = AppState::LAUNCHER;
+            return false;
+        }
+        
+        size_t size = f.size();
+        html.assign(size, '\0');
+        f.readBytes(&html[0], size);
+        f.close();
     }
     
-    size_t size = f.size();
-    P::String html(size, '\0');
-    f.readBytes(&html[0], size);
-    f.close();
-    
     display_lock();
     
     P::String appDir(path.data(), path.rfind('/'));
     ui_engine().setAppPath(appDir.c_str());
     
-    int count = ui_engine().render(html.c_str());
-    LOG_D(Log::APP, "Rendered %d elements", count);
+    int count = preloaded ? ui_engine().render(html.c_str(), m_preload.doc)
+                          : ui_engine().render(html.c_str());
+    LOG_D(Log::APP, "Rendered %d elements%s", count, preloaded ? " (preloaded)" : "");
+    m_preload = Preload();
+    
+    s_tapAt = m_launchRequestedAt;
+    s_tapPreloaded = preloaded;
+    m_launchRequestedAt = 0;
     
     static int16_t s_appTouchStartX = -1;
     static int16_t s_appTouchStartY = -1;
@@ -908,6 +882,156 @@ bool Manager::loadApp(const P::String& path) {
     return true;
 }
 
+// ============================================
+// Speculative preload
+// ============================================
+
+void Manager::queueLaunch(const P::String& name) {
+    m_pendingLaunch = name;
+    m_pendingPreload.clear();
+    m_launchRequestedAt = millis();
+}
+
+void Manager::cancelPreload() {
+    m_pendingPreload.clear();
+    if (m_preload.path.empty()) return;
+    m_preload = Preload();
+    LuaEngine::setPrecompiled(nullptr, P::String());
+}
+
+// Runs between touch-down and release: read, parse, compile
+void Manager::preloadApp(const P::String& name) {
+    const AppInfo* info = nullptr;
+    for (const auto& app : m_apps) {
+        if (app.name == name) info = &app;
+    }
+    if (!info || info->source != AppInfo::HTML) return;
+    
+    P::String path = info->path();
+    if (path == m_preload.path || path == m_hot.path) return;
+    cancelPreload();
+    
+    uint32_t t0 = millis();
+    File f = LittleFS.open(path.c_str(), "r");
+    if (!f) return;
+    size_t size = f.size();
+    m_preload.html.assign(size, '\0');
+    f.readBytes(&m_preload.html[0], size);
+    f.close();
+    
+    {
+        MEM_SCOPE(Ui);
+        m_preload.doc = UI::Parser::parse(m_preload.html.c_str());
+    }
+    m_preload.path = path;
+    
+    // Script source exactly as parse_script() will hand it to the engine
+    const UI::ParsedElement* app = m_preload.doc.find("app");
+    const UI::ParsedElement* script = (app ? app : &m_preload.doc)->find("script");
+    bool compiled = false;
+    if (script) {
+        P::String lang(script->get("language", "lua"));
+        for (char& c : lang) c = tolower((unsigned char)c);
+        size_t start = script->text.find_first_not_of(" \t\n\r");
+        if (lang == "lua" && start != P::String::npos) {
+            const char* src = script->text.c_str() + start;
+            P::String bytecode = LuaEngine::compile(src);
+            compiled = !bytecode.empty();
+            LuaEngine::setPrecompiled(src, std::move(bytecode));
+        }
+    }
+    
+    LOG_D(Log::APP, "Preloaded %s: %d bytes%s in %u ms", name.c_str(), (int)size,
+          compiled ? " + bytecode" : "", (unsigned)(millis() - t0));
+}
+
+// ============================================
+// Hot app cache
+// ============================================
+
+bool Manager::hotAllowed() const {
+    return heap_caps_get_free_size(MALLOC_CAP_INTERNAL) >= HOT_MIN_DRAM &&
+           heap_caps_get_free_size(MALLOC_CAP_SPIRAM) >= HOT_MIN_PSRAM;
+}
+
+// App screen stays alive off-screen, launcher gets a fresh one
+void Manager::suspendApp(const P::String& path, const P::String& title) {
+    if (m_scriptMgr) m_scriptMgr->suspend();
+    Persist::flush();
+    LuaCSV::flushAll();
+    
+    m_hot.path = path;
+    m_hot.title = title;
+    m_hot.engine = std::move(m_scriptEngine);
+    m_hot.scriptMgr = std::move(m_scriptMgr);
+    
+    display_lock();
+    m_hot.screen = lv_screen_active();
+    lv_screen_load(lv_obj_create(NULL));
+    display_unlock();
+    
+    LOG_I(Log::APP, "Suspended: %s", path.c_str());
+}
+
+// Suspended app becomes the current one again (display locked by caller).
+// Scripts stay paused: resumeHot() restarts them, teardown just shuts them down.
+void Manager::wakeHot() {
+    m_launcher.cleanup();
+    lv_obj_t* launcherScr = lv_screen_active();
+    lv_screen_load(m_hot.screen);
+    if (launcherScr != m_hot.screen) lv_obj_delete(launcherScr);
+    
+    m_scriptEngine = std::move(m_hot.engine);
+    m_scriptMgr = std::move(m_hot.scriptMgr);
+    m_currentApp = m_hot.path;
+    m_currentAppTitle = m_hot.title;
+    m_hot.screen = nullptr;
+    m_hot.path.clear();
+    m_hot.title.clear();
+}
+
+bool Manager::resumeHot() {
+    uint32_t t0 = millis();
+    s_appState = AppState::TRANSITIONING;
+    
+    display_lock();
+    wakeHot();
+    display_unlock();
+    
+    if (m_scriptMgr) m_scriptMgr->resume();
+    
+    m_inLauncher = false;
+    s_appState = AppState::APP_RUNNING;
+    LOG_I(Log::APP, "State: APP_RUNNING | Resumed %s in %u ms", m_currentApp.c_str(), (unsigned)(millis() - t0));
+    return true;
+}
+
+// Drop the suspended app while the launcher is shown (display locked by caller)
+void Manager::evictHot() {
+    LOG_I(Log::APP, "Evicting suspended: %s (DRAM free %u)", m_hot.path.c_str(),
+          (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+    
+    if (m_hot.scriptMgr) {
+        m_hot.scriptMgr->shutdown();
+        m_hot.scriptMgr.reset();
+    }
+    m_hot.engine.reset();
+    
+    // ui_engine().clear() works on the active screen
+    lv_obj_t* launcherScr = lv_screen_active();
+    lv_screen_load(m_hot.screen);
+    WidgetCallbacks::cleanup();
+    cleanupScreen();
+    ui_engine().clear();
+    lv_screen_load(launcherScr);
+    lv_obj_delete(m_hot.screen);
+    lv_image_cache_drop(NULL);
+    
+    m_hot.screen = nullptr;
+    m_hot.path.clear();
+    m_hot.title.clear();
+}
+
 void Manager::returnToLauncher() {
     LOG_I(Log::APP, "returnToLauncher() called from state: %s", stateToStr(s_appState));
     m_pendingReturnToLauncher = true;
@@ -952,6 +1076,13 @@ void Manager::processPendingLaunch() {
         P::String name = m_pendingLaunch;
         m_pendingLaunch.clear();
         launch(name);
+        return;
+    }
+    
+    if (!m_pendingPreload.empty()) {
+        P::String name = m_pendingPreload;
+        m_pendingPreload.clear();
+        preloadApp(name);
     }
 }
 
@@ -9,6 +9,7 @@
 #include "core/sys_paths.h"
 #include "ui/ui_html.h"
 #include "ui/ui_launcher.h"
+#include "ui/html_parser.h"
 #include "core/script_engine.h"
 #include "core/script_manager.h"
 #include "core/native_app.h"
@@ -23,14 +24,16 @@ struct AppInfo {
     P::String name;
     P::String title;
     P::String category;       // "game", "tool", etc. for icon fallback
+    P::String version;        // <app version="...">
     P::String iconPath;       // LVGL path, e.g. SYS_LVGL_PREFIX SYS_APPS "myapp/icon.png"
     enum Source { HTML, Native } source = HTML;
     NativeApp* nativePtr = nullptr;
     
-    // Pre-decoded icon in PSRAM (zero DRAM allocations at render time)
+    // Decoded icon in PSRAM, loaded on demand by iconFor() (zero DRAM allocations at render time)
     lv_image_dsc_t iconDsc = {};   // LVGL image descriptor
     uint8_t* iconData = nullptr;   // Raw pixel buffer in PSRAM
     bool hasIcon = false;
+    bool iconTried = false;        // load attempted (don't retry a broken PNG)
     
     P::String path() const {
         char buf[64];
@@ -48,13 +51,19 @@ public:
     
     void init();
     bool launch(const P::String& name);
-    void queueLaunch(const P::String& name) { m_pendingLaunch = name; }
+    void queueLaunch(const P::String& name);
+    void queuePreload(const P::String& name) { m_pendingPreload = name; }
+    void cancelPreload();
     void returnToLauncher();
     void refreshApps();  // rescan + reload icons + re-render launcher if visible
     void processPendingLaunch();
     bool inLauncher() const { return m_inLauncher; }
     const std::vector<AppInfo>& apps() const { return m_apps; }
     
+    /// Launcher icons by app index: decoded on first use, freed with the page
+    const lv_image_dsc_t* iconFor(size_t idx);
+    void releaseIcon(size_t idx);
+    
     YamlConfig systemConfig{"/system/config.yml", "SysConfig"};
 
 private:
@@ -62,12 +71,20 @@ private:
     
     void mountLittleFS();
     void scanApps();
-    void preloadIcons();
     void printAppList();
     void showLauncher();
     bool loadApp(const P::String& path);
     bool launchNative(NativeApp* app);
     
+    void preloadApp(const P::String& name);
+    
+    // Hot app cache
+    bool hotAllowed() const;
+    void suspendApp(const P::String& path, const P::String& title);
+    bool resumeHot();
+    void wakeHot();
+    void evictHot();
+    
     std::vector<AppInfo> m_apps;
     std::unique_ptr<IScriptEngine> m_scriptEngine;
     std::unique_ptr<ScriptManager> m_scriptMgr;
@@ -79,6 +96,29 @@ private:
     P::String m_currentApp;
     P::String m_currentAppTitle;
     NativeApp* m_currentNative = nullptr;
+    
+    // Last HTML app, suspended while the launcher is shown: its screen stays
+    // alive off-screen, scripts paused. One slot — UI engine state is global.
+    struct HotApp {
+        P::String path;
+        P::String title;
+        lv_obj_t* screen = nullptr;
+        std::unique_ptr<IScriptEngine> engine;
+        std::unique_ptr<ScriptManager> scriptMgr;
+    };
+    HotApp m_hot;
+    
+    // Speculative preload on launcher touch-down: file bytes and parsed
+    // document, handed to loadApp() if the tap completes (Lua bytecode is
+    // parked in LuaEngine::setPrecompiled)
+    struct Preload {
+        P::String path;
+        P::String html;
+        UI::ParsedElement doc;
+    };
+    Preload m_preload;
+    P::String m_pendingPreload;
+    uint32_t m_launchRequestedAt = 0;
 };
 
 } // namespace App
\ No newline at end of file
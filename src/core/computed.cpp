@@ -0,0 +1,545 @@
+#include "core/computed.h"
+#include "core/state_store.h"
+#include "utils/log_config.h"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace Computed {
+
+static const char* TAG = "Computed";
+static constexpr size_t MAX_STACK = 16;
+static constexpr size_t MAX_COMPUTED = 128;
+
+// ============ BYTECODE ============
+//
+// Expressions are pure (no side effects), so && || ?: evaluate both sides
+// and combine — no jumps, code is a flat postfix sequence.
+
+enum Op : uint8_t {
+    PUSH_NUM, PUSH_STR, LOAD,
+    NEG, NOT,
+    ADD, SUB, MUL, DIV, MOD,
+    EQ, NE, LT, LE, GT, GE,
+    AND, OR, SELECT,
+    MIN, MAX, ABS, ROUND, FLOOR
+};
+
+struct Instr {
+    uint8_t op;
+    uint16_t arg;
+};
+
+struct Value {
+    bool isStr = false;
+    double num = 0;
+    P::String str;
+};
+
+struct Node {
+    P::String name;
+    VarType type = VarType::Float;
+    bool inferType = false;
+    bool dirty = true;
+    bool valid = true;              // false: part of a cycle, never evaluated
+    P::Array<Instr> code;
+    P::Array<double> nums;
+    P::Array<P::String> strs;
+    P::Array<P::String> inputs;     // LOAD operands, deduplicated
+};
+
+static P::Array<Node> s_nodes;
+static P::Array<uint16_t> s_order;                          // topological
+static P::Map<P::String, P::Array<uint16_t>> s_dependents;  // input -> nodes
+static bool s_pending = false;
+static bool s_notifying = false;
+
+// ============ COMPILER ============
+//
+// ternary := or ('?' ternary ':' ternary)?
+// or      := and ('||' and)*
+// and     := cmp ('&&' cmp)*
+// cmp     := add (('=='|'!='|'<='|'>='|'<'|'>') add)*
+// add     := mul (('+'|'-') mul)*
+// mul     := unary (('*'|'/'|'%') unary)*
+// unary   := ('-'|'!') unary | primary
+// primary := number | 'str' | "str" | true | false | var | var[key]
+//          | fn(args) | '(' ternary ')'
+
+class Compiler {
+public:
+    Compiler(const char* src, Node& node) : m_src(src), m_p(src), m_node(node) {}
+
+    bool compile() {
+        if (!ternary()) return false;
+        skipWs();
+        if (*m_p) return fail("unexpected input");
+        return true;
+    }
+
+    const char* error() const { return m_err; }
+    int errorPos() const { return (int)(m_p - m_src); }
+
+private:
+    const char* m_src;
+    const char* m_p;
+    Node& m_node;
+    const char* m_err = nullptr;
+    int m_depth = 0;
+
+    bool fail(const char* msg) {
+        if (!m_err) m_err = msg;
+        return false;
+    }
+
+    void skipWs() {
+        while (*m_p && isspace((unsigned char)*m_p)) m_p++;
+    }
+
+    bool match(const char* tok) {
+        skipWs();
+        size_t n = strlen(tok);
+        if (strncmp(m_p, tok, n) != 0) return false;
+        m_p += n;
+        return true;
+    }
+
+    // Stack effect: +1 push, 0 unary, -1 binary, -2 select
+    bool emit(uint8_t op, uint16_t arg, int effect) {
+        m_node.code.push_back({op, arg});
+        m_depth += effect;
+        if (m_depth > (int)MAX_STACK) return fail("expression too deep");
+        return true;
+    }
+
+    bool ternary() {
+        if (!logicOr()) return false;
+        if (!match("?")) return true;
+        if (!ternary()) return false;
+        if (!match(":")) return fail("expected ':'");
+        if (!ternary()) return false;
+        return emit(SELECT, 0, -2);
+    }
+
+    bool logicOr() {
+        if (!logicAnd()) return false;
+        while (match("||")) {
+            if (!logicAnd() || !emit(OR, 0, -1)) return false;
+        }
+        return true;
+    }
+
+    bool logicAnd() {
+        if (!compare()) return false;
+        while (match("&&")) {
+            if (!compare() || !emit(AND, 0, -1)) return false;
+        }
+        return true;
+    }
+
+    bool compare() {
+        if (!additive()) return false;
+        for (;;) {
+            uint8_t op;
+            if (match("==")) op = EQ;
+            else if (match("!=")) op = NE;
+            else if (match("<=")) op = LE;
+            else if (match(">=")) op = GE;
+            else if (match("<")) op = LT;
+            else if (match(">")) op = GT;
+            else return true;
+            if (!additive() || !emit(op, 0, -1)) return false;
+        }
+    }
+
+    bool additive() {
+        if (!multiplicative()) return false;
+        for (;;) {
+            uint8_t op;
+            if (match("+")) op = ADD;
+            else if (match("-")) op = SUB;
+            else return true;
+            if (!multiplicative() || !emit(op, 0, -1)) return false;
+        }
+    }
+
+    bool multiplicative() {
+        if (!unary()) return false;
+        for (;;) {
+            uint8_t op;
+            if (match("*")) op = MUL;
+            else if (match("/")) op = DIV;
+            else if (match("%")) op = MOD;
+            else return true;
+            if (!unary() || !emit(op, 0, -1)) return false;
+        }
+    }
+
+    bool unary() {
+        if (match("-")) return unary() && emit(NEG, 0, 0);
+        if (match("!")) return unary() && emit(NOT, 0, 0);
+        return primary();
+    }
+
+    bool pushNum(double v) {
+        m_node.nums.push_back(v);
+        return emit(PUSH_NUM, m_node.nums.size() - 1, 1);
+    }
+
+    bool call(const P::String& fn) {
+        struct Fn { const char* name; uint8_t op; int argc; };
+        static const Fn fns[] = {
+            {"min", MIN, 2}, {"max", MAX, 2},
+            {"abs", ABS, 1}, {"round", ROUND, 1}, {"floor", FLOOR, 1},
+        };
+        for (const auto& f : fns) {
+            if (fn != f.name) continue;
+            for (int i = 0; i < f.argc; i++) {
+                if (i && !match(",")) return fail("expected ','");
+                if (!ternary()) return false;
+            }
+            if (!match(")")) return fail("expected ')'");
+            return emit(f.op, 0, 1 - f.argc);
+        }
+        return fail("unknown function");
+    }
+
+    bool primary() {
+        skipWs();
+        char c = *m_p;
+
+        if (isdigit((unsigned char)c) || (c == '.' && isdigit((unsigned char)m_p[1]))) {
+            char* end;
+            double v = strtod(m_p, &end);
+            m_p = end;
+            return pushNum(v);
+        }
+
+        if (c == '\'' || c == '"') {
+            const char* close = strchr(m_p + 1, c);
+            if (!close) return fail("unterminated string");
+            m_node.strs.push_back(P::String(m_p + 1, close - m_p - 1));
+            m_p = close + 1;
+            return emit(PUSH_STR, m_node.strs.size() - 1, 1);
+        }
+
+        if (isalpha((unsigned char)c) || c == '_') {
+            const char* start = m_p;
+            while (isalnum((unsigned char)*m_p) || *m_p == '_') m_p++;
+            P::String name(start, m_p - start);
+
+            if (name == "true") return pushNum(1);
+            if (name == "false") return pushNum(0);
+            if (match("(")) return call(name);
+
+            // Element path: cells[3], prices[apple]
+            if (*m_p == '[') {
+                const char* close = strchr(m_p, ']');
+                if (!close) return fail("expected ']'");
+                name.append(m_p, close - m_p + 1);
+                m_p = close + 1;
+            }
+
+            auto& inputs = m_node.inputs;
+            size_t idx = 0;
+            while (idx < inputs.size() && inputs[idx] != name) idx++;
+            if (idx == inputs.size()) inputs.push_back(name);
+            return emit(LOAD, idx, 1);
+        }
+
+        if (match("(")) {
+            if (!ternary()) return false;
+            if (!match(")")) return fail("expected ')'");
+            return true;
+        }
+
+        return fail(c ? "unexpected character" : "unexpected end");
+    }
+};
+
+// ============ VM ============
+
+static double toNum(const Value& v) {
+    return v.isStr ? atof(v.str.c_str()) : v.num;
+}
+
+static bool truthy(const Value& v) {
+    return v.isStr ? !v.str.empty() : v.num != 0;
+}
+
+static bool isIntegral(double v) {
+    return v == std::floor(v) && std::fabs(v) < 2147483648.0;
+}
+
+static P::String toStr(const Value& v) {
+    if (v.isStr) return v.str;
+    char buf[32];
+    if (isIntegral(v.num)) snprintf(buf, sizeof(buf), "%d", (int)v.num);
+    else snprintf(buf, sizeof(buf), "%g", v.num);
+    return buf;
+}
+
+static void load(const P::String& name, Value& out) {
+    const Store& store = State::store();
+    out.isStr = false;
+    switch (store.getType(name)) {
+        case VarType::Int:   out.num = store.getInt(name); break;
+        case VarType::Float: out.num = store.getFloat(name); break;
+        case VarType::Bool:  out.num = store.getBool(name) ? 1 : 0; break;
+        default:
+            out.isStr = true;
+            out.str = store.getAsString(name);
+            break;
+    }
+}
+
+static void setNum(Value& v, double n) {
+    v.isStr = false;
+    v.num = n;
+}
+
+static int compareValues(const Value& a, const Value& b) {
+    if (a.isStr && b.isStr) return strcmp(a.str.c_str(), b.str.c_str());
+    double x = toNum(a), y = toNum(b);
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static Value evaluate(const Node& n) {
+    Value st[MAX_STACK];
+    size_t sp = 0;
+
+    for (const auto& in : n.code) {
+        switch (in.op) {
+            case PUSH_NUM: setNum(st[sp++], n.nums[in.arg]); break;
+            case PUSH_STR: st[sp].isStr = true; st[sp++].str = n.strs[in.arg]; break;
+            case LOAD:     load(n.inputs[in.arg], st[sp++]); break;
+
+            case NEG:   setNum(st[sp - 1], -toNum(st[sp - 1])); break;
+            case NOT:   setNum(st[sp - 1], truthy(st[sp - 1]) ? 0 : 1); break;
+            case ABS:   setNum(st[sp - 1], std::fabs(toNum(st[sp - 1]))); break;
+            case ROUND: setNum(st[sp - 1], std::round(toNum(st[sp - 1]))); break;
+            case FLOOR: setNum(st[sp - 1], std::floor(toNum(st[sp - 1]))); break;
+
+            case SELECT: {
+                sp -= 2;
+                Value& c = st[sp - 1];
+                c = truthy(c) ? st[sp] : st[sp + 1];
+                break;
+            }
+
+            default: {
+                Value& a = st[sp - 2];
+                const Value& b = st[sp - 1];
+                sp--;
+                switch (in.op) {
+                    case ADD:
+                        if (a.isStr || b.isStr) {
+                            P::String s = toStr(a);
+                            s += toStr(b);
+                            a.isStr = true;
+                            a.str = s;
+                        } else {
+                            a.num += b.num;
+                        }
+                        break;
+                    case SUB: setNum(a, toNum(a) - toNum(b)); break;
+                    case MUL: setNum(a, toNum(a) * toNum(b)); break;
+                    case DIV: { double d = toNum(b); setNum(a, d != 0 ? toNum(a) / d : 0); break; }
+                    case MOD: { double d = toNum(b); setNum(a, d != 0 ? std::fmod(toNum(a), d) : 0); break; }
+                    case EQ:  setNum(a, compareValues(a, b) == 0); break;
+                    case NE:  setNum(a, compareValues(a, b) != 0); break;
+                    case LT:  setNum(a, compareValues(a, b) < 0); break;
+                    case LE:  setNum(a, compareValues(a, b) <= 0); break;
+                    case GT:  setNum(a, compareValues(a, b) > 0); break;
+                    case GE:  setNum(a, compareValues(a, b) >= 0); break;
+                    case AND: setNum(a, truthy(a) && truthy(b)); break;
+                    case OR:  setNum(a, truthy(a) || truthy(b)); break;
+                    case MIN: setNum(a, std::fmin(toNum(a), toNum(b))); break;
+                    case MAX: setNum(a, std::fmax(toNum(a), toNum(b))); break;
+                }
+                break;
+            }
+        }
+    }
+
+    return sp ? st[0] : Value();
+}
+
+static VarValue toVarValue(VarType type, const Value& v) {
+    switch (type) {
+        case VarType::Int:   return (int)toNum(v);
+        case VarType::Float: return (float)toNum(v);
+        case VarType::Bool:  return truthy(v);
+        default:             return toStr(v);
+    }
+}
+
+// Declared type wins; otherwise from the first result and operators used
+static VarType inferType(const Node& n, const Value& v) {
+    if (v.isStr) return VarType::String;
+    for (const auto& in : n.code) {
+        if (in.op == DIV) return VarType::Float;
+        if (in.op == LOAD && State::store().getType(n.inputs[in.arg]) == VarType::Float) {
+            return VarType::Float;
+        }
+    }
+    return isIntegral(v.num) ? VarType::Int : VarType::Float;
+}
+
+// ============ API ============
+
+bool define(const P::String& name, const char* expr, const char* type) {
+    if (!expr || !*expr) {
+        LOG_W(Log::STATE, "computed %s has no expr", name.c_str());
+        return false;
+    }
+    if (s_nodes.size() >= MAX_COMPUTED) {
+        LOG_W(Log::STATE, "limit %d reached, %s ignored", (int)MAX_COMPUTED, name.c_str());
+        return false;
+    }
+
+    Node node;
+    node.name = name;
+    node.inferType = !type || !*type;
+    if (!node.inferType) node.type = Store::stringToType(type);
+
+    Compiler c(expr, node);
+    if (!c.compile()) {
+        LOG_E(Log::STATE, "%s: %s at %d in \"%s\"", name.c_str(), c.error(), c.errorPos(), expr);
+        return false;
+    }
+
+    for (const auto& in : node.inputs) {
+        if (in == name) {
+            LOG_E(Log::STATE, "%s depends on itself", name.c_str());
+            return false;
+        }
+    }
+
+    LOG_D(Log::STATE, "%s = %s (%d ops, %d inputs)", name.c_str(), expr,
+          (int)node.code.size(), (int)node.inputs.size());
+    s_nodes.push_back(std::move(node));
+    return true;
+}
+
+void finalize() {
+    s_order.clear();
+    s_dependents.clear();
+    if (s_nodes.empty()) return;
+
+    // Edges computed -> computed, Kahn's algorithm
+    P::Map<P::String, uint16_t> byName;
+    for (size_t i = 0; i < s_nodes.size(); i++) byName[s_nodes[i].name] = i;
+
+    P::Array<uint16_t> indegree(s_nodes.size(), 0);
+    for (size_t i = 0; i < s_nodes.size(); i++) {
+        for (const auto& in : s_nodes[i].inputs) {
+            s_dependents[in].push_back(i);
+            if (byName.count(in)) indegree[i]++;
+            else if (!State::store().has(in)) {
+                LOG_W(Log::STATE, "%s: unknown input '%s'", s_nodes[i].name.c_str(), in.c_str());
+            }
+        }
+    }
+
+    P::Array<uint16_t> ready;
+    for (size_t i = 0; i < s_nodes.size(); i++) {
+        if (indegree[i] == 0) ready.push_back(i);
+    }
+    while (!ready.empty()) {
+        uint16_t i = ready.back();
+        ready.pop_back();
+        s_order.push_back(i);
+        auto dep = s_dependents.find(s_nodes[i].name);
+        if (dep == s_dependents.end()) continue;
+        for (uint16_t d : dep->second) {
+            if (--indegree[d] == 0) ready.push_back(d);
+        }
+    }
+
+    if (s_order.size() != s_nodes.size()) {
+        for (size_t i = 0; i < s_nodes.size(); i++) {
+            if (indegree[i] == 0) continue;
+            s_nodes[i].valid = false;
+            LOG_E(Log::STATE, "%s is part of a cycle, disabled", s_nodes[i].name.c_str());
+        }
+    }
+
+    // Initial values: define in State in dependency order
+    Store& store = State::store();
+    for (uint16_t i : s_order) {
+        Node& n = s_nodes[i];
+        Value v = evaluate(n);
+        if (n.inferType) n.type = inferType(n, v);
+        store.define(n.name, n.type, toVarValue(n.type, v));
+        n.dirty = false;
+    }
+    s_pending = false;
+
+    LOG_I(Log::STATE, "%d computed, %d inputs", (int)s_order.size(), (int)s_dependents.size());
+}
+
+bool markChanged(const char* varname) {
+    if (s_notifying || s_order.empty() || !varname) return false;
+
+    auto dep = s_dependents.find(varname);
+    if (dep == s_dependents.end()) return false;
+    for (uint16_t i : dep->second) s_nodes[i].dirty = true;
+
+    if (s_pending) return false;
+    s_pending = true;
+    return true;
+}
+
+void flush(const Notify& notify) {
+    s_pending = false;
+
+    Store& store = State::store();
+    P::Array<uint16_t> changed;
+
+    for (uint16_t i : s_order) {
+        Node& n = s_nodes[i];
+        if (!n.dirty) continue;
+        n.dirty = false;
+
+        VarValue v = toVarValue(n.type, evaluate(n));
+        const Variable* var = store.getVar(n.name);
+        if (var && var->value == v) continue;
+
+        store.set(n.name, v, false);
+        changed.push_back(i);
+
+        // Dependents come later in s_order — evaluated in this same pass
+        auto dep = s_dependents.find(n.name);
+        if (dep == s_dependents.end()) continue;
+        for (uint16_t d : dep->second) s_nodes[d].dirty = true;
+    }
+
+    if (!notify || changed.empty()) return;
+
+    s_notifying = true;
+    for (uint16_t i : changed) {
+        notify(s_nodes[i].name, store.getAsString(s_nodes[i].name));
+    }
+    s_notifying = false;
+}
+
+bool hasPending() {
+    return s_pending;
+}
+
+size_t count() {
+    return s_nodes.size();
+}
+
+void clear() {
+    s_nodes.clear();
+    s_order.clear();
+    s_dependents.clear();
+    s_pending = false;
+    s_notifying = false;
+}
+
+} // namespace Computed
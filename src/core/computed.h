@@ -0,0 +1,45 @@
+#pragma once
+
+#include <functional>
+#include "utils/psram_alloc.h"
+
+/**
+ * Computed — derived state variables evaluated in C++, without Lua.
+ *
+ *   <state>
+ *     <int name="a" default="1"/>
+ *     <int name="b" default="2"/>
+ *     <computed name="total" expr="a + b * 2"/>
+ *     <computed name="label" type="string" expr="total > 10 ? 'big' : 'small'"/>
+ *   </state>
+ *
+ * Each expr is compiled once to a small stack VM. Inputs form a dependency
+ * graph (computed may use other computed); a change marks only dependents
+ * dirty, and one flush re-evaluates them in topological order — a chain of
+ * N assignments in one Lua call costs one evaluation per computed.
+ *
+ * Result is stored in State like a regular variable (type from `type`
+ * attribute, or inferred from the first evaluation).
+ */
+namespace Computed {
+
+/// Called for each computed whose value changed during flush
+using Notify = std::function<void(const P::String& name, const P::String& value)>;
+
+/// Compile and register. type: "int" | "float" | "bool" | "string" | "" (infer)
+bool define(const P::String& name, const char* expr, const char* type);
+
+/// Build evaluation order (after all <computed> parsed) and evaluate all
+void finalize();
+
+/// State var changed. Returns true when a flush must be scheduled.
+bool markChanged(const char* varname);
+
+/// Re-evaluate dirty computed in topological order
+void flush(const Notify& notify);
+
+bool hasPending();
+size_t count();
+void clear();
+
+} // namespace Computed
@@ -0,0 +1,340 @@
+#include "core/persist.h"
+#include "core/state_store.h"
+#include "utils/log_config.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <algorithm>
+
+namespace Persist {
+
+static const char* TAG = "Persist";
+static constexpr uint32_t DEBOUNCE_MS = 1000;   // quiet period before append
+static constexpr uint32_t MAX_DELAY_MS = 5000;  // bound under constant changes
+static constexpr size_t COMPACT_MIN = 4096;     // journal size that allows compaction
+static constexpr size_t COMPACT_CHUNK = 512;    // bytes written per process() pass
+static constexpr uint8_t REC_MAGIC = 0xA5;
+static constexpr size_t REC_OVERHEAD = 5;       // magic + nameLen + valueLen + crc
+static const char* JOURNAL = "/.state";
+static const char* JOURNAL_TMP = "/.state.tmp";
+
+static P::Array<P::String> s_tracked;           // sorted base names
+static P::Map<P::String, P::String> s_live;     // path -> last written value
+static P::Array<P::String> s_dirty;             // paths changed since last append
+static P::String s_path;                        // empty = closed
+static uint32_t s_firstDirty = 0;
+static uint32_t s_lastDirty = 0;
+static size_t s_logSize = 0;
+static bool s_needCompact = false;              // journal must be rewritten before any append
+static bool s_compactRetry = false;             // last compaction failed at s_failedAt
+static uint32_t s_failedAt = 0;
+
+// Compaction in progress
+static P::String s_snapshot;
+static size_t s_snapshotPos = 0;
+static File s_tmp;
+static bool s_compacting = false;
+
+// ============ RECORDS ============
+
+static uint8_t crc8(const uint8_t* p, size_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+static void encode(P::String& out, const P::String& name, const P::String& value) {
+    size_t nlen = std::min<size_t>(name.size(), 0xFF);
+    size_t vlen = std::min<size_t>(value.size(), 0xFFFF);
+    size_t start = out.size();
+    out += (char)REC_MAGIC;
+    out += (char)nlen;
+    out += (char)(vlen & 0xFF);
+    out += (char)(vlen >> 8);
+    out.append(name.data(), nlen);
+    out.append(value.data(), vlen);
+    out += (char)crc8((const uint8_t*)out.data() + start + 1, out.size() - start - 1);
+}
+
+// Returns number of bytes holding valid records
+static size_t replay(const uint8_t* buf, size_t len, P::Map<P::String, P::String>& out) {
+    size_t pos = 0;
+    while (pos + REC_OVERHEAD <= len) {
+        if (buf[pos] != REC_MAGIC) break;
+        size_t nlen = buf[pos + 1];
+        size_t vlen = buf[pos + 2] | (buf[pos + 3] << 8);
+        size_t total = REC_OVERHEAD + nlen + vlen;
+        if (pos + total > len) break;
+        if (crc8(buf + pos + 1, total - 2) != buf[pos + total - 1]) break;
+        out[P::String((const char*)buf + pos + 4, nlen)] =
+            P::String((const char*)buf + pos + 4 + nlen, vlen);
+        pos += total;
+    }
+    return pos;
+}
+
+// ============ HELPERS ============
+
+static bool isTracked(const char* varname) {
+    P::String base, sub;
+    P::String name(varname);
+    if (Store::splitPath(name, base, sub)) name = base;
+    return std::binary_search(s_tracked.begin(), s_tracked.end(), name);
+}
+
+static P::String siblingPath(const char* file) {
+    P::String dir(s_path.data(), s_path.rfind('/'));
+    return dir + file;
+}
+
+static size_t liveBytes() {
+    size_t n = 0;
+    for (const auto& kv : s_live) n += REC_OVERHEAD + kv.first.size() + kv.second.size();
+    return n;
+}
+
+static void append() {
+    if (s_dirty.empty()) return;
+
+    // s_live entries replaced, to put back if the write fails
+    struct Prev { P::String path; P::String value; bool existed; };
+    P::Array<Prev> prev;
+
+    const Store& store = State::store();
+    P::String buf;
+    for (const auto& path : s_dirty) {
+        P::String value = store.getAsString(path);
+        auto it = s_live.find(path);
+        if (it != s_live.end() && it->second == value) continue;
+        encode(buf, path, value);
+        if (it != s_live.end()) {
+            prev.push_back({path, std::move(it->second), true});
+            it->second = std::move(value);
+        } else {
+            prev.push_back({path, P::String(), false});
+            s_live[path] = std::move(value);
+        }
+    }
+    s_dirty.clear();
+    if (buf.empty()) return;
+
+    File f = LittleFS.open(s_path.c_str(), FILE_APPEND);
+    size_t written = 0;
+    if (f) {
+        written = f.write((const uint8_t*)buf.data(), buf.size());
+        f.close();
+    }
+    if (written != buf.size()) {
+        // Not on disk: values go back to dirty, retried after DEBOUNCE_MS.
+        // Part of it on disk is a torn record nothing may follow.
+        LOG_E(Log::STATE, "Cannot append %s (%d/%d bytes)", s_path.c_str(), (int)written, (int)buf.size());
+        for (auto& p : prev) {
+            if (p.existed) s_live[p.path] = std::move(p.value);
+            else s_live.erase(p.path);
+            s_dirty.push_back(std::move(p.path));
+        }
+        if (written) s_needCompact = true;
+        s_firstDirty = s_lastDirty = millis();
+        return;
+    }
+    s_logSize += buf.size();
+    LOG_D(Log::STATE, "Appended %d bytes (journal %d)", (int)buf.size(), (int)s_logSize);
+}
+
+// ============ COMPACTION ============
+
+// The journal stays as it was. The snapshot already took the pending
+// values, so only a later rewrite (after MAX_DELAY_MS, or flush) may
+// write them: appends wait for it.
+static void compactFailed() {
+    if (s_tmp) s_tmp.close();
+    LittleFS.remove(siblingPath(JOURNAL_TMP).c_str());
+    s_snapshot.clear();
+    s_snapshot.shrink_to_fit();
+    s_compacting = false;
+    s_needCompact = true;
+    s_compactRetry = true;
+    s_failedAt = millis();
+}
+
+static void beginCompact() {
+    s_tmp = LittleFS.open(siblingPath(JOURNAL_TMP).c_str(), FILE_WRITE);
+    if (!s_tmp) {
+        LOG_E(Log::STATE, "Cannot create compaction file, retrying later");
+        // Nothing taken from s_dirty yet: a plain retry is enough
+        s_compactRetry = true;
+        s_failedAt = millis();
+        return;
+    }
+
+    // Snapshot of current values: pending changes are included
+    const Store& store = State::store();
+    for (const auto& path : s_dirty) s_live[path];
+    s_snapshot.clear();
+    for (auto& kv : s_live) {
+        kv.second = store.getAsString(kv.first);
+        encode(s_snapshot, kv.first, kv.second);
+    }
+    s_dirty.clear();
+    s_snapshotPos = 0;
+    s_compacting = true;
+}
+
+static void compactStep() {
+    size_t n = std::min(COMPACT_CHUNK, s_snapshot.size() - s_snapshotPos);
+    if (n) {
+        if (s_tmp.write((const uint8_t*)s_snapshot.data() + s_snapshotPos, n) != n) {
+            LOG_E(Log::STATE, "Short write to compaction file, journal kept");
+            compactFailed();
+            return;
+        }
+        s_snapshotPos += n;
+        return;
+    }
+
+    s_tmp.close();
+    P::String tmp = siblingPath(JOURNAL_TMP);
+    // Journal without tmp, or tmp alone, is always a consistent state (see open)
+    if (!LittleFS.rename(tmp.c_str(), s_path.c_str())) {
+        LittleFS.remove(s_path.c_str());
+        if (!LittleFS.rename(tmp.c_str(), s_path.c_str())) {
+            LOG_E(Log::STATE, "Compaction rename failed");
+        }
+    }
+    LOG_I(Log::STATE, "Compacted %d -> %d bytes", (int)s_logSize, (int)s_snapshot.size());
+    s_logSize = s_snapshot.size();
+    s_snapshot.clear();
+    s_snapshot.shrink_to_fit();
+    s_compacting = false;
+    s_needCompact = false;
+    s_compactRetry = false;
+}
+
+static bool compactDue(uint32_t now) {
+    return !s_compactRetry || now - s_failedAt >= MAX_DELAY_MS;
+}
+
+// ============ API ============
+
+void track(const P::String& name) {
+    auto it = std::lower_bound(s_tracked.begin(), s_tracked.end(), name);
+    if (it != s_tracked.end() && *it == name) return;
+    s_tracked.insert(it, name);
+}
+
+void open(const char* appPath) {
+    if (s_tracked.empty()) return;
+    if (!appPath || !*appPath) {
+        LOG_W(Log::STATE, "No app path, persist disabled");
+        return;
+    }
+
+    s_path = P::String(appPath) + JOURNAL;
+    s_live.clear();
+    s_dirty.clear();
+    s_logSize = 0;
+    s_needCompact = false;
+    s_compactRetry = false;
+
+    // Interrupted compaction: with the journal present tmp may be partial,
+    // without it tmp is complete (died between remove and rename)
+    P::String tmp = siblingPath(JOURNAL_TMP);
+    if (LittleFS.exists(tmp.c_str())) {
+        if (LittleFS.exists(s_path.c_str())) LittleFS.remove(tmp.c_str());
+        else LittleFS.rename(tmp.c_str(), s_path.c_str());
+    }
+
+    File f = LittleFS.open(s_path.c_str(), FILE_READ);
+    if (!f) return;
+
+    size_t size = f.size();
+    P::String buf(size, '\0');
+    f.read((uint8_t*)&buf[0], size);
+    f.close();
+
+    P::Map<P::String, P::String> values;
+    size_t valid = replay((const uint8_t*)buf.data(), size, values);
+    s_logSize = size;
+    if (valid < size) {
+        LOG_W(Log::STATE, "%s: %d bytes of torn tail dropped", s_path.c_str(), (int)(size - valid));
+        s_needCompact = true;
+    }
+
+    Store& store = State::store();
+    int restored = 0;
+    for (const auto& kv : values) {
+        if (!isTracked(kv.first.c_str())) {
+            s_needCompact = true;
+            continue;
+        }
+        store.setFromString(kv.first, kv.second, false);
+        s_live[kv.first] = kv.second;
+        restored++;
+    }
+    LOG_I(Log::STATE, "Restored %d values (%d bytes)", restored, (int)size);
+}
+
+void markChanged(const char* varname) {
+    if (s_path.empty() || !varname || !isTracked(varname)) return;
+
+    uint32_t now = millis();
+    if (s_dirty.empty()) s_firstDirty = now;
+    s_lastDirty = now;
+
+    for (const auto& p : s_dirty) {
+        if (p == varname) return;
+    }
+    s_dirty.push_back(P::String(varname));
+}
+
+void process() {
+    if (s_path.empty()) return;
+
+    if (s_compacting) {
+        compactStep();
+        return;
+    }
+
+    // Torn tail: records appended after it would be lost on replay. The
+    // rewrite goes first, its snapshot takes the pending values.
+    uint32_t now = millis();
+    if (s_needCompact) {
+        if (compactDue(now)) beginCompact();
+        return;
+    }
+
+    if (!s_dirty.empty()) {
+        if (now - s_lastDirty >= DEBOUNCE_MS || now - s_firstDirty >= MAX_DELAY_MS) append();
+        return;
+    }
+
+    if (s_logSize >= COMPACT_MIN && s_logSize > 2 * liveBytes() && compactDue(now)) {
+        beginCompact();
+    }
+}
+
+void flush() {
+    if (s_path.empty()) return;
+    if (s_needCompact && !s_compacting) beginCompact();
+    while (s_compacting) compactStep();
+    if (s_needCompact) {
+        LOG_E(Log::STATE, "%s not rewritten, changes not saved", s_path.c_str());
+        return;
+    }
+    append();
+}
+
+void close() {
+    flush();
+    s_tracked.clear();
+    s_live.clear();
+    s_dirty.clear();
+    s_path.clear();
+    s_logSize = 0;
+    s_needCompact = false;
+    s_compactRetry = false;
+}
+
+} // namespace Persist
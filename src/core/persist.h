@@ -0,0 +1,43 @@
+#pragma once
+
+#include "utils/psram_alloc.h"
+
+/**
+ * Persist — write-behind storage for state vars marked persist="true".
+ *
+ *   <int name="best" default="0" persist="true"/>
+ *   <array name="slots" type="string" size="8" persist="true"/>
+ *
+ * Values live in an append-only journal <app>/.state on LittleFS:
+ *   [0xA5][nameLen u8][valueLen u16 LE][name][value][crc8]
+ * Replay is "last record wins"; a torn tail (power loss or short write on a
+ * full LittleFS) stops replay, so nothing is appended after it: the next
+ * compaction rewrites the journal first. A failed compaction keeps the old
+ * journal and is retried.
+ *
+ * Changes are collected and appended in one write after DEBOUNCE_MS of
+ * quiet (at most MAX_DELAY_MS late). When the journal grows well past the
+ * live data it is rewritten to a temp file a chunk per loop pass, then
+ * renamed over — no long synchronous save on the UI path.
+ */
+namespace Persist {
+
+/// Mark a state var (or array/map) as persistent. Call while parsing <state>.
+void track(const P::String& name);
+
+/// Open journal of the app and restore tracked values into State (silent)
+void open(const char* appPath);
+
+/// State var changed ("best", "slots[3]")
+void markChanged(const char* varname);
+
+/// Main loop: debounced append, compaction steps
+void process();
+
+/// Write pending changes now (reboot)
+void flush();
+
+/// App exit: flush, then forget tracked vars
+void close();
+
+} // namespace Persist
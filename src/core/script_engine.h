@@ -48,4 +48,8 @@ public:
     
     // Shutdown
     virtual void shutdown() = 0;
+    
+    // Hot app cache: app hidden but kept alive — no timers, no callbacks
+    virtual void suspend() {}
+    virtual void resume() {}
 };
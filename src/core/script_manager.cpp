@@ -7,7 +7,7 @@
 #include <cstring>
 
 static const char* TAG = "ScriptMgr";
-static const char* VERSION = "1.7.0";
+static const char* VERSION = "1.9.0";
 
 IScriptEngine* ScriptManager::s_engine = nullptr;
 
@@ -88,6 +88,23 @@ void ScriptManager::shutdown() {
     }
 }
 
+void ScriptManager::suspend() {
+    for (auto& timer : m_timers) {
+        xTimerStop(timer, 0);
+    }
+    // Calls queued while hidden are dropped by the handler
+    s_engine = nullptr;
+    if (m_engine) m_engine->suspend();
+}
+
+void ScriptManager::resume() {
+    s_engine = m_engine;
+    if (m_engine) m_engine->resume();
+    for (auto& timer : m_timers) {
+        xTimerStart(timer, 0);
+    }
+}
+
 void ScriptManager::loadState() {
     auto& ui = ui_engine();
     int count = ui.stateCount();
@@ -97,20 +114,23 @@ void ScriptManager::loadState() {
     for (int i = 0; i < count; i++) {
         const char* name = ui.stateVarName(i);
         const char* vtype = ui.stateVarType(i);
-        const char* def = ui.stateVarDefault(i);
+        const char* val = ui.stateVarValue(i);  // default, or restored (persist="true")
         
-        LOG_V(Log::LUA, "  state.%s : %s = '%s'", name, vtype, def ? def : "");
+        LOG_V(Log::LUA, "  state.%s : %s = '%s'", name, vtype, val ? val : "");
         
         if (!name) continue;
         
+        // array/map elements stay in Store; engines read them through proxies
+        if (strcmp(vtype, "array") == 0 || strcmp(vtype, "map") == 0) continue;
+        
         if (strcmp(vtype, "bool") == 0) {
-            bool val = def && (strcmp(def, "true") == 0 || strcmp(def, "1") == 0);
-            m_engine->setState(name, val);
+            bool b = val && (strcmp(val, "true") == 0 || strcmp(val, "1") == 0);
+            m_engine->setState(name, b);
         } else if (strcmp(vtype, "int") == 0) {
-            int val = def ? atoi(def) : 0;
-            m_engine->setState(name, val);
+            int n = val ? atoi(val) : 0;
+            m_engine->setState(name, n);
         } else {
-            m_engine->setState(name, def ? def : "");
+            m_engine->setState(name, val ? val : "");
         }
     }
 }
@@ -125,6 +145,9 @@ void ScriptManager::syncState() {
         const char* name = ui.stateVarName(i);
         if (!name) continue;
         
+        auto* var = State::store().getVar(name);
+        if (var && var->isCollection()) continue;
+        
         P::String val = State::store().getAsString(name);
         m_engine->setState(name, val.c_str());
     }
@@ -28,6 +28,10 @@ public:
     
     bool init(IScriptEngine* engine);
     void shutdown();
+    
+    /// Hot app cache: pause timers and queued calls, keep the VM
+    void suspend();
+    void resume();
     IScriptEngine* engine() { return m_engine; }
     
 private:
@@ -5,19 +5,33 @@
 #include <functional>
 #include <cstring>
 #include "utils/psram_alloc.h"
+#include "utils/mem_tags.h"
 #include "utils/log_config.h"
-#include "utils/log_config.h"
+#include <algorithm>
 
 // ============ TYPES ============
 
-enum class VarType { String, Int, Bool, Float };
+enum class VarType { String, Int, Bool, Float, Array, Map };
 
 using VarValue = std::variant<P::String, int, bool, float>;
 
+// Collections (Array/Map) keep all elements in one Variable:
+//   items    - element values, contiguous (array: fixed size, map: parallel to keys)
+//   keys     - map keys, sorted for binary search
+//   elemType - declared element type, used for string conversion
+//   defaultKeys/defaultItems - map entries declared by <item>, restored by reset
+// Elements are addressed by path: "cells[5]", "prices[apple]"
 struct Variable {
     VarType type = VarType::String;
     VarValue value;
     VarValue default_val;
+    VarType elemType = VarType::String;
+    P::Array<VarValue> items;
+    P::Array<P::String> keys;
+    P::Array<VarValue> defaultItems;
+    P::Array<P::String> defaultKeys;
+    
+    bool isCollection() const { return type == VarType::Array || type == VarType::Map; }
 };
 
 // ============ STORE ============
@@ -29,6 +43,7 @@ public:
     // ============ DEFINE ============
     
     void define(const P::String& name, VarType type, const VarValue& default_val) {
+        MEM_SCOPE(Store);
         if (m_vars.find(name) == m_vars.end()) {
             m_names.push_back(name);
         }
@@ -56,10 +71,37 @@ public:
         define(name, VarType::Float, def);
     }
     
+    static constexpr size_t MAX_ARRAY_SIZE = 1024;
+    
+    void defineArray(const P::String& name, VarType elemType, size_t size, const VarValue& fill) {
+        MEM_SCOPE(Store);
+        if (size > MAX_ARRAY_SIZE) size = MAX_ARRAY_SIZE;
+        define(name, VarType::Array, fill);
+        Variable& var = m_vars[name];
+        var.elemType = elemType;
+        var.items.assign(size, fill);
+    }
+    
+    void defineMap(const P::String& name, VarType elemType) {
+        MEM_SCOPE(Store);
+        define(name, VarType::Map, fromString(elemType, ""));
+        m_vars[name].elemType = elemType;
+    }
+    
+    // Current map entries become the ones reset() restores (after <item>s)
+    void keepMapDefaults(const P::String& name) {
+        MEM_SCOPE(Store);
+        auto it = m_vars.find(name);
+        if (it == m_vars.end() || it->second.type != VarType::Map) return;
+        it->second.defaultKeys = it->second.keys;
+        it->second.defaultItems = it->second.items;
+    }
+    
     // ============ GET ============
     
+    // Plain name or "name[sub]" element path
     bool has(const P::String& name) const {
-        return m_vars.find(name) != m_vars.end();
+        return findValue(name) != nullptr;
     }
     
     const Variable* getVar(const P::String& name) const {
@@ -67,53 +109,109 @@ public:
         return it != m_vars.end() ? &it->second : nullptr;
     }
     
+    // Type of a variable or, for "name[sub]" paths, of the collection element
     VarType getType(const P::String& name) const {
+        P::String base, sub;
+        if (splitPath(name, base, sub)) {
+            auto* var = getVar(base);
+            return var && var->isCollection() ? var->elemType : VarType::String;
+        }
         auto* var = getVar(name);
         return var ? var->type : VarType::String;
     }
     
     P::String getString(const P::String& name) const {
-        auto* var = getVar(name);
-        if (!var) return "";
-        if (auto* s = std::get_if<P::String>(&var->value)) return *s;
+        auto* v = findValue(name);
+        if (!v) return "";
+        if (auto* s = std::get_if<P::String>(v)) return *s;
         return getAsString(name);
     }
     
     int getInt(const P::String& name) const {
-        auto* var = getVar(name);
-        if (!var) return 0;
-        if (auto* i = std::get_if<int>(&var->value)) return *i;
-        if (auto* s = std::get_if<P::String>(&var->value)) return std::atoi(s->c_str());
+        auto* v = findValue(name);
+        if (!v) return 0;
+        if (auto* i = std::get_if<int>(v)) return *i;
+        if (auto* s = std::get_if<P::String>(v)) return std::atoi(s->c_str());
         return 0;
     }
     
     bool getBool(const P::String& name) const {
-        auto* var = getVar(name);
-        if (!var) return false;
-        if (auto* b = std::get_if<bool>(&var->value)) return *b;
-        if (auto* s = std::get_if<P::String>(&var->value)) {
+        auto* v = findValue(name);
+        if (!v) return false;
+        if (auto* b = std::get_if<bool>(v)) return *b;
+        if (auto* s = std::get_if<P::String>(v)) {
             return *s == "true" || *s == "1";
         }
         return false;
     }
     
     float getFloat(const P::String& name) const {
-        auto* var = getVar(name);
-        if (!var) return 0.0f;
-        if (auto* f = std::get_if<float>(&var->value)) return *f;
-        if (auto* s = std::get_if<P::String>(&var->value)) return std::atof(s->c_str());
+        auto* v = findValue(name);
+        if (!v) return 0.0f;
+        if (auto* f = std::get_if<float>(v)) return *f;
+        if (auto* s = std::get_if<P::String>(v)) return std::atof(s->c_str());
         return 0.0f;
     }
     
     P::String getAsString(const P::String& name) const {
         auto* var = getVar(name);
-        if (!var) return "";
-        return valueToString(var->value);
+        if (var && var->isCollection()) return collectionToString(*var);
+        auto* v = findValue(name);
+        if (!v) return "";
+        return valueToString(*v);
+    }
+    
+    // ============ COLLECTIONS ============
+    
+    // Element count of array/map, 0 for scalars
+    size_t sizeOf(const P::String& name) const {
+        auto* var = getVar(name);
+        return var && var->isCollection() ? var->items.size() : 0;
+    }
+    
+    // Map key by position (sorted order)
+    const P::String& keyAt(const P::String& name, size_t idx) const {
+        static const P::String empty;
+        auto* var = getVar(name);
+        return var && idx < var->keys.size() ? var->keys[idx] : empty;
+    }
+    
+    // "cells", 5 -> "cells[5]"
+    static P::String elementPath(const P::String& name, const P::String& sub) {
+        P::String path;
+        path.reserve(name.size() + sub.size() + 2);
+        path += name;
+        path += '[';
+        path += sub;
+        path += ']';
+        return path;
+    }
+    
+    static P::String elementPath(const P::String& name, size_t idx) {
+        char buf[12];
+        snprintf(buf, sizeof(buf), "%u", (unsigned)idx);
+        return elementPath(name, P::String(buf));
+    }
+    
+    // "cells[5]" -> base="cells", sub="5". False for plain names.
+    static bool splitPath(const P::String& path, P::String& base, P::String& sub) {
+        size_t open = path.find('[');
+        if (open == P::String::npos || open == 0 || path.back() != ']') return false;
+        base.assign(path, 0, open);
+        sub.assign(path, open + 1, path.size() - open - 2);
+        return true;
     }
     
     // ============ SET ============
     
     void set(const P::String& name, const VarValue& value, bool notify = true) {
+        MEM_SCOPE(Store);
+        P::String base, sub;
+        if (splitPath(name, base, sub)) {
+            setElement(name, base, sub, value, notify);
+            return;
+        }
+        
         auto it = m_vars.find(name);
         if (it == m_vars.end()) {
             Variable var;
@@ -125,6 +223,11 @@ public:
             it = m_vars.find(name);
         }
         
+        if (it->second.isCollection()) {
+            if (Log::get(Log::STATE) >= Log::Warn) OS_LOGW("State", "%s is a collection, set %s[i] instead", name.c_str(), name.c_str());
+            return;
+        }
+        
         if (it->second.value == value) return;
         
         it->second.value = value;
@@ -138,30 +241,10 @@ public:
         set(name, VarValue(value), notify);
     }
     
-    // Set from string, converting to variable's declared type
+    // Set from string, converting to variable's (or element's) declared type
     void setFromString(const P::String& name, const P::String& strValue, bool notify = true) {
-        auto it = m_vars.find(name);
-        if (it == m_vars.end()) {
-            // Variable not defined, create as string
-            set(name, VarValue(strValue), notify);
-            return;
-        }
-        
-        // Convert to declared type
-        switch (it->second.type) {
-            case VarType::String:
-                set(name, VarValue(strValue), notify);
-                break;
-            case VarType::Int:
-                set(name, VarValue(std::atoi(strValue.c_str())), notify);
-                break;
-            case VarType::Bool:
-                set(name, VarValue(strValue == "true" || strValue == "1"), notify);
-                break;
-            case VarType::Float:
-                set(name, VarValue((float)std::atof(strValue.c_str())), notify);
-                break;
-        }
+        // Undefined variables are created as string (getType falls back to String)
+        set(name, fromString(getType(name), strValue), notify);
     }
     
     void setInt(const P::String& name, int value, bool notify = true) {
@@ -179,8 +262,13 @@ public:
     // ============ RESET / CLEAR ============
     
     void reset(const P::String& name) {
+        MEM_SCOPE(Store);
         auto it = m_vars.find(name);
         if (it != m_vars.end()) {
+            if (it->second.isCollection()) {
+                resetCollection(name, it->second, true);
+                return;
+            }
             it->second.value = it->second.default_val;
             if (m_onChange) {
                 m_onChange(name, it->second.value);
@@ -189,8 +277,10 @@ public:
     }
     
     void resetAll() {
+        MEM_SCOPE(Store);
         for (auto& [name, var] : m_vars) {
-            var.value = var.default_val;
+            if (var.isCollection()) resetCollection(name, var, false);
+            else var.value = var.default_val;
         }
     }
     
@@ -237,6 +327,8 @@ public:
             case VarType::Bool: return "bool";
             case VarType::Int: return "int";
             case VarType::Float: return "float";
+            case VarType::Array: return "array";
+            case VarType::Map: return "map";
             default: return "string";
         }
     }
@@ -245,9 +337,21 @@ public:
         if (strcmp(s, "bool") == 0) return VarType::Bool;
         if (strcmp(s, "int") == 0) return VarType::Int;
         if (strcmp(s, "float") == 0) return VarType::Float;
+        if (strcmp(s, "array") == 0) return VarType::Array;
+        if (strcmp(s, "map") == 0) return VarType::Map;
         return VarType::String;
     }
     
+    // Convert string to a scalar value of the given type
+    static VarValue fromString(VarType t, const P::String& s) {
+        switch (t) {
+            case VarType::Int: return std::atoi(s.c_str());
+            case VarType::Bool: return s == "true" || s == "1";
+            case VarType::Float: return (float)std::atof(s.c_str());
+            default: return s;
+        }
+    }
+    
     static bool isKnownType(const char* s) {
         return strcmp(s, "bool") == 0 || strcmp(s, "int") == 0 || 
                strcmp(s, "float") == 0 || strcmp(s, "string") == 0;
@@ -272,6 +376,104 @@ private:
     P::Array<P::String> m_names;
     std::function<void(const P::String&, const VarValue&)> m_onChange;
     
+    // Resolve plain name or "name[sub]" path to its value slot
+    const VarValue* findValue(const P::String& name) const {
+        P::String base, sub;
+        if (!splitPath(name, base, sub)) {
+            auto* var = getVar(name);
+            return var ? &var->value : nullptr;
+        }
+        auto* var = getVar(base);
+        if (!var) return nullptr;
+        int idx = elementIndex(*var, sub);
+        return idx >= 0 ? &var->items[idx] : nullptr;
+    }
+    
+    // Array: numeric index in range. Map: position of key. -1 if absent.
+    static int elementIndex(const Variable& var, const P::String& sub) {
+        if (var.type == VarType::Array) {
+            char* end = nullptr;
+            long idx = std::strtol(sub.c_str(), &end, 10);
+            if (sub.empty() || *end || idx < 0 || (size_t)idx >= var.items.size()) return -1;
+            return (int)idx;
+        }
+        if (var.type == VarType::Map) {
+            auto it = std::lower_bound(var.keys.begin(), var.keys.end(), sub);
+            if (it == var.keys.end() || *it != sub) return -1;
+            return (int)(it - var.keys.begin());
+        }
+        return -1;
+    }
+    
+    void setElement(const P::String& path, const P::String& base, const P::String& sub,
+                    const VarValue& value, bool notify) {
+        auto it = m_vars.find(base);
+        if (it == m_vars.end() || !it->second.isCollection()) {
+            if (Log::get(Log::STATE) >= Log::Warn) OS_LOGW("State", "Not a collection: %s", path.c_str());
+            return;
+        }
+        Variable& var = it->second;
+        
+        int idx = elementIndex(var, sub);
+        if (idx < 0) {
+            if (var.type != VarType::Map) {
+                if (Log::get(Log::STATE) >= Log::Warn) OS_LOGW("State", "Index out of range: %s (size %d)", path.c_str(), (int)var.items.size());
+                return;
+            }
+            auto pos = std::lower_bound(var.keys.begin(), var.keys.end(), sub);
+            idx = (int)(pos - var.keys.begin());
+            var.keys.insert(pos, sub);
+            var.items.insert(var.items.begin() + idx, var.default_val);
+        }
+        
+        if (var.items[idx] == value) return;
+        var.items[idx] = value;
+        
+        if (notify && m_onChange) {
+            m_onChange(path, value);
+        }
+    }
+    
+    // Restore collection defaults; notifies per changed element
+    void resetCollection(const P::String& name, Variable& var, bool notify) {
+        if (var.type == VarType::Map) {
+            // Added keys go away, declared <item> entries get their values back
+            if (notify && m_onChange) {
+                for (size_t i = 0; i < var.keys.size(); i++) {
+                    auto d = std::lower_bound(var.defaultKeys.begin(), var.defaultKeys.end(), var.keys[i]);
+                    if (d == var.defaultKeys.end() || *d != var.keys[i]) {
+                        m_onChange(elementPath(name, var.keys[i]), var.default_val);
+                        continue;
+                    }
+                    const VarValue& def = var.defaultItems[d - var.defaultKeys.begin()];
+                    if (var.items[i] != def) m_onChange(elementPath(name, var.keys[i]), def);
+                }
+            }
+            var.keys = var.defaultKeys;
+            var.items = var.defaultItems;
+            return;
+        }
+        for (size_t i = 0; i < var.items.size(); i++) {
+            if (var.items[i] == var.default_val) continue;
+            var.items[i] = var.default_val;
+            if (notify && m_onChange) m_onChange(elementPath(name, i), var.default_val);
+        }
+    }
+    
+    // Debug/console representation: "a,b,c" or "k=v,k=v"
+    static P::String collectionToString(const Variable& var) {
+        P::String out;
+        for (size_t i = 0; i < var.items.size(); i++) {
+            if (i) out += ',';
+            if (var.type == VarType::Map) {
+                out += var.keys[i];
+                out += '=';
+            }
+            out += valueToString(var.items[i]);
+        }
+        return out;
+    }
+    
     static P::String valueToString(const VarValue& v) {
         return std::visit([](auto&& val) -> P::String {
             using T = std::decay_t<decltype(val)>;
@@ -10,6 +10,7 @@
 
 #include "yaml_config.h"
 #include "utils/log_config.h"
+#include "yaml/yaml_tokenizer.h"
 #include <LittleFS.h>
 #include <Arduino.h>
 
@@ -37,10 +38,10 @@ bool YamlConfig::load() {
     }
 
     P::String content(size, '\0');
-    f.readBytes(&content[0], size);
+    content.resize(f.readBytes(&content[0], size));
     f.close();
 
-    return parseYaml(content.c_str());
+    return parseYaml(content.data(), content.size());
 }
 
 // ============================================
@@ -89,74 +90,37 @@ void YamlConfig::set(const char* key, const char* value) {
 // YAML parser
 // ============================================
 
-bool YamlConfig::parseYaml(const char* content) {
-    P::String section;
-    const char* p = content;
+bool YamlConfig::parseYaml(const char* content, size_t len) {
+    std::string_view section;
+    P::String fullKey, value;   // reused: no allocations per line
     int loaded = 0;
 
-    while (*p) {
-        // Skip empty lines
-        while (*p == '\r' || *p == '\n') p++;
-        if (!*p) break;
+    for (YamlTokenizer::Cursor cur(content, len); !cur.done(); cur.next()) {
+        const YamlTokenizer::Line& line = cur.line();
+        if (line.key.empty() || line.isArrayItem) continue;
 
-        // Skip comment lines
-        if (*p == '#') {
-            while (*p && *p != '\n') p++;
+        // Section header (no value)
+        if (line.isSection) {
+            if (line.indent == 0) section = line.key;
             continue;
         }
 
-        // Count indent
-        int indent = 0;
-        while (*p == ' ') { indent++; p++; }
-        if (!*p || *p == '\n' || *p == '#') {
-            while (*p && *p != '\n') p++;
-            continue;
-        }
-
-        // Read key (until ':')
-        const char* keyStart = p;
-        while (*p && *p != ':' && *p != '\n') p++;
-        if (*p != ':') continue;
-
-        P::String key(keyStart, p - keyStart);
-        while (!key.empty() && key.back() == ' ') key.pop_back();
-        p++; // skip ':'
-
-        // Skip spaces after ':'
-        while (*p == ' ') p++;
-
-        if (!*p || *p == '\n' || *p == '#') {
-            // Section header (no value)
-            if (indent == 0) {
-                section = key;
-            }
-            while (*p && *p != '\n') p++;
-            continue;
-        }
-
-        // Read value
-        const char* valStart = p;
-        while (*p && *p != '\n' && *p != '#') p++;
-        const char* valEnd = p;
-        while (valEnd > valStart && (valEnd[-1] == ' ' || valEnd[-1] == '\r')) valEnd--;
-
-        P::String value(valStart, valEnd - valStart);
-
         // Build full key
-        P::String fullKey;
-        if (indent >= 2 && !section.empty()) {
-            fullKey = section + "." + key;
+        if (line.indent >= 2 && !section.empty()) {
+            fullKey.assign(section.data(), section.size());
+            fullKey += '.';
+            fullKey.append(line.key.data(), line.key.size());
         } else {
-            fullKey = key;
+            fullKey.assign(line.key.data(), line.key.size());
         }
 
         // Set if defined (respects declared type)
         if (m_store.has(fullKey)) {
+            std::string_view v = YamlTokenizer::unquote(line.value);
+            value.assign(v.data(), v.size());
             m_store.setFromString(fullKey, value, false);
             loaded++;
         }
-
-        while (*p && *p != '\n') p++;
     }
 
     LOG_D(Log::APP, "Parsed %d values from %s", loaded, m_path.c_str());
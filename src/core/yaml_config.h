@@ -49,7 +49,7 @@ public:
     void dump() const;
 
 private:
-    bool parseYaml(const char* content);
+    bool parseYaml(const char* content, size_t len);
     P::String toYaml() const;
 
     Store m_store;
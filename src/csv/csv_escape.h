@@ -1,43 +1,43 @@
 #pragma once
 #include <string>
+#include <string_view>
 
 namespace CSV {
 
-// Экранирование строки для CSV с escape sequences
-inline std::string escape(const std::string& str) {
-    std::string result;
-    bool needsQuotes = false;
-    
-    // Заменяем спецсимволы на escape sequences
+// Экранирование в конец out (std::string, P::String): без временных строк
+template<typename S>
+void appendEscaped(S& out, std::string_view str) {
+    // Пробелы по краям без кавычек срезаются при чтении
+    bool needsQuotes = !str.empty() && (str.front() == ' ' || str.front() == '\t' ||
+                                        str.back() == ' ' || str.back() == '\t');
     for (char c : str) {
-        if (c == '\\') {
-            result += "\\\\";
-            needsQuotes = true;
-        } else if (c == '\n') {
-            result += "\\n";
-            needsQuotes = true;
-        } else if (c == '\r') {
-            result += "\\r";
-            needsQuotes = true;
-        } else if (c == '\t') {
-            result += "\\t";
-            needsQuotes = true;
-        } else if (c == '"') {
-            result += "\"\"";
-            needsQuotes = true;
-        } else if (c == ';') {
-            result += c;
+        if (c == '\\' || c == '\n' || c == '\r' || c == '\t' || c == '"' || c == ';') {
             needsQuotes = true;
-        } else {
-            result += c;
+            break;
         }
     }
-    
-    // Оборачиваем в кавычки если есть спецсимволы
-    if (needsQuotes) {
-        return "\"" + result + "\"";
+    if (!needsQuotes) {
+        out.append(str.data(), str.size());
+        return;
     }
     
+    // Заменяем спецсимволы на escape sequences и оборачиваем в кавычки
+    out += '"';
+    for (char c : str) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '\n') out += "\\n";
+        else if (c == '\r') out += "\\r";
+        else if (c == '\t') out += "\\t";
+        else if (c == '"') out += "\"\"";
+        else out += c;
+    }
+    out += '"';
+}
+
+// Экранирование строки для CSV с escape sequences
+inline std::string escape(const std::string& str) {
+    std::string result;
+    appendEscaped(result, str);
     return result;
 }
 
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace CSV {
+
+// Разделитель полей (точка с запятой для европейской локали)
+constexpr char DELIMITER = ';';
+
+// ============================================================================
+// Однопроходный токенизатор поверх готового буфера (без копирования)
+//
+// Поле — смещение и длина в буфере, пробелы/табы по краям срезаны. Поле в
+// кавычках отдаётся без кавычек и с флагом quoted: escape-последовательности
+// (\\ \n \r \t и "") ещё не раскрыты — unescapeInPlace() по требованию.
+//
+// Запись заканчивается \n или \r вне кавычек, так что перевод строки внутри
+// кавычек — часть поля. Кавычки как в RFC 4180: открывает только первый
+// непробельный символ поля, закрывает кавычка перед разделителем, концом
+// строки или EOF. Пустые записи (между \r и \n тоже) пропускаются.
+// ============================================================================
+
+struct Field {
+    uint32_t off;
+    uint32_t len : 31;
+    uint32_t quoted : 1;
+};
+
+enum class Scan : uint8_t {
+    Record,     // onField вызван для каждого поля, pos — за концом записи
+    Empty,      // пустая запись, pos сдвинут
+    Partial,    // данные кончились внутри записи и last == false: дочитать
+                // буфер и сканировать с того же pos (поля уже отданы — сбросить)
+    End         // pos == len
+};
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+inline Field makeField(const char* data, size_t a, size_t b) {
+    while (a < b && isBlank(data[a])) a++;
+    while (b > a && isBlank(data[b - 1])) b--;
+    bool quoted = b - a >= 2 && data[a] == '"' && data[b - 1] == '"';
+    if (quoted) {
+        a++;
+        b--;
+    }
+    return Field{(uint32_t)a, (uint32_t)(b - a), quoted};
+}
+
+// Одна запись из data[pos, len)
+template<typename F>
+Scan scanRecord(const char* data, size_t len, size_t& pos, bool last, F&& onField) {
+    size_t i = pos;
+    if (i >= len) return Scan::End;
+    if (data[i] == '\n' || data[i] == '\r') {
+        pos = i + 1;
+        return Scan::Empty;
+    }
+
+    size_t start = i;
+    bool fieldStart = true;     // до первого непробельного символа поля
+    bool inQuotes = false;
+    for (; i < len; i++) {
+        char c = data[i];
+        if (inQuotes) {
+            if (c != '"') continue;
+            if (i + 1 < len && data[i + 1] == '"') {
+                i++;                // "" внутри кавычек
+                continue;
+            }
+            // Закрывающая — только перед разделителем, концом строки или EOF
+            // (пробелы до них срежет makeField), иначе кавычка часть поля
+            size_t j = i + 1;
+            while (j < len && isBlank(data[j])) j++;
+            if (j == len && !last) return Scan::Partial;
+            if (j == len || data[j] == DELIMITER || data[j] == '\n' || data[j] == '\r') {
+                inQuotes = false;
+            }
+        } else if (c == DELIMITER) {
+            onField(makeField(data, start, i));
+            start = i + 1;
+            fieldStart = true;
+        } else if (c == '\n' || c == '\r') {
+            break;
+        } else if (fieldStart && !isBlank(c)) {
+            // Кавычки открывает только первый непробельный символ поля:
+            // 27" посреди поля — просто символ
+            fieldStart = false;
+            inQuotes = c == '"';
+        }
+    }
+    if (i == len && !last) return Scan::Partial;
+
+    onField(makeField(data, start, i));
+    pos = i < len ? i + 1 : len;
+    return Scan::Record;
+}
+
+// Раскрыть escape-последовательности поля в кавычках на месте.
+// Возвращает новую длину (не больше старой).
+inline uint32_t unescapeInPlace(char* s, uint32_t len) {
+    uint32_t i = 0;
+    while (i < len && s[i] != '\\' && s[i] != '"') i++;
+    if (i == len) return len;
+
+    uint32_t o = i;
+    for (; i < len; i++) {
+        char c = s[i];
+        if (c == '\\' && i + 1 < len) {
+            // ВАЖНО: проверять \\ ПЕРВЫМ!
+            char next = s[i + 1];
+            if (next == '\\') { s[o++] = '\\'; i++; }
+            else if (next == 'n') { s[o++] = '\n'; i++; }
+            else if (next == 'r') { s[o++] = '\r'; i++; }
+            else if (next == 't') { s[o++] = '\t'; i++; }
+            else s[o++] = '\\';     // неизвестный escape - оставляем бэкслеш
+        } else if (c == '"' && i + 1 < len && s[i + 1] == '"') {
+            s[o++] = '"';           // двойная кавычка
+            i++;
+        } else {
+            s[o++] = c;
+        }
+    }
+    return o;
+}
+
+} // namespace CSV
@@ -1,35 +1,124 @@
 #include "engines/lua/lua_csv.h"
-#include "csv/csv_parser.h"
+#include "csv/csv_tokenizer.h"
 #include "csv/csv_escape.h"
 #include "utils/log_config.h"
+#include "utils/mem_tags.h"
+#include "utils/psram_alloc.h"
+#include <Arduino.h>
 #include <LittleFS.h>
-#include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 namespace LuaCSV {
 
 static const char* TAG = "LuaCSV";
 
 // ============================================================================
-// CSV Object — holds parsed data in memory
+// CSV Object — one buffer + field offsets (PSRAM, MemTags::Csv)
+//
+// text is the file as read. Every field is NUL-terminated in place (over the
+// delimiter / closing quote / line end), quoted fields are unescaped in place
+// on first access. Rows added by csv:add() go to extra, unescaped already.
+// csv:numeric() materialises columns into typed arrays.
 // ============================================================================
 
+struct Column {
+    enum Kind : uint8_t { Text, Int, Num };
+    Kind kind = Text;
+    P::Array<lua_Integer> ints;
+    P::Array<lua_Number> nums;
+};
+
+// Hash index of one column's text (csv:index)
+struct Index {
+    struct Slot {
+        uint32_t hash;
+        uint32_t row;           // row + 1, 0 = empty
+    };
+    P::Array<Slot> slots;       // power of two, load <= 1/2
+    size_t count = 0;
+    bool stale = false;         // csv:set() on the column: rebuild before use
+};
+
+// Write-behind state of CSV.load(path, {journal = true}), see "Journal"
+struct Journal {
+    struct Edit {
+        uint32_t row;
+        uint32_t col;
+    };
+    P::Array<Edit> edits;       // cells changed in rows already in the file
+    size_t pendingBytes = 0;    // 0 = nothing to write
+    uint32_t firstDirty = 0;
+    uint32_t lastDirty = 0;
+    size_t logSize = 0;         // <file>.jnl
+    bool needCompact = false;
+    bool createFile = false;    // no file yet: header goes first
+
+    // Compaction in progress
+    File tmp;
+    size_t compactRow = 0;
+    size_t compactEnd = 0;
+    bool compacting = false;
+    bool compactRetry = false;  // last attempt failed at failedAt
+    uint32_t failedAt = 0;
+};
+
 struct CSVObject {
-    std::vector<std::string> headers;
-    std::vector<std::vector<std::string>> rows;
-    size_t loadedRowCount = 0;
-    std::string filename;
+    static constexpr uint32_t EXTRA = 0x80000000u;      // Field::off flag: offset into extra
+
+    mutable P::String text;
+    P::String extra;
+    mutable P::Array<CSV::Field> fields;    // row-major
+    P::Array<uint32_t> rowStart{0};         // first field of each row + end sentinel
+    P::Array<P::String> headers;
+    P::Array<Column> columns;               // empty until csv:numeric()
+    P::Array<Index> indexes;                // empty until csv:index()
+    size_t loadedRowCount = 0;              // rows already in the file
+    P::String filename;
+    P::Ptr<Journal> journal;
+    bool edited = false;                    // csv:set() since the last full save
+
+    size_t rows() const { return rowStart.size() - 1; }
+    size_t width(size_t row) const { return rowStart[row + 1] - rowStart[row]; }
+
+    // NUL-terminated; "" past the end of a short row
+    std::string_view value(size_t row, size_t col) const {
+        if (row >= rows() || col >= width(row)) return "";
+        CSV::Field& f = fields[rowStart[row] + col];
+        if (f.off & EXTRA) return {extra.data() + (f.off & ~EXTRA), f.len};
+        char* s = &text[f.off];
+        if (f.quoted) {
+            f.len = CSV::unescapeInPlace(s, f.len);
+            s[f.len] = '\0';
+            f.quoted = 0;
+        }
+        return {s, f.len};
+    }
+
+    void addValue(const char* s, size_t len) {
+        uint32_t off = (uint32_t)extra.size() | EXTRA;
+        extra.append(s, len);
+        extra += '\0';
+        fields.push_back(CSV::Field{off, (uint32_t)len, 0});
+    }
 
-    std::vector<std::vector<std::string>> getLastRows(int count) const {
-        if (count < 0 || (size_t)count >= rows.size()) return rows;
-        auto start = rows.end() - count;
-        return std::vector<std::vector<std::string>>(start, rows.end());
+    // A short row is padded with empty fields first
+    void setValue(size_t row, size_t col, const char* s, size_t len) {
+        while (width(row) <= col) {
+            uint32_t off = (uint32_t)extra.size() | EXTRA;
+            extra += '\0';
+            fields.insert(fields.begin() + rowStart[row + 1], CSV::Field{off, 0, 0});
+            for (size_t r = row + 1; r < rowStart.size(); r++) rowStart[r]++;
+        }
+        uint32_t off = (uint32_t)extra.size() | EXTRA;
+        extra.append(s, len);
+        extra += '\0';
+        fields[rowStart[row] + col] = CSV::Field{off, (uint32_t)len, 0};
     }
 
-    std::vector<std::vector<std::string>> getNewRows() const {
-        if (loadedRowCount >= rows.size()) return {};
-        auto start = rows.begin() + loadedRowCount;
-        return std::vector<std::vector<std::string>>(start, rows.end());
+    const Column* typed(size_t col) const {
+        return col < columns.size() && columns[col].kind != Column::Text ? &columns[col] : nullptr;
     }
 };
 
@@ -43,57 +132,493 @@ static CSVObject* checkCSV(lua_State* L, int index) {
     return static_cast<CSVObject*>(ud);
 }
 
-static bool parseCSVText(const std::string& text, CSVObject* csv, std::string& error) {
-    std::istringstream stream(text);
-    std::string line;
+// Typed columns as numbers, the rest as strings
+static void pushValue(lua_State* L, const CSVObject* csv, size_t row, size_t col) {
+    if (const Column* c = csv->typed(col)) {
+        if (c->kind == Column::Int) lua_pushinteger(L, c->ints[row]);
+        else lua_pushnumber(L, c->nums[row]);
+        return;
+    }
+    std::string_view v = csv->value(row, col);
+    lua_pushlstring(L, v.data(), v.size());
+}
+
+// ---- Column index: FNV-1a, linear probing (as in TaskQueue) ----
+
+static uint32_t hashValue(std::string_view s) {
+    uint32_t h = 2166136261u;
+    for (char c : s) h = (h ^ (uint8_t)c) * 16777619u;
+    return h;
+}
+
+static void indexPut(Index& ix, uint32_t hash, size_t row) {
+    size_t mask = ix.slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        if (!ix.slots[i].row) {
+            ix.slots[i] = Index::Slot{hash, (uint32_t)row + 1};
+            ix.count++;
+            return;
+        }
+    }
+}
+
+static void indexBuild(const CSVObject* csv, Index& ix, size_t col) {
+    size_t cap = 16;
+    while (cap < csv->rows() * 2 + 2) cap *= 2;
+    P::Array<Index::Slot>(cap, Index::Slot{0, 0}).swap(ix.slots);
+    ix.count = 0;
+    for (size_t r = 0; r < csv->rows(); r++) indexPut(ix, hashValue(csv->value(r, col)), r);
+}
+
+// Row already in csv->rows()
+static void indexAdd(const CSVObject* csv, Index& ix, size_t col, size_t row) {
+    if (ix.stale) return;
+    if ((ix.count + 1) * 2 > ix.slots.size()) indexBuild(csv, ix, col);
+    else indexPut(ix, hashValue(csv->value(row, col)), row);
+}
+
+static void indexRefresh(CSVObject* csv) {
+    for (size_t i = 0; i < csv->indexes.size(); i++) {
+        Index& ix = csv->indexes[i];
+        if (!ix.stale) continue;
+        MEM_SCOPE(Csv);
+        indexBuild(csv, ix, i);
+        ix.stale = false;
+    }
+}
+
+static const Index* indexOf(const CSVObject* csv, size_t col) {
+    if (col >= csv->indexes.size()) return nullptr;
+    const Index& ix = csv->indexes[col];
+    return ix.slots.empty() || ix.stale ? nullptr : &ix;
+}
+
+// fn(row) for each row whose text is v, in row order, until fn returns false.
+// Equal keys sit in one probe run in insertion order.
+template<typename F>
+static void indexFind(const CSVObject* csv, const Index& ix, size_t col, std::string_view v, F&& fn) {
+    uint32_t h = hashValue(v);
+    size_t mask = ix.slots.size() - 1;
+    for (size_t i = h & mask; ix.slots[i].row; i = (i + 1) & mask) {
+        const Index::Slot& s = ix.slots[i];
+        if (s.hash == h && csv->value(s.row - 1, col) == v && !fn(s.row - 1)) return;
+    }
+}
+
+// ============================================================================
+// Native access
+// ============================================================================
+
+CSVObject* toCSV(lua_State* L, int index) {
+    return static_cast<CSVObject*>(luaL_testudata(L, index, "CSV"));
+}
+
+size_t rowCount(const CSVObject* csv) {
+    return csv ? csv->rows() : 0;
+}
+
+int columnIndex(const CSVObject* csv, const char* name) {
+    if (!csv || !name) return -1;
+    for (size_t i = 0; i < csv->headers.size(); i++) {
+        if (csv->headers[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+const char* field(const CSVObject* csv, size_t row, size_t col) {
+    if (!csv) return "";
+    return csv->value(row, col).data();
+}
+
+// Tokenize csv->text in place
+static bool parseCSVText(CSVObject* csv, const char*& error) {
+    char* data = &csv->text[0];
+    size_t len = csv->text.size();
+    size_t pos = 0;
+
+    auto keep = [&](CSV::Field f) {
+        data[f.off + f.len] = '\0';     // already scanned: delimiter, quote or line end
+        csv->fields.push_back(f);
+    };
 
-    if (!std::getline(stream, line)) {
+    CSV::Scan st = CSV::scanRecord(data, len, pos, true, keep);
+    if (st == CSV::Scan::End) {
         error = "Empty CSV file";
         return false;
     }
-
-    csv->headers = CSV::parseLine(line);
-    if (csv->headers.empty()) {
+    if (st == CSV::Scan::Empty) {
         error = "Invalid CSV format: no headers found";
         return false;
     }
 
-    int lineNum = 1;
-    while (std::getline(stream, line)) {
-        lineNum++;
-        if (line.empty()) continue;
+    csv->headers.reserve(csv->fields.size());
+    for (const CSV::Field& f : csv->fields) {
+        uint32_t n = f.quoted ? CSV::unescapeInPlace(data + f.off, f.len) : f.len;
+        csv->headers.emplace_back(data + f.off, n);
+    }
+    csv->fields.clear();
+
+    // Line count is an upper bound for the row count
+    size_t lines = 0;
+    for (const char* p = data + pos; (p = (const char*)memchr(p, '\n', data + len - p)); p++) lines++;
+    csv->rowStart.reserve(lines + 2);
+    csv->fields.reserve((lines + 1) * csv->headers.size());
+
+    while ((st = CSV::scanRecord(data, len, pos, true, keep)) != CSV::Scan::End) {
+        if (st == CSV::Scan::Empty) continue;
+        size_t got = csv->fields.size() - csv->rowStart.back();
+        if (got != csv->headers.size()) {
+            LOG_W(Log::LUA, "CSV row %d: field count mismatch (expected %d, got %d)",
+                  (int)csv->rows() + 1, (int)csv->headers.size(), (int)got);
+        }
+        csv->rowStart.push_back(csv->fields.size());
+    }
+
+    csv->loadedRowCount = csv->rows();
+    return true;
+}
+
+static void serializeHeader(const CSVObject* csv, P::String& out) {
+    for (size_t i = 0; i < csv->headers.size(); i++) {
+        if (i > 0) out += CSV::DELIMITER;
+        CSV::appendEscaped(out, csv->headers[i]);
+    }
+    out += '\n';
+}
 
-        auto fields = CSV::parseLine(line);
-        if (fields.size() != csv->headers.size()) {
-            LOG_W(Log::LUA, "CSV line %d: field count mismatch (expected %d, got %d)",
-                  lineNum, (int)csv->headers.size(), (int)fields.size());
+static void serializeRows(const CSVObject* csv, size_t from, size_t to, P::String& out) {
+    for (size_t r = from; r < to; r++) {
+        for (size_t i = 0; i < csv->width(r); i++) {
+            if (i > 0) out += CSV::DELIMITER;
+            CSV::appendEscaped(out, csv->value(r, i));
         }
-        csv->rows.push_back(fields);
+        out += '\n';
+    }
+}
+
+P::String rowText(const CSVObject* csv, size_t row) {
+    P::String out;
+    if (!csv || row >= csv->rows()) return out;
+    serializeRows(csv, row, row + 1, out);
+    out.pop_back();
+    return out;
+}
+
+static P::String serializeCSV(const CSVObject* csv) {
+    P::String result;
+    result.reserve(csv->text.size() + csv->extra.size() + 64);
+    serializeHeader(csv, result);
+    serializeRows(csv, 0, csv->rows(), result);
+    return result;
+}
+
+static int pushParsed(lua_State* L, CSVObject* csv) {
+    const char* error = nullptr;
+    if (!parseCSVText(csv, error)) {
+        csv->~CSVObject();
+        lua_pushnil(L);
+        lua_pushstring(L, error);
+        return 2;
     }
 
-    csv->loadedRowCount = csv->rows.size();
+    luaL_getmetatable(L, "CSV");
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+// Column by name or 1-based index; -1 if absent
+static int checkColumn(lua_State* L, const CSVObject* csv, int arg) {
+    if (lua_type(L, arg) == LUA_TNUMBER) {
+        lua_Integer i = lua_tointeger(L, arg);
+        return i >= 1 && (size_t)i <= csv->headers.size() ? (int)i - 1 : -1;
+    }
+    return columnIndex(csv, lua_tostring(L, arg));
+}
+
+// ============================================================================
+// Journal — write-behind saving for CSV.load(path, {journal = true})
+//
+// Same scheme as Persist (core/persist.h). Rows from csv:add() are appended
+// to the file in one write after DEBOUNCE_MS of quiet, MAX_DELAY_MS at the
+// latest, or once FLUSH_BYTES are pending. csv:set() on a row already in the
+// file appends "row;col;value" to <file>.jnl instead of a rewrite, load
+// replays it. From COMPACT_MIN of journal the file is rewritten to <file>.tmp
+// COMPACT_ROWS rows per loop pass and renamed over, then the journal goes.
+//
+// Every write ends in '\n', so an unterminated last line is a write cut by
+// power loss: dropped unless it has all the fields, and the file is
+// compacted before anything is appended to it again. A short write (full
+// LittleFS) counts the same; a failed compaction keeps the old file and is
+// retried, appends wait for it.
+// ============================================================================
+
+static constexpr uint32_t DEBOUNCE_MS = 1000;
+static constexpr uint32_t MAX_DELAY_MS = 5000;
+static constexpr size_t FLUSH_BYTES = 4096;
+static constexpr size_t COMPACT_MIN = 4096;
+static constexpr size_t COMPACT_ROWS = 64;
+
+static P::Array<CSVObject*> s_journaled;
+
+// All of data or failure: a short write (LittleFS full) leaves part of it
+// behind as a torn tail (torn = true)
+static bool writeFile(const P::String& path, const char* mode, const P::String& data,
+                      bool* torn = nullptr) {
+    File f = LittleFS.open(path.c_str(), mode);
+    if (!f) return false;
+    size_t written = f.write((const uint8_t*)data.data(), data.size());
+    f.close();
+    if (written == data.size()) return true;
+    LOG_E(Log::LUA, "Short write %s: %u/%u bytes", path.c_str(), (unsigned)written, (unsigned)data.size());
+    if (torn) *torn = written > 0;
+    return false;
+}
+
+static void journalTouch(CSVObject* csv, size_t bytes) {
+    Journal& j = *csv->journal;
+    uint32_t now = millis();
+    if (!j.pendingBytes) j.firstDirty = now;
+    j.lastDirty = now;
+    j.pendingBytes += bytes;
+}
+
+// Retried after DEBOUNCE_MS. A torn tail would glue the next append onto
+// it: only a rewrite from memory fixes that file.
+static bool appendFailed(CSVObject* csv, bool torn) {
+    Journal& j = *csv->journal;
+    LOG_E(Log::LUA, "Cannot append %s", csv->filename.c_str());
+    if (torn) j.needCompact = true;
+    j.firstDirty = j.lastDirty = millis();
+    return false;
+}
+
+// New rows to the file, edits of older rows to the journal
+static bool journalAppend(CSVObject* csv) {
+    Journal& j = *csv->journal;
+    if (j.compacting || j.needCompact) return true;     // compaction writes them
+    MEM_SCOPE(Csv);
+
+    P::String edits;
+    for (const Journal::Edit& e : j.edits) {
+        if (e.row >= csv->loadedRowCount) continue;     // goes out with its row
+        char head[24];
+        snprintf(head, sizeof(head), "%u;%u;", (unsigned)e.row, (unsigned)e.col);
+        edits += head;
+        CSV::appendEscaped(edits, csv->value(e.row, e.col));
+        edits += '\n';
+    }
+
+    P::String rows;
+    if (j.createFile) serializeHeader(csv, rows);
+    serializeRows(csv, csv->loadedRowCount, csv->rows(), rows);
+
+    bool torn = false;
+    if (!rows.empty()) {
+        if (!writeFile(csv->filename, j.createFile ? "w" : "a", rows, &torn)) return appendFailed(csv, torn);
+        // Rows are in the file: a retry only writes the edits
+        size_t from = csv->loadedRowCount;
+        csv->loadedRowCount = csv->rows();
+        j.createFile = false;
+        j.edits.erase(std::remove_if(j.edits.begin(), j.edits.end(),
+                                     [from](const Journal::Edit& e) { return e.row >= from; }),
+                      j.edits.end());
+    }
+    if (!edits.empty() && !writeFile(csv->filename + ".jnl", "a", edits, &torn)) return appendFailed(csv, torn);
+
+    j.edits.clear();
+    j.pendingBytes = 0;
+    j.logSize += edits.size();
+    if (j.logSize >= COMPACT_MIN) j.needCompact = true;
     return true;
 }
 
-static std::string serializeCSV(const CSVObject* csv, bool onlyNew) {
-    std::ostringstream result;
+// The file stays as it was and needCompact stays set: appends wait, the
+// rewrite is tried again after MAX_DELAY_MS (or on flush)
+static void compactFailed(CSVObject* csv) {
+    Journal& j = *csv->journal;
+    LOG_E(Log::LUA, "Compaction of %s failed, retrying later", csv->filename.c_str());
+    if (j.tmp) j.tmp.close();
+    LittleFS.remove((csv->filename + ".tmp").c_str());
+    j.compacting = false;
+    j.compactRetry = true;
+    j.failedAt = millis();
+}
 
-    for (size_t i = 0; i < csv->headers.size(); i++) {
-        if (i > 0) result << CSV::DELIMITER;
-        result << csv->headers[i];
+static bool tmpWrite(Journal& j, const P::String& data) {
+    return j.tmp.write((const uint8_t*)data.data(), data.size()) == data.size();
+}
+
+static void compactBegin(CSVObject* csv) {
+    Journal& j = *csv->journal;
+    MEM_SCOPE(Csv);
+    j.tmp = LittleFS.open((csv->filename + ".tmp").c_str(), "w");
+    if (!j.tmp) {
+        LOG_E(Log::LUA, "Cannot create %s.tmp", csv->filename.c_str());
+        compactFailed(csv);
+        return;
+    }
+
+    // Current values go out: earlier edits and rows are covered
+    P::String head;
+    serializeHeader(csv, head);
+    if (!tmpWrite(j, head)) {
+        compactFailed(csv);
+        return;
+    }
+    j.compactRow = 0;
+    j.compactEnd = csv->rows();
+    j.edits.clear();
+    j.pendingBytes = 0;
+    j.compacting = true;
+}
+
+static void compactStep(CSVObject* csv) {
+    Journal& j = *csv->journal;
+    if (j.compactRow < j.compactEnd) {
+        MEM_SCOPE(Csv);
+        size_t to = std::min(j.compactRow + COMPACT_ROWS, j.compactEnd);
+        P::String chunk;
+        serializeRows(csv, j.compactRow, to, chunk);
+        if (!tmpWrite(j, chunk)) {
+            compactFailed(csv);
+            return;
+        }
+        j.compactRow = to;
+        return;
+    }
+
+    j.tmp.close();
+    P::String tmp = csv->filename + ".tmp";
+    // File without tmp, or tmp alone, is always a consistent state (see load)
+    if (!LittleFS.rename(tmp.c_str(), csv->filename.c_str())) {
+        LittleFS.remove(csv->filename.c_str());
+        if (!LittleFS.rename(tmp.c_str(), csv->filename.c_str())) {
+            LOG_E(Log::LUA, "Compaction rename failed: %s", csv->filename.c_str());
+        }
+    }
+    LittleFS.remove((csv->filename + ".jnl").c_str());
+    LOG_I(Log::LUA, "Compacted %s: %d rows, journal %d bytes dropped",
+          csv->filename.c_str(), (int)j.compactEnd, (int)j.logSize);
+
+    csv->loadedRowCount = j.compactEnd;
+    j.logSize = 0;
+    j.createFile = false;
+    j.needCompact = false;
+    j.compactRetry = false;
+    j.compacting = false;
+}
+
+// Everything on disk now
+static bool journalFlush(CSVObject* csv) {
+    Journal& j = *csv->journal;
+    if (j.needCompact && !j.compacting) compactBegin(csv);
+    while (j.compacting) compactStep(csv);
+    if (j.needCompact) return false;        // rewrite failed, nothing appended
+    return !j.pendingBytes || journalAppend(csv);
+}
+
+// Interrupted compaction: with the file present tmp may be partial,
+// without it tmp is complete (died between remove and rename)
+static void journalRecover(const char* filename) {
+    P::String tmp = P::String(filename) + ".tmp";
+    if (!LittleFS.exists(tmp.c_str())) return;
+    if (LittleFS.exists(filename)) LittleFS.remove(tmp.c_str());
+    else LittleFS.rename(tmp.c_str(), filename);
+}
+
+static bool parseIndex(std::string_view s, uint32_t& out) {
+    if (s.empty() || s.size() > 9) return false;
+    out = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return false;
+        out = out * 10 + (c - '0');
     }
-    result << "\n";
+    return true;
+}
 
-    auto rowsToWrite = onlyNew ? csv->getNewRows() : csv->rows;
-    for (const auto& row : rowsToWrite) {
-        for (size_t i = 0; i < row.size(); i++) {
-            if (i > 0) result << CSV::DELIMITER;
-            result << CSV::escape(row[i]);
+// Re-apply <file>.jnl edits
+static void journalReplay(CSVObject* csv) {
+    Journal& j = *csv->journal;
+    P::String path = csv->filename + ".jnl";
+    File f = LittleFS.open(path.c_str(), "r");
+    if (!f) return;
+
+    P::String buf;
+    buf.resize(f.size());
+    buf.resize(f.read((uint8_t*)&buf[0], buf.size()));
+    f.close();
+    j.logSize = buf.size();
+
+    char* data = &buf[0];
+    size_t len = buf.size();
+    bool terminated = len && buf.back() == '\n';
+    size_t pos = 0;
+    int applied = 0, skipped = 0;
+    CSV::Field rec[3];
+    for (;;) {
+        int n = 0;
+        CSV::Scan st = CSV::scanRecord(data, len, pos, true, [&](CSV::Field fl) {
+            if (n < 3) rec[n] = fl;
+            n++;
+        });
+        if (st == CSV::Scan::End) break;
+        if (st == CSV::Scan::Empty) continue;
+        if (pos >= len && !terminated) {
+            LOG_W(Log::LUA, "%s: torn last line dropped", path.c_str());
+            j.needCompact = true;
+            break;
+        }
+        uint32_t row, col;
+        if (n != 3 || rec[0].quoted || rec[1].quoted ||
+            !parseIndex({data + rec[0].off, rec[0].len}, row) ||
+            !parseIndex({data + rec[1].off, rec[1].len}, col) ||
+            row >= csv->rows() || col >= csv->headers.size()) {
+            skipped++;
+            continue;
         }
-        result << "\n";
+        CSV::Field v = rec[2];
+        if (v.quoted) v.len = CSV::unescapeInPlace(data + v.off, v.len);
+        csv->setValue(row, col, data + v.off, v.len);
+        applied++;
     }
+    if (j.logSize >= COMPACT_MIN) j.needCompact = true;
+    LOG_I(Log::LUA, "%s: %d edits replayed, %d skipped", path.c_str(), applied, skipped);
+}
 
-    return result.str();
+// Torn tail of the file, journal replay; registers csv for process()
+static void journalOpen(CSVObject* csv, bool terminated) {
+    Journal& j = *csv->journal;
+    if (!terminated) {
+        size_t last = csv->rows();
+        if (last && csv->width(last - 1) != csv->headers.size()) {
+            csv->fields.resize(csv->rowStart[last - 1]);
+            csv->rowStart.pop_back();
+            csv->loadedRowCount = csv->rows();
+            LOG_W(Log::LUA, "%s: torn last line dropped", csv->filename.c_str());
+        }
+        j.needCompact = true;
+    }
+    journalReplay(csv);
+    s_journaled.push_back(csv);
+}
+
+void process() {
+    uint32_t now = millis();
+    for (CSVObject* csv : s_journaled) {
+        Journal& j = *csv->journal;
+        if (j.compacting) {
+            compactStep(csv);
+        } else if (j.needCompact) {
+            if (!j.compactRetry || now - j.failedAt >= MAX_DELAY_MS) compactBegin(csv);
+        } else if (j.pendingBytes && (j.pendingBytes >= FLUSH_BYTES || now - j.lastDirty >= DEBOUNCE_MS ||
+                                      now - j.firstDirty >= MAX_DELAY_MS)) {
+            journalAppend(csv);
+        }
+    }
+}
+
+void flushAll() {
+    for (CSVObject* csv : s_journaled) journalFlush(csv);
 }
 
 // ============================================================================
@@ -103,52 +628,83 @@ static std::string serializeCSV(const CSVObject* csv, bool onlyNew) {
 static int csv_loadText(lua_State* L) {
     size_t len;
     const char* text = luaL_checklstring(L, 1, &len);
+    MEM_SCOPE(Csv);
 
     CSVObject* csv = static_cast<CSVObject*>(lua_newuserdata(L, sizeof(CSVObject)));
     new (csv) CSVObject();
-
-    std::string error;
-    if (!parseCSVText(std::string(text, len), csv, error)) {
-        csv->~CSVObject();
-        lua_pushnil(L);
-        lua_pushstring(L, error.c_str());
-        return 2;
-    }
-
-    luaL_getmetatable(L, "CSV");
-    lua_setmetatable(L, -2);
-    return 1;
+    csv->text.assign(text, len);
+    return pushParsed(L, csv);
 }
 
 // ============================================================================
-// CSV.load(filename)
+// CSV.load(filename, opts?)
+//   opts.journal — write-behind saving (see Journal)
+//   opts.headers — start empty if the file doesn't exist yet
 // ============================================================================
 
 static int csv_load(lua_State* L) {
     const char* filename = luaL_checkstring(L, 1);
+    bool journal = false;
+    int headers = 0;
+    if (lua_istable(L, 2)) {
+        lua_getfield(L, 2, "journal");
+        journal = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+        lua_getfield(L, 2, "headers");      // stays on the stack
+        if (lua_istable(L, -1) && lua_rawlen(L, -1) > 0) headers = lua_gettop(L);
+    }
+    MEM_SCOPE(Csv);
 
+    if (journal) journalRecover(filename);
     File file = LittleFS.open(filename, "r");
-    if (!file) {
+    if (file && headers && file.size() == 0) file.close();
+    if (!file && !headers) {
         lua_pushnil(L);
         lua_pushfstring(L, "File not found: %s", filename);
         return 2;
     }
-
-    size_t sz = file.size();
-    std::string text(sz, '\0');
-    file.readBytes(&text[0], sz);
-    file.close();
+    bool exists = (bool)file;
 
     CSVObject* csv = static_cast<CSVObject*>(lua_newuserdata(L, sizeof(CSVObject)));
     new (csv) CSVObject();
     csv->filename = filename;
 
-    std::string error;
-    if (!parseCSVText(text, csv, error)) {
-        csv->~CSVObject();
-        lua_pushnil(L);
-        lua_pushstring(L, error.c_str());
-        return 2;
+    bool terminated = true;
+    if (exists) {
+        // Straight into the object's buffer: the parse works in place
+        size_t sz = file.size();
+        csv->text.resize(sz);
+        csv->text.resize(file.read((uint8_t*)&csv->text[0], sz));
+        file.close();
+        terminated = csv->text.empty() || csv->text.back() == '\n';
+
+        const char* error = nullptr;
+        if (!parseCSVText(csv, error)) {
+            csv->~CSVObject();
+            lua_pushnil(L);
+            lua_pushstring(L, error);
+            return 2;
+        }
+    } else {
+        size_t n = lua_rawlen(L, headers);
+        csv->headers.reserve(n);
+        for (size_t i = 1; i <= n; i++) {
+            lua_rawgeti(L, headers, i);
+            size_t len = 0;
+            const char* h = lua_isstring(L, -1) ? lua_tolstring(L, -1, &len) : "";
+            csv->headers.emplace_back(h, len);
+            lua_pop(L, 1);
+        }
+    }
+
+    if (journal) {
+        csv->journal = P::create<Journal>();
+        if (csv->journal) {
+            csv->journal->createFile = !exists;
+            journalOpen(csv, terminated);
+        } else {
+            LOG_E(Log::LUA, "No memory for journal: %s", filename);
+        }
     }
 
     luaL_getmetatable(L, "CSV");
@@ -160,21 +716,25 @@ static int csv_load(lua_State* L) {
 // csv:records(count?)
 // ============================================================================
 
+static size_t firstOfLast(const CSVObject* csv, int count) {
+    size_t n = csv->rows();
+    return count < 0 || (size_t)count >= n ? 0 : n - count;
+}
+
 static int csv_records(lua_State* L) {
     CSVObject* csv = checkCSV(L, 1);
     int count = luaL_optinteger(L, 2, -1);
-    auto rows = csv->getLastRows(count);
+    size_t from = firstOfLast(csv, count);
 
-    lua_createtable(L, rows.size(), 0);
-    for (size_t i = 0; i < rows.size(); i++) {
-        const auto& row = rows[i];
+    lua_createtable(L, csv->rows() - from, 0);
+    for (size_t r = from; r < csv->rows(); r++) {
         lua_createtable(L, 0, csv->headers.size());
-        for (size_t j = 0; j < csv->headers.size() && j < row.size(); j++) {
-            lua_pushstring(L, csv->headers[j].c_str());
-            lua_pushstring(L, row[j].c_str());
+        for (size_t j = 0; j < csv->headers.size() && j < csv->width(r); j++) {
+            lua_pushlstring(L, csv->headers[j].data(), csv->headers[j].size());
+            pushValue(L, csv, r, j);
             lua_settable(L, -3);
         }
-        lua_rawseti(L, -2, i + 1);
+        lua_rawseti(L, -2, r - from + 1);
     }
     return 1;
 }
@@ -186,29 +746,368 @@ static int csv_records(lua_State* L) {
 static int csv_rows(lua_State* L) {
     CSVObject* csv = checkCSV(L, 1);
     int count = luaL_optinteger(L, 2, -1);
-    auto rows = csv->getLastRows(count);
-
-    lua_createtable(L, rows.size(), 0);
-    for (size_t i = 0; i < rows.size(); i++) {
-        const auto& row = rows[i];
-        lua_createtable(L, row.size(), 0);
-        for (size_t j = 0; j < row.size(); j++) {
-            lua_pushstring(L, row[j].c_str());
+    size_t from = firstOfLast(csv, count);
+
+    lua_createtable(L, csv->rows() - from, 0);
+    for (size_t r = from; r < csv->rows(); r++) {
+        lua_createtable(L, csv->width(r), 0);
+        for (size_t j = 0; j < csv->width(r); j++) {
+            pushValue(L, csv, r, j);
             lua_rawseti(L, -2, j + 1);
         }
-        lua_rawseti(L, -2, i + 1);
+        lua_rawseti(L, -2, r - from + 1);
+    }
+    return 1;
+}
+
+// ============================================================================
+// csv:column(col) — all values of one column (name or 1-based index)
+// ============================================================================
+
+static int csv_column(lua_State* L) {
+    CSVObject* csv = checkCSV(L, 1);
+    int col = checkColumn(L, csv, 2);
+    if (col < 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_createtable(L, csv->rows(), 0);
+    for (size_t r = 0; r < csv->rows(); r++) {
+        pushValue(L, csv, r, col);
+        lua_rawseti(L, -2, r + 1);
     }
     return 1;
 }
 
+// ============================================================================
+// csv:numeric(col, ...) — store columns as numbers
+//
+// A column converts only if every cell is a number (lua_stringtonumber);
+// integer unless some cell is fractional. Returns true if all did.
+// ============================================================================
+
+static bool materialise(lua_State* L, CSVObject* csv, size_t col) {
+    Column c;
+    c.kind = Column::Int;
+    c.ints.reserve(csv->rows());
+
+    for (size_t r = 0; r < csv->rows(); r++) {
+        std::string_view v = csv->value(r, col);
+        if (v.empty() || lua_stringtonumber(L, v.data()) == 0) return false;
+        if (c.kind == Column::Int && !lua_isinteger(L, -1)) {
+            c.kind = Column::Num;
+            c.nums.reserve(csv->rows());
+            for (lua_Integer i : c.ints) c.nums.push_back((lua_Number)i);
+            P::Array<lua_Integer>().swap(c.ints);
+        }
+        if (c.kind == Column::Int) c.ints.push_back(lua_tointeger(L, -1));
+        else c.nums.push_back(lua_tonumber(L, -1));
+        lua_pop(L, 1);
+    }
+
+    if (csv->columns.size() < csv->headers.size()) csv->columns.resize(csv->headers.size());
+    csv->columns[col] = std::move(c);
+    return true;
+}
+
+static int csv_numeric(lua_State* L) {
+    CSVObject* csv = checkCSV(L, 1);
+    int top = lua_gettop(L);
+    int cols[16];
+    int n = 0;
+    for (int i = 2; i <= top; i++) {
+        int col = checkColumn(L, csv, i);
+        if (col < 0) return luaL_error(L, "Unknown column: %s", luaL_tolstring(L, i, nullptr));
+        if (n == 16) return luaL_error(L, "Too many columns (max 16)");
+        cols[n++] = col;
+    }
+
+    MEM_SCOPE(Csv);
+    bool all = true;
+    for (int i = 0; i < n; i++) {
+        if (csv->typed(cols[i])) continue;
+        if (!materialise(L, csv, cols[i])) all = false;
+    }
+    lua_pushboolean(L, all);
+    return 1;
+}
+
+// ============================================================================
+// Queries — evaluated over the field offsets, no table per row
+//
+// Results are arrays of 1-based row indices; csv:record(i) gives one row as a
+// dict. A number value compares numerically (typed column or parsed cell,
+// non-numbers never match except ~=), a string compares bytewise.
+// ============================================================================
+
+enum class Op : uint8_t { Eq, Ne, Lt, Le, Gt, Ge, Contains, Prefix };
+
+struct Cond {
+    int col;
+    Op op;
+    bool numeric;
+    bool isInt;
+    lua_Integer i;
+    lua_Number n;
+    std::string_view str;       // Lua string kept on the stack
+};
+
+static bool parseOp(const char* s, Op& op) {
+    static const struct { const char* name; Op op; } OPS[] = {
+        {"==", Op::Eq}, {"=", Op::Eq}, {"~=", Op::Ne}, {"!=", Op::Ne},
+        {"<", Op::Lt}, {"<=", Op::Le}, {">", Op::Gt}, {">=", Op::Ge},
+        {"contains", Op::Contains}, {"prefix", Op::Prefix},
+    };
+    for (const auto& o : OPS) {
+        if (strcmp(s, o.name) == 0) {
+            op = o.op;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Value at idx (stays on the stack while the cond is used)
+static void setCondValue(lua_State* L, Cond& c, int idx) {
+    c.numeric = lua_type(L, idx) == LUA_TNUMBER && c.op != Op::Contains && c.op != Op::Prefix;
+    if (c.numeric) {
+        c.isInt = lua_isinteger(L, idx);
+        c.i = lua_tointeger(L, idx);
+        c.n = lua_tonumber(L, idx);
+        return;
+    }
+    size_t len = 0;
+    const char* s = lua_tolstring(L, idx, &len);
+    if (!s) luaL_error(L, "CSV query: string or number value expected");
+    c.str = {s, len};
+}
+
+// Sign of cell - value; false if the cell isn't a number
+static bool compareNumber(lua_State* L, const CSVObject* csv, size_t row, const Cond& c, int& cmp) {
+    bool isInt;
+    lua_Integer i = 0;
+    lua_Number n = 0;
+    if (const Column* col = csv->typed(c.col)) {
+        isInt = col->kind == Column::Int;
+        if (isInt) i = col->ints[row];
+        else n = col->nums[row];
+    } else {
+        std::string_view v = csv->value(row, c.col);
+        if (v.empty() || lua_stringtonumber(L, v.data()) == 0) return false;
+        isInt = lua_isinteger(L, -1);
+        i = lua_tointeger(L, -1);
+        n = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+    }
+    if (isInt && c.isInt) {
+        cmp = (i > c.i) - (i < c.i);
+    } else {
+        if (isInt) n = (lua_Number)i;
+        cmp = (n > c.n) - (n < c.n);
+    }
+    return true;
+}
+
+static bool matches(lua_State* L, const CSVObject* csv, size_t row, const Cond& c) {
+    int cmp;
+    if (c.numeric) {
+        if (!compareNumber(L, csv, row, c, cmp)) return c.op == Op::Ne;
+    } else {
+        std::string_view v = csv->value(row, c.col);
+        if (c.op == Op::Contains) return v.find(c.str) != std::string_view::npos;
+        if (c.op == Op::Prefix) return v.substr(0, c.str.size()) == c.str;
+        cmp = v.compare(c.str);
+    }
+    switch (c.op) {
+        case Op::Eq: return cmp == 0;
+        case Op::Ne: return cmp != 0;
+        case Op::Lt: return cmp < 0;
+        case Op::Le: return cmp <= 0;
+        case Op::Gt: return cmp > 0;
+        case Op::Ge: return cmp >= 0;
+        default:     return false;
+    }
+}
+
+// Rows matching all conds, through a column index when one applies.
+// fn(row) returns false to stop.
+template<typename F>
+static void selectRows(lua_State* L, const CSVObject* csv, const Cond* conds, int n, F&& fn) {
+    for (int k = 0; k < n; k++) {
+        const Cond& c = conds[k];
+        const Index* ix = c.op == Op::Eq && !c.numeric ? indexOf(csv, c.col) : nullptr;
+        if (!ix) continue;
+        indexFind(csv, *ix, c.col, c.str, [&](size_t row) {
+            for (int j = 0; j < n; j++) {
+                if (j != k && !matches(L, csv, row, conds[j])) return true;
+            }
+            return fn(row);
+        });
+        return;
+    }
+
+    for (size_t row = 0; row < csv->rows(); row++) {
+        bool all = true;
+        for (int j = 0; j < n && all; j++) all = matches(L, csv, row, conds[j]);
+        if (all && !fn(row)) return;
+    }
+}
+
+// csv:index(col) — hash index for find / == conditions, kept up by csv:add
+static int csv_index(lua_State* L) {
+    CSVObject* csv = checkCSV(L, 1);
+    int col = checkColumn(L, csv, 2);
+    if (col < 0) return luaL_error(L, "Unknown column: %s", luaL_tolstring(L, 2, nullptr));
+
+    MEM_SCOPE(Csv);
+    if (csv->indexes.size() < csv->headers.size()) csv->indexes.resize(csv->headers.size());
+    indexBuild(csv, csv->indexes[col], col);
+    return 0;
+}
+
+// csv:find(col, value) — first matching row index or nil
+static int csv_find(lua_State* L) {
+    CSVObject* csv = checkCSV(L, 1);
+    indexRefresh(csv);
+    Cond c{};
+    c.col = checkColumn(L, csv, 2);
+    if (c.col < 0) return luaL_error(L, "Unknown column: %s", luaL_tolstring(L, 2, nullptr));
+    c.op = Op::Eq;
+    setCondValue(L, c, 3);
+
+    size_t found = 0;
+    selectRows(L, csv, &c, 1, [&](size_t row) {
+        found = row + 1;
+        return false;
+    });
+    if (found) lua_pushinteger(L, found);
+    else lua_pushnil(L);
+    return 1;
+}
+
+// csv:where({col=, op=, value=} or a list of them, limit?) — AND of conditions
+static int csv_where(lua_State* L) {
+    static constexpr int MAX_CONDS = 8;
+    CSVObject* csv = checkCSV(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    indexRefresh(csv);
+    lua_Integer limit = luaL_optinteger(L, 3, 0);
+
+    lua_getfield(L, 2, "col");
+    bool single = !lua_isnil(L, -1);
+    lua_pop(L, 1);
+    int n = single ? 1 : (int)lua_rawlen(L, 2);
+    if (n < 1 || n > MAX_CONDS) return luaL_error(L, "CSV where: 1..%d conditions", MAX_CONDS);
+    luaL_checkstack(L, n + 4, nullptr);
+
+    Cond conds[MAX_CONDS];
+    for (int k = 0; k < n; k++) {
+        int t = 2;
+        if (!single) {
+            lua_rawgeti(L, 2, k + 1);
+            luaL_argcheck(L, lua_istable(L, -1), 2, "condition tables expected");
+            t = lua_gettop(L);
+        }
+        Cond& c = conds[k];
+        lua_getfield(L, t, "col");
+        c.col = checkColumn(L, csv, -1);
+        if (c.col < 0) return luaL_error(L, "Unknown column: %s", luaL_tolstring(L, -1, nullptr));
+        lua_pop(L, 1);
+
+        lua_getfield(L, t, "op");
+        const char* op = lua_isnil(L, -1) ? "==" : lua_tostring(L, -1);
+        if (!op || !parseOp(op, c.op)) return luaL_error(L, "CSV where: unknown op '%s'", op ? op : "?");
+        lua_pop(L, 1);
+
+        lua_getfield(L, t, "value");    // left on the stack for c.str
+        setCondValue(L, c, -1);
+    }
+
+    lua_newtable(L);
+    lua_Integer count = 0;
+    selectRows(L, csv, conds, n, [&](size_t row) {
+        lua_pushinteger(L, row + 1);
+        lua_rawseti(L, -2, ++count);
+        return limit <= 0 || count < limit;
+    });
+    return 1;
+}
+
+template<typename K>
+static void sortBy(P::Array<uint32_t>& order, const K* keys, bool desc) {
+    std::stable_sort(order.begin(), order.end(), [=](uint32_t a, uint32_t b) {
+        return desc ? keys[b] < keys[a] : keys[a] < keys[b];
+    });
+}
+
+// csv:sort(col, desc?) — row indices ordered by the column (stable; numeric
+// for typed columns, bytewise otherwise). The rows themselves don't move.
+static int csv_sort(lua_State* L) {
+    CSVObject* csv = checkCSV(L, 1);
+    int col = checkColumn(L, csv, 2);
+    if (col < 0) return luaL_error(L, "Unknown column: %s", luaL_tolstring(L, 2, nullptr));
+    bool desc = lua_toboolean(L, 3);
+
+    lua_createtable(L, csv->rows(), 0);
+    {
+        MEM_SCOPE(Csv);
+        P::Array<uint32_t> order(csv->rows());
+        for (size_t r = 0; r < order.size(); r++) order[r] = r;
+
+        if (const Column* c = csv->typed(col)) {
+            if (c->kind == Column::Int) sortBy(order, c->ints.data(), desc);
+            else sortBy(order, c->nums.data(), desc);
+        } else {
+            P::Array<std::string_view> keys(csv->rows());
+            for (size_t r = 0; r < keys.size(); r++) keys[r] = csv->value(r, col);
+            sortBy(order, keys.data(), desc);
+        }
+
+        for (size_t i = 0; i < order.size(); i++) {
+            lua_pushinteger(L, order[i] + 1);
+            lua_rawseti(L, -2, i + 1);
+        }
+    }
+    return 1;
+}
+
+// csv:record(i) — one row as a dict, nil if out of range
+static int csv_record(lua_State* L) {
+    CSVObject* csv = checkCSV(L, 1);
+    lua_Integer i = luaL_checkinteger(L, 2);
+    if (i < 1 || (size_t)i > csv->rows()) {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    size_t r = i - 1;
+    lua_createtable(L, 0, csv->headers.size());
+    for (size_t j = 0; j < csv->headers.size() && j < csv->width(r); j++) {
+        lua_pushlstring(L, csv->headers[j].data(), csv->headers[j].size());
+        pushValue(L, csv, r, j);
+        lua_settable(L, -3);
+    }
+    return 1;
+}
+
+static int csv_len(lua_State* L) {
+    lua_pushinteger(L, checkCSV(L, 1)->rows());
+    return 1;
+}
+
 // ============================================================================
 // csv:rawText()
 // ============================================================================
 
 static int csv_rawText(lua_State* L) {
     CSVObject* csv = checkCSV(L, 1);
-    std::string text = serializeCSV(csv, false);
-    lua_pushlstring(L, text.c_str(), text.length());
+    P::String text;
+    {
+        MEM_SCOPE(Csv);
+        text = serializeCSV(csv);
+    }
+    lua_pushlstring(L, text.data(), text.size());
     return 1;
 }
 
@@ -216,13 +1115,33 @@ static int csv_rawText(lua_State* L) {
 // csv:add(record)
 // ============================================================================
 
+// Keep a typed column typed if the cell is a number, else back to text.
+// row == size appends.
+static void storeTyped(lua_State* L, Column& c, size_t row, std::string_view v) {
+    if (v.empty() || lua_stringtonumber(L, v.data()) == 0) {
+        c = Column();
+        return;
+    }
+    if (c.kind == Column::Int && !lua_isinteger(L, -1)) {
+        c.kind = Column::Num;
+        c.nums.reserve(c.ints.size() + 1);
+        for (lua_Integer i : c.ints) c.nums.push_back((lua_Number)i);
+        P::Array<lua_Integer>().swap(c.ints);
+    }
+    if (c.kind == Column::Int) {
+        if (row < c.ints.size()) c.ints[row] = lua_tointeger(L, -1);
+        else c.ints.push_back(lua_tointeger(L, -1));
+    } else {
+        if (row < c.nums.size()) c.nums[row] = lua_tonumber(L, -1);
+        else c.nums.push_back(lua_tonumber(L, -1));
+    }
+    lua_pop(L, 1);
+}
+
 static int csv_add(lua_State* L) {
     CSVObject* csv = checkCSV(L, 1);
     luaL_checktype(L, 2, LUA_TTABLE);
 
-    std::vector<std::string> row;
-    row.resize(csv->headers.size());
-
     // Detect dict vs array
     lua_pushnil(L);
     bool isDict = false;
@@ -231,36 +1150,75 @@ static int csv_add(lua_State* L) {
         lua_pop(L, 2);
     }
 
-    if (isDict) {
-        for (size_t i = 0; i < csv->headers.size(); i++) {
-            lua_pushstring(L, csv->headers[i].c_str());
+    // luaL_error longjmps past destructors: check before allocating
+    size_t arraySize = isDict ? 0 : lua_rawlen(L, 2);
+    if (!isDict && arraySize != csv->headers.size()) {
+        return luaL_error(L, "Field count mismatch: expected %d, got %d",
+                        (int)csv->headers.size(), (int)arraySize);
+    }
+
+    MEM_SCOPE(Csv);
+    size_t bytes = csv->headers.size();
+    for (size_t i = 0; i < csv->headers.size(); i++) {
+        if (isDict) {
+            lua_pushlstring(L, csv->headers[i].data(), csv->headers[i].size());
             lua_gettable(L, 2);
-            if (lua_isstring(L, -1)) {
-                row[i] = lua_tostring(L, -1);
-            } else if (lua_isnumber(L, -1)) {
-                row[i] = lua_tostring(L, -1);
-            }
-            lua_pop(L, 1);
-        }
-    } else {
-        size_t arraySize = lua_rawlen(L, 2);
-        if (arraySize != csv->headers.size()) {
-            return luaL_error(L, "Field count mismatch: expected %d, got %d",
-                            (int)csv->headers.size(), (int)arraySize);
-        }
-        for (size_t i = 0; i < arraySize; i++) {
+        } else {
             lua_rawgeti(L, 2, i + 1);
-            if (lua_isstring(L, -1) || lua_isnumber(L, -1)) {
-                row[i] = lua_tostring(L, -1);
-            }
-            lua_pop(L, 1);
         }
+        size_t len = 0;
+        const char* s = lua_isstring(L, -1) ? lua_tolstring(L, -1, &len) : "";
+        csv->addValue(s, len);
+        bytes += len;
+        if (csv->typed(i)) storeTyped(L, csv->columns[i], csv->rows(), {s, len});
+        lua_pop(L, 1);
     }
 
-    csv->rows.push_back(row);
+    csv->rowStart.push_back(csv->fields.size());
+    for (size_t i = 0; i < csv->indexes.size(); i++) {
+        if (!csv->indexes[i].slots.empty()) indexAdd(csv, csv->indexes[i], i, csv->rows() - 1);
+    }
+    if (csv->journal) journalTouch(csv, bytes);
     return 0;
 }
 
+// ============================================================================
+// csv:set(i, col, value) — change one cell
+// ============================================================================
+
+static int csv_set(lua_State* L) {
+    CSVObject* csv = checkCSV(L, 1);
+    lua_Integer i = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, i >= 1 && (size_t)i <= csv->rows(), 2, "row out of range");
+    int col = checkColumn(L, csv, 3);
+    if (col < 0) return luaL_error(L, "Unknown column: %s", luaL_tolstring(L, 3, nullptr));
+    size_t len = 0;
+    const char* s = lua_isstring(L, 4) ? lua_tolstring(L, 4, &len) : "";
+
+    MEM_SCOPE(Csv);
+    size_t row = i - 1;
+    csv->setValue(row, col, s, len);
+    if (csv->typed(col)) storeTyped(L, csv->columns[col], row, {s, len});
+    if ((size_t)col < csv->indexes.size() && !csv->indexes[col].slots.empty()) csv->indexes[col].stale = true;
+    csv->edited = true;
+
+    if (csv->journal) {
+        P::Array<Journal::Edit>& edits = csv->journal->edits;
+        if (edits.empty() || edits.back().row != row || edits.back().col != (uint32_t)col) {
+            edits.push_back(Journal::Edit{(uint32_t)row, (uint32_t)col});
+        }
+        journalTouch(csv, len + 16);
+    }
+    return 0;
+}
+
+// csv:flush() — write journaled changes now
+static int csv_flush(lua_State* L) {
+    CSVObject* csv = checkCSV(L, 1);
+    lua_pushboolean(L, !csv->journal || journalFlush(csv));
+    return 1;
+}
+
 // ============================================================================
 // csv:save(onlyNew?)
 // ============================================================================
@@ -275,46 +1233,23 @@ static int csv_save(lua_State* L) {
         return 2;
     }
 
-    bool ok = false;
-
-    if (onlyNew && csv->loadedRowCount < csv->rows.size()) {
-        bool fileExists = LittleFS.exists(csv->filename.c_str());
-
-        if (fileExists) {
+    bool ok;
+    if (csv->journal) {
+        // Full save = compaction now
+        if (!onlyNew) csv->journal->needCompact = true;
+        ok = journalFlush(csv);
+    } else {
+        MEM_SCOPE(Csv);
+        P::String data;
+        if (onlyNew && !csv->edited && csv->loadedRowCount < csv->rows() &&
+            LittleFS.exists(csv->filename.c_str())) {
             // Append only new rows
-            std::string data;
-            auto newRows = csv->getNewRows();
-            for (const auto& row : newRows) {
-                for (size_t i = 0; i < row.size(); i++) {
-                    if (i > 0) data += CSV::DELIMITER;
-                    data += CSV::escape(row[i]);
-                }
-                data += "\n";
-            }
-            File f = LittleFS.open(csv->filename.c_str(), "a");
-            if (f) {
-                f.write((const uint8_t*)data.c_str(), data.size());
-                f.close();
-                ok = true;
-            }
+            serializeRows(csv, csv->loadedRowCount, csv->rows(), data);
+            ok = writeFile(csv->filename, "a", data);
         } else {
-            // New file — write everything
-            std::string data = serializeCSV(csv, false);
-            File f = LittleFS.open(csv->filename.c_str(), "w");
-            if (f) {
-                f.write((const uint8_t*)data.c_str(), data.size());
-                f.close();
-                ok = true;
-            }
-        }
-    } else {
-        // Full rewrite
-        std::string data = serializeCSV(csv, false);
-        File f = LittleFS.open(csv->filename.c_str(), "w");
-        if (f) {
-            f.write((const uint8_t*)data.c_str(), data.size());
-            f.close();
-            ok = true;
+            // Full rewrite (or new file)
+            data = serializeCSV(csv);
+            ok = writeFile(csv->filename, "w", data);
         }
     }
 
@@ -324,7 +1259,8 @@ static int csv_save(lua_State* L) {
         return 2;
     }
 
-    csv->loadedRowCount = csv->rows.size();
+    csv->loadedRowCount = csv->rows();
+    csv->edited = false;
     lua_pushboolean(L, 1);
     return 1;
 }
@@ -335,10 +1271,236 @@ static int csv_save(lua_State* L) {
 
 static int csv_gc(lua_State* L) {
     CSVObject* csv = checkCSV(L, 1);
+    if (csv->journal) {
+        journalFlush(csv);
+        s_journaled.erase(std::find(s_journaled.begin(), s_journaled.end(), csv));
+    }
     csv->~CSVObject();
     return 0;
 }
 
+// ============================================================================
+// CSV.open(filename) — streaming reader
+//
+// Reads the file in BLOCK-sized pieces and yields one record at a time, so
+// memory stays at one block however large the file is. A record crossing a
+// block boundary (quoted newlines included) is moved to the front of the
+// buffer and rescanned after the next read; the buffer only grows for a
+// record longer than a block, up to MAX_RECORD.
+// ============================================================================
+
+struct CSVReader {
+    static constexpr size_t BLOCK = 4096;
+    static constexpr size_t MAX_RECORD = 64 * 1024;
+
+    File file;
+    P::String filename;
+    P::Array<P::String> headers;
+    P::Array<char> buf;
+    P::Array<CSV::Field> fields;    // current record, offsets into buf
+    size_t fill = 0;                // valid bytes in buf
+    size_t pos = 0;                 // next record in buf
+    uint32_t bufStart = 0;          // file offset of buf[0]
+    uint32_t dataStart = 0;         // file offset of the first record
+    size_t index = 0;               // records returned
+    bool eof = false;
+
+    void close() {
+        if (file) file.close();
+        P::Array<char>().swap(buf);
+        P::Array<CSV::Field>().swap(fields);
+        fill = pos = 0;
+        eof = true;
+    }
+
+    // Drop consumed bytes and read more; false if the record doesn't fit
+    bool refill() {
+        if (pos > 0) {
+            memmove(buf.data(), buf.data() + pos, fill - pos);
+            bufStart += pos;
+            fill -= pos;
+            pos = 0;
+        }
+        if (fill == buf.size()) {
+            if (buf.size() >= MAX_RECORD) return false;
+            buf.resize(buf.empty() ? BLOCK : buf.size() * 2);
+        }
+        size_t want = buf.size() - fill;
+        size_t got = file ? file.read((uint8_t*)buf.data() + fill, want) : 0;
+        fill += got;
+        if (got < want) {
+            eof = true;
+            file.close();
+        }
+        return true;
+    }
+
+    // Next record into fields; false at end of file (error set if too long)
+    bool next(const char*& error) {
+        for (;;) {
+            fields.clear();
+            CSV::Scan st = CSV::scanRecord(buf.data(), fill, pos, eof,
+                                           [this](CSV::Field f) { fields.push_back(f); });
+            if (st == CSV::Scan::Record) return true;
+            if (st == CSV::Scan::Empty) continue;
+            if (st == CSV::Scan::End && eof) return false;
+            if (!refill()) {
+                error = "CSV record too long";
+                return false;
+            }
+        }
+    }
+
+    std::string_view value(size_t i) {
+        CSV::Field& f = fields[i];
+        if (f.quoted) {
+            f.len = CSV::unescapeInPlace(buf.data() + f.off, f.len);
+            f.quoted = 0;
+        }
+        return {buf.data() + f.off, f.len};
+    }
+};
+
+static CSVReader* checkReader(lua_State* L, int index) {
+    return static_cast<CSVReader*>(luaL_checkudata(L, index, "CSVReader"));
+}
+
+// Pushes the next record as a dict (like csv:records()) or returns false
+static bool pushNext(lua_State* L, CSVReader* r) {
+    const char* error = nullptr;
+    bool ok;
+    {
+        MEM_SCOPE(Csv);
+        ok = r->next(error);
+    }
+    if (!ok) {
+        if (error) luaL_error(L, "%s (> %d bytes) in %s", error,
+                              (int)CSVReader::MAX_RECORD, r->filename.c_str());
+        return false;
+    }
+
+    r->index++;
+    lua_createtable(L, 0, r->headers.size());
+    for (size_t j = 0; j < r->headers.size() && j < r->fields.size(); j++) {
+        std::string_view v = r->value(j);
+        lua_pushlstring(L, r->headers[j].data(), r->headers[j].size());
+        lua_pushlstring(L, v.data(), v.size());
+        lua_settable(L, -3);
+    }
+    return true;
+}
+
+static int csv_open(lua_State* L) {
+    const char* filename = luaL_checkstring(L, 1);
+    MEM_SCOPE(Csv);
+
+    File file = LittleFS.open(filename, "r");
+    if (!file) {
+        lua_pushnil(L);
+        lua_pushfstring(L, "File not found: %s", filename);
+        return 2;
+    }
+
+    CSVReader* r = static_cast<CSVReader*>(lua_newuserdata(L, sizeof(CSVReader)));
+    new (r) CSVReader();
+    r->file = file;
+    r->filename = filename;
+
+    const char* error = nullptr;
+    if (!r->next(error) || r->fields.empty()) {
+        r->~CSVReader();
+        lua_pushnil(L);
+        lua_pushstring(L, error ? error : "Empty CSV file");
+        return 2;
+    }
+    r->headers.reserve(r->fields.size());
+    for (size_t i = 0; i < r->fields.size(); i++) r->headers.emplace_back(r->value(i));
+    r->dataStart = r->bufStart + r->pos;
+
+    luaL_getmetatable(L, "CSVReader");
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+// reader:each(fn) — fn(record, n) for every remaining record, stops early
+// if fn returns false. Returns the number of records passed to fn.
+static int reader_each(lua_State* L) {
+    CSVReader* r = checkReader(L, 1);
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+
+    size_t from = r->index;
+    while (pushNext(L, r)) {
+        lua_pushvalue(L, 2);
+        lua_insert(L, -2);
+        lua_pushinteger(L, r->index);
+        lua_call(L, 2, 1);
+        bool stop = lua_isboolean(L, -1) && !lua_toboolean(L, -1);
+        lua_pop(L, 1);
+        if (stop) break;
+    }
+    lua_pushinteger(L, r->index - from);
+    return 1;
+}
+
+// for n, record in reader:iter() do ... end — break closes the file
+static int reader_next(lua_State* L) {
+    CSVReader* r = checkReader(L, 1);
+    if (!pushNext(L, r)) return 0;
+    lua_pushinteger(L, r->index);
+    lua_insert(L, -2);
+    return 2;
+}
+
+static int reader_iter(lua_State* L) {
+    checkReader(L, 1);
+    lua_pushcfunction(L, reader_next);
+    lua_pushvalue(L, 1);
+    lua_pushnil(L);
+    lua_pushvalue(L, 1);    // to-be-closed
+    return 4;
+}
+
+static int reader_headers(lua_State* L) {
+    CSVReader* r = checkReader(L, 1);
+    lua_createtable(L, r->headers.size(), 0);
+    for (size_t i = 0; i < r->headers.size(); i++) {
+        lua_pushlstring(L, r->headers[i].data(), r->headers[i].size());
+        lua_rawseti(L, -2, i + 1);
+    }
+    return 1;
+}
+
+// Back to the first record (reopens a closed file)
+static int reader_rewind(lua_State* L) {
+    CSVReader* r = checkReader(L, 1);
+    MEM_SCOPE(Csv);
+    if (!r->file) r->file = LittleFS.open(r->filename.c_str(), "r");
+    if (!r->file || !r->file.seek(r->dataStart)) {
+        r->close();
+        lua_pushboolean(L, 0);
+        lua_pushfstring(L, "Cannot reopen: %s", r->filename.c_str());
+        return 2;
+    }
+    r->fill = r->pos = 0;
+    r->bufStart = r->dataStart;
+    r->index = 0;
+    r->eof = false;
+    lua_pushboolean(L, 1);
+    return 1;
+}
+
+static int reader_close(lua_State* L) {
+    checkReader(L, 1)->close();
+    return 0;
+}
+
+static int reader_gc(lua_State* L) {
+    CSVReader* r = checkReader(L, 1);
+    r->close();
+    r->~CSVReader();
+    return 0;
+}
+
 // ============================================================================
 // Registration
 // ============================================================================
@@ -352,9 +1514,18 @@ void registerAll(lua_State* L) {
 
     lua_pushstring(L, "records");  lua_pushcfunction(L, csv_records);  lua_settable(L, -3);
     lua_pushstring(L, "rows");     lua_pushcfunction(L, csv_rows);     lua_settable(L, -3);
+    lua_pushstring(L, "column");   lua_pushcfunction(L, csv_column);   lua_settable(L, -3);
+    lua_pushstring(L, "numeric");  lua_pushcfunction(L, csv_numeric);  lua_settable(L, -3);
+    lua_pushstring(L, "record");   lua_pushcfunction(L, csv_record);   lua_settable(L, -3);
+    lua_pushstring(L, "find");     lua_pushcfunction(L, csv_find);     lua_settable(L, -3);
+    lua_pushstring(L, "where");    lua_pushcfunction(L, csv_where);    lua_settable(L, -3);
+    lua_pushstring(L, "sort");     lua_pushcfunction(L, csv_sort);     lua_settable(L, -3);
+    lua_pushstring(L, "index");    lua_pushcfunction(L, csv_index);    lua_settable(L, -3);
     lua_pushstring(L, "rawText");  lua_pushcfunction(L, csv_rawText);  lua_settable(L, -3);
     lua_pushstring(L, "add");      lua_pushcfunction(L, csv_add);      lua_settable(L, -3);
+    lua_pushstring(L, "set");      lua_pushcfunction(L, csv_set);      lua_settable(L, -3);
     lua_pushstring(L, "save");     lua_pushcfunction(L, csv_save);     lua_settable(L, -3);
+    lua_pushstring(L, "flush");    lua_pushcfunction(L, csv_flush);    lua_settable(L, -3);
 
     lua_settable(L, -3);  // metatable.__index = methods
 
@@ -362,15 +1533,39 @@ void registerAll(lua_State* L) {
     lua_pushcfunction(L, csv_gc);
     lua_settable(L, -3);
 
+    lua_pushstring(L, "__len");
+    lua_pushcfunction(L, csv_len);
+    lua_settable(L, -3);
+
     lua_pop(L, 1);  // pop metatable
 
+    // Metatable for streaming readers
+    luaL_newmetatable(L, "CSVReader");
+
+    lua_pushstring(L, "__index");
+    lua_newtable(L);
+
+    lua_pushstring(L, "each");     lua_pushcfunction(L, reader_each);    lua_settable(L, -3);
+    lua_pushstring(L, "iter");     lua_pushcfunction(L, reader_iter);    lua_settable(L, -3);
+    lua_pushstring(L, "headers");  lua_pushcfunction(L, reader_headers); lua_settable(L, -3);
+    lua_pushstring(L, "rewind");   lua_pushcfunction(L, reader_rewind);  lua_settable(L, -3);
+    lua_pushstring(L, "close");    lua_pushcfunction(L, reader_close);   lua_settable(L, -3);
+
+    lua_settable(L, -3);
+
+    lua_pushstring(L, "__close");  lua_pushcfunction(L, reader_close);   lua_settable(L, -3);
+    lua_pushstring(L, "__gc");     lua_pushcfunction(L, reader_gc);      lua_settable(L, -3);
+
+    lua_pop(L, 1);
+
     // Global CSV table
     lua_newtable(L);
     lua_pushstring(L, "load");     lua_pushcfunction(L, csv_load);     lua_settable(L, -3);
     lua_pushstring(L, "loadText"); lua_pushcfunction(L, csv_loadText); lua_settable(L, -3);
+    lua_pushstring(L, "open");     lua_pushcfunction(L, csv_open);     lua_settable(L, -3);
     lua_setglobal(L, "CSV");
 
-    LOG_I(Log::LUA, "Registered: CSV.load/loadText + methods");
+    LOG_I(Log::LUA, "Registered: CSV.load/loadText/open + methods");
 }
 
 } // namespace LuaCSV
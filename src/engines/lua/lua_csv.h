@@ -7,17 +7,52 @@ extern "C" {
 
 /**
  * lua_csv.h - CSV namespace for Lua
- *   CSV.load(filename)       — load from file
+ *   CSV.load(filename, opts?) — load from file; opts.journal = write-behind
+ *                               saving, opts.headers = start empty if missing
  *   CSV.loadText(text)       — parse from string
  *   csv:records(count?)      — get records as dicts
  *   csv:rows(count?)         — get records as arrays
+ *   csv:column(col)          — all values of a column (name or 1-based index)
+ *   csv:numeric(col, ...)    — store columns as numbers; false if a cell isn't one
+ *   csv:record(i) / #csv     — one row as a dict / row count
+ *   csv:find(col, value)     — first matching row index or nil
+ *   csv:where(cond, limit?)  — row indices; cond = {col=, op=, value=} or a list (AND),
+ *                              op: == ~= < <= > >= contains prefix
+ *   csv:sort(col, desc?)     — row indices ordered by column (rows don't move)
+ *   csv:index(col)           — hash index used by find / ==, kept up by add
  *   csv:rawText()            — serialize to string
  *   csv:add(record)          — add record (dict or array)
+ *   csv:set(i, col, value)   — change one cell
  *   csv:save(onlyNew?)       — save to file
+ *   csv:flush()              — write journaled changes now
+ *
+ * The file stays in one PSRAM buffer, fields are offsets into it (strings
+ * unescaped on first access). Numeric columns come back as numbers.
+ *
+ * Streaming (files of any size, one 4 KB block in memory):
+ *   CSV.open(filename)       — reader, headers read
+ *   reader:each(fn)          — fn(record, n); return false to stop
+ *   for n, rec in reader:iter() do ... end
+ *   reader:headers() / rewind() / close()
  */
 
+#include <cstddef>
+#include "utils/psram_alloc.h"
+
 namespace LuaCSV {
 
 void registerAll(lua_State* L);
 
+// Read-only access for native consumers (e.g. <list> data source)
+struct CSVObject;
+CSVObject* toCSV(lua_State* L, int index);      // nullptr if not a CSV object
+size_t rowCount(const CSVObject* csv);
+int columnIndex(const CSVObject* csv, const char* name);  // -1 if absent
+const char* field(const CSVObject* csv, size_t row, size_t col);  // "" if out of range
+P::String rowText(const CSVObject* csv, size_t row);             // the row as a CSV line
+
+// Journaled objects (CSV.load(path, {journal = true}))
+void process();     // main loop: debounced appends, compaction steps
+void flushAll();    // app suspend / reboot: pending rows and edits now
+
 } // namespace LuaCSV
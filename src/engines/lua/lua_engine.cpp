@@ -5,7 +5,10 @@
 #include "engines/lua/lua_ui.h"
 #include "engines/lua/lua_csv.h"
 #include "engines/lua/lua_yaml.h"
+#include "ui/ui_list.h"
 #include "utils/log_config.h"
+#include "utils/trace.h"
+#include "utils/mem_tags.h"
 #include "esp_heap_caps.h"
 #include <cstring>
 
@@ -13,11 +16,13 @@ LuaEngine* LuaEngine::s_instance = nullptr;
 
 static const char* TAG = "LuaEngine";
 
-// PSRAM allocator for Lua
+// PSRAM allocator for Lua. Lua passes the block size back (osize is the
+// object type when ptr is null), so MemTags::Lua is counted without headers.
 static void* lua_psram_alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
-    (void)ud; (void)osize;
+    (void)ud;
     
     if (nsize == 0) {
+        if (ptr) MemTags::discharge(MemTags::Lua, osize);
         free(ptr);
         return nullptr;
     }
@@ -25,11 +30,13 @@ static void* lua_psram_alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
     if (ptr == nullptr) {
         void* p = heap_caps_malloc(nsize, MALLOC_CAP_SPIRAM);
         if (!p) p = malloc(nsize);
+        if (p) MemTags::charge(MemTags::Lua, nsize);
         return p;
     }
     
     void* p = heap_caps_realloc(ptr, nsize, MALLOC_CAP_SPIRAM);
     if (!p) p = realloc(ptr, nsize);
+    if (p) MemTags::resize(MemTags::Lua, osize, nsize);
     return p;
 }
 
@@ -186,14 +193,66 @@ static P::String preprocessForwardDecl(const char* source) {
     return header + body;
 }
 
-bool LuaEngine::execute(const char* code) {
-    if (!m_lua) return false;
+// ============ Precompiled chunk (app preload) ============
+
+static P::String s_preBytecode;
+static uint32_t s_preHash = 0;
+static size_t s_preLen = 0;
+
+static uint32_t sourceHash(const char* s, size_t len) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < len; i++) h = (h ^ (uint8_t)s[i]) * 16777619u;
+    return h;
+}
+
+static int dumpWriter(lua_State*, const void* p, size_t sz, void* ud) {
+    static_cast<P::String*>(ud)->append((const char*)p, sz);
+    return 0;
+}
+
+P::String LuaEngine::compile(const char* code) {
+    P::String bytecode;
+    if (!code || !*code) return bytecode;
     
-    P::String processed = preprocessForwardDecl(code);
+    lua_State* L = lua_newstate(lua_psram_alloc, nullptr);
+    if (!L) return bytecode;
     
-    LOG_D(Log::LUA, "execute() - %d bytes", (int)processed.size());
+    // Same chunk name as luaL_dostring, so error messages do not change
+    P::String processed = preprocessForwardDecl(code);
+    if (luaL_loadbuffer(L, processed.c_str(), processed.size(), processed.c_str()) == LUA_OK) {
+        lua_dump(L, dumpWriter, &bytecode, 0);
+    } else {
+        bytecode.clear();  // syntax error is reported by the real execute()
+    }
+    lua_close(L);
+    return bytecode;
+}
+
+void LuaEngine::setPrecompiled(const char* code, P::String bytecode) {
+    s_preBytecode = std::move(bytecode);
+    s_preLen = code ? strlen(code) : 0;
+    s_preHash = code ? sourceHash(code, s_preLen) : 0;
+}
+
+bool LuaEngine::execute(const char* code) {
+    if (!m_lua) return false;
+    TRACE_SCOPE("lua.execute");
+    MEM_SCOPE(Lua);
+    
+    int result;
+    size_t len = s_preBytecode.empty() ? 0 : strlen(code);
+    if (len && len == s_preLen && sourceHash(code, len) == s_preHash) {
+        LOG_D(Log::LUA, "execute() - precompiled %d bytes", (int)s_preBytecode.size());
+        result = luaL_loadbufferx(m_lua, s_preBytecode.data(), s_preBytecode.size(), "=app", "b");
+        if (result == LUA_OK) result = lua_pcall(m_lua, 0, LUA_MULTRET, 0);
+        s_preBytecode.clear();
+        s_preBytecode.shrink_to_fit();
+    } else {
+        P::String processed = preprocessForwardDecl(code);
+        LOG_D(Log::LUA, "execute() - %d bytes", (int)processed.size());
+        result = luaL_dostring(m_lua, processed.c_str());
+    }
     
-    int result = luaL_dostring(m_lua, processed.c_str());
     if (result != LUA_OK) {
         const char* err = lua_tostring(m_lua, -1);
         LOG_E(Log::LUA, "Lua error: %s", err ? err : "unknown");
@@ -206,6 +265,8 @@ bool LuaEngine::execute(const char* code) {
 
 bool LuaEngine::call(const char* func) {
     if (!m_lua) return false;
+    TRACE_SCOPE("lua.call");
+    MEM_SCOPE(Lua);
     
     lua_getglobal(m_lua, func);
     if (!lua_isfunction(m_lua, -1)) {
@@ -233,6 +294,10 @@ void LuaEngine::shutdown() {
     LOG_I(Log::LUA, "shutdown()");
     
     if (m_lua) {
+        // <list> sources pin Lua values; drop them before the VM goes away
+        UI::List::detachSources();
+        LuaTimer::clearAll();
+        LuaFetch::clearAll();
         lua_close(m_lua);
         m_lua = nullptr;
     }
@@ -240,6 +305,16 @@ void LuaEngine::shutdown() {
     s_instance = nullptr;
 }
 
+void LuaEngine::suspend() {
+    LuaTimer::pauseAll();
+    LuaFetch::pauseAll();
+}
+
+void LuaEngine::resume() {
+    LuaTimer::resumeAll();
+    LuaFetch::resumeAll();
+}
+
 // ============ Config table ============
 
 void LuaEngine::createConfigTable() {
@@ -261,6 +336,9 @@ void LuaEngine::setConfig(const char* key, const char* value) {
 // ============ State overrides: base + Lua table sync ============
 
 void LuaEngine::syncLuaState(const char* key) {
+    // Collections are read live through their proxy; elements have no mirror
+    auto* var = State::store().getVar(key);
+    if (strchr(key, '[') || (var && var->isCollection())) return;
     if (m_lua) {
         lua_getglobal(m_lua, "_state_data");
         pushTypedValue(m_lua, key);
@@ -309,12 +387,68 @@ void LuaEngine::pushTypedValue(lua_State* L, const char* key) {
         case VarType::Float:
             lua_pushnumber(L, store.getFloat(key));
             break;
+        case VarType::Array:
+        case VarType::Map:
+            pushCollectionProxy(L, key);
+            break;
         default:
             lua_pushstring(L, store.getString(key).c_str());
             break;
     }
 }
 
+// Lua value at valueIdx -> StateStore + notify UI
+void LuaEngine::storeLuaValue(lua_State* L, const char* key, int valueIdx) {
+    P::String valueStr;
+    int vtype = lua_type(L, valueIdx);
+    
+    switch (vtype) {
+        case LUA_TBOOLEAN:
+            valueStr = lua_toboolean(L, valueIdx) ? "true" : "false";
+            break;
+        case LUA_TNUMBER:
+            if (lua_isinteger(L, valueIdx)) {
+                valueStr = std::to_string(lua_tointeger(L, valueIdx));
+            } else {
+                valueStr = std::to_string(lua_tonumber(L, valueIdx));
+            }
+            break;
+        case LUA_TSTRING:
+            valueStr = lua_tostring(L, valueIdx);
+            break;
+        default:
+            valueStr = "";
+            break;
+    }
+    
+    LOG_V(Log::LUA, "state.%s = '%s' (type=%d)", key, valueStr.c_str(), vtype);
+    
+    if (!s_instance) return;
+    
+    auto& store = State::store();
+    VarType type = store.getType(key);
+    
+    switch (vtype) {
+        case LUA_TBOOLEAN:
+            store.setBool(key, lua_toboolean(L, valueIdx), false);
+            break;
+        case LUA_TNUMBER:
+            if (type == VarType::Float || !lua_isinteger(L, valueIdx)) {
+                store.setFloat(key, static_cast<float>(lua_tonumber(L, valueIdx)), false);
+            } else {
+                store.setInt(key, static_cast<int>(lua_tointeger(L, valueIdx)), false);
+            }
+            break;
+        default:
+            store.setString(key, valueStr, false);
+            break;
+    }
+    
+    if (s_instance->m_stateCallback) {
+        s_instance->m_stateCallback(key, valueStr.c_str());
+    }
+}
+
 void LuaEngine::createStateTable() {
     lua_newtable(m_lua);
     lua_setglobal(m_lua, "_state_data");
@@ -334,86 +468,144 @@ void LuaEngine::createStateTable() {
 
 int LuaEngine::lua_state_index(lua_State* L) {
     const char* key = luaL_checkstring(L, 2);
-    
-    auto& store = State::store();
-    VarType type = store.getType(key);
-    
-    switch (type) {
-        case VarType::Bool:
-            lua_pushboolean(L, store.getBool(key) ? 1 : 0);
-            break;
-        case VarType::Int:
-            lua_pushinteger(L, store.getInt(key));
-            break;
-        case VarType::Float:
-            lua_pushnumber(L, store.getFloat(key));
-            break;
-        default:
-            lua_pushstring(L, store.getString(key).c_str());
-            break;
-    }
-    
+    pushTypedValue(L, key);
     return 1;
 }
 
 int LuaEngine::lua_state_newindex(lua_State* L) {
     const char* key = luaL_checkstring(L, 2);
     
-    P::String valueStr;
-    int vtype = lua_type(L, 3);
-    
-    switch (vtype) {
-        case LUA_TBOOLEAN:
-            valueStr = lua_toboolean(L, 3) ? "true" : "false";
-            break;
-        case LUA_TNUMBER:
-            if (lua_isinteger(L, 3)) {
-                valueStr = std::to_string(lua_tointeger(L, 3));
-            } else {
-                valueStr = std::to_string(lua_tonumber(L, 3));
-            }
-            break;
-        case LUA_TSTRING:
-            valueStr = lua_tostring(L, 3);
-            break;
-        default:
-            valueStr = "";
-            break;
+    auto* var = State::store().getVar(key);
+    if (var && var->isCollection()) {
+        LOG_W(Log::LUA, "state.%s is %s, assign elements: state.%s[i] = v",
+              key, Store::typeToString(var->type), key);
+        return 0;
     }
     
-    LOG_V(Log::LUA, "state.%s = '%s' (type=%d)", key, valueStr.c_str(), vtype);
-    
     // Update Lua _state_data table
     lua_getglobal(L, "_state_data");
     lua_pushvalue(L, 3);
     lua_setfield(L, -2, key);
     lua_pop(L, 1);
     
-    // Update StateStore + notify UI
-    if (s_instance) {
-        auto& store = State::store();
-        VarType type = store.getType(key);
-        
-        switch (vtype) {
-            case LUA_TBOOLEAN:
-                store.setBool(key, lua_toboolean(L, 3), false);
-                break;
-            case LUA_TNUMBER:
-                if (type == VarType::Float || !lua_isinteger(L, 3)) {
-                    store.setFloat(key, static_cast<float>(lua_tonumber(L, 3)), false);
-                } else {
-                    store.setInt(key, static_cast<int>(lua_tointeger(L, 3)), false);
-                }
-                break;
-            default:
-                store.setString(key, valueStr, false);
-                break;
-        }
-        
-        if (s_instance->m_stateCallback) {
-            s_instance->m_stateCallback(key, valueStr.c_str());
-        }
+    storeLuaValue(L, key, 3);
+    return 0;
+}
+
+// ============ Collection proxies ============
+// Lua indices are 1-based like any Lua array, so ipairs/# work:
+// state.cells[1] <-> {cells[0]}. Map keys are the markup keys.
+
+void LuaEngine::pushCollectionProxy(lua_State* L, const char* name) {
+    // One proxy per collection, cached in _state_data
+    lua_getglobal(L, "_state_data");
+    if (lua_getfield(L, -1, name) == LUA_TTABLE) {
+        lua_remove(L, -2);
+        return;
     }
+    lua_pop(L, 1);
+    
+    lua_newtable(L);
+    lua_newtable(L);
+    
+    lua_pushstring(L, name);
+    lua_pushcclosure(L, lua_elem_index, 1);
+    lua_setfield(L, -2, "__index");
     
+    lua_pushstring(L, name);
+    lua_pushcclosure(L, lua_elem_newindex, 1);
+    lua_setfield(L, -2, "__newindex");
+    
+    lua_pushstring(L, name);
+    lua_pushcclosure(L, lua_elem_len, 1);
+    lua_setfield(L, -2, "__len");
+    
+    lua_pushstring(L, name);
+    lua_pushcclosure(L, lua_elem_pairs, 1);
+    lua_setfield(L, -2, "__pairs");
+    
+    lua_setmetatable(L, -2);
+    
+    lua_pushvalue(L, -1);
+    lua_setfield(L, -3, name);
+    lua_remove(L, -2);
+}
+
+// Element path for the key at index 2; false if it can't be an element
+// (array index < 1, fractional number). 3.0 is the same key as 3.
+static bool elemPath(lua_State* L, P::String& path) {
+    const char* name = lua_tostring(L, lua_upvalueindex(1));
+    if (lua_type(L, 2) == LUA_TNUMBER) {
+        int isInt = 0;
+        lua_Integer i = lua_tointegerx(L, 2, &isInt);
+        if (!isInt) return false;
+        auto* var = State::store().getVar(name);
+        if (var && var->type == VarType::Array) {
+            if (i < 1) return false;
+            path = Store::elementPath(name, (size_t)(i - 1));
+        } else {
+            char buf[24];
+            snprintf(buf, sizeof(buf), LUA_INTEGER_FMT, i);
+            path = Store::elementPath(name, P::String(buf));
+        }
+        return true;
+    }
+    path = Store::elementPath(name, P::String(luaL_checkstring(L, 2)));
+    return true;
+}
+
+int LuaEngine::lua_elem_index(lua_State* L) {
+    P::String path;
+    // Missing map key / out-of-range index -> nil (lets `if t[k] then` work)
+    if (!elemPath(L, path) || !State::store().has(path)) {
+        lua_pushnil(L);
+        return 1;
+    }
+    pushTypedValue(L, path.c_str());
+    return 1;
+}
+
+int LuaEngine::lua_elem_newindex(lua_State* L) {
+    P::String path;
+    if (!elemPath(L, path)) {
+        return luaL_error(L, "state.%s: bad index %s", lua_tostring(L, lua_upvalueindex(1)),
+                          luaL_tolstring(L, 2, nullptr));
+    }
+    storeLuaValue(L, path.c_str(), 3);
     return 0;
 }
+
+// pairs(state.cells) -> 1..n, pairs(state.prices) -> key, value in key order
+int LuaEngine::lua_elem_pairs(lua_State* L) {
+    lua_pushvalue(L, lua_upvalueindex(1));
+    lua_pushinteger(L, 0);                      // next position
+    lua_pushcclosure(L, lua_elem_next, 2);
+    lua_pushvalue(L, 1);
+    lua_pushnil(L);
+    return 3;
+}
+
+int LuaEngine::lua_elem_next(lua_State* L) {
+    const char* name = lua_tostring(L, lua_upvalueindex(1));
+    lua_Integer pos = lua_tointeger(L, lua_upvalueindex(2));
+    auto* var = State::store().getVar(name);
+    if (!var || !var->isCollection() || pos >= (lua_Integer)var->items.size()) return 0;
+    lua_pushinteger(L, pos + 1);
+    lua_replace(L, lua_upvalueindex(2));
+    
+    P::String path;
+    if (var->type == VarType::Map) {
+        lua_pushstring(L, var->keys[pos].c_str());
+        path = Store::elementPath(name, var->keys[pos]);
+    } else {
+        lua_pushinteger(L, pos + 1);
+        path = Store::elementPath(name, (size_t)pos);
+    }
+    pushTypedValue(L, path.c_str());
+    return 2;
+}
+
+int LuaEngine::lua_elem_len(lua_State* L) {
+    lua_pushinteger(L, (lua_Integer)State::store().sizeOf(lua_tostring(L, lua_upvalueindex(1))));
+    return 1;
+}
@@ -18,7 +18,7 @@ extern "C" {
 class LuaEngine : public BaseScriptEngine {
 private:
     static constexpr const char* TAG = "LuaEngine";
-    static constexpr const char* VERSION = "1.5.0";
+    static constexpr const char* VERSION = "1.8.0";
     
     lua_State* m_lua = nullptr;
     static LuaEngine* s_instance;
@@ -29,6 +29,8 @@ public:
     bool call(const char* func) override;
     const char* name() const override;
     void shutdown() override;
+    void suspend() override;
+    void resume() override;
     
     // Overrides: sync Lua VM tables after base setState
     void setState(const char* key, const char* value) override;
@@ -38,13 +40,30 @@ public:
     void setConfig(const char* key, const char* value) override;
     
     lua_State* getLuaState() { return m_lua; }
+    
+    /// Compile `code` in a throwaway state, return bytecode ("" on error).
+    /// Used by speculative app preload before the engine exists.
+    static P::String compile(const char* code);
+    
+    /// Next execute() of exactly this source runs the bytecode instead
+    static void setPrecompiled(const char* code, P::String bytecode);
 
 private:
     void createStateTable();
     void createConfigTable();
-    void pushTypedValue(lua_State* L, const char* key);
+    static void pushTypedValue(lua_State* L, const char* key);
     void syncLuaState(const char* key);
     
+    static void storeLuaValue(lua_State* L, const char* key, int valueIdx);
+    static void pushCollectionProxy(lua_State* L, const char* name);
+    
     static int lua_state_index(lua_State* L);
     static int lua_state_newindex(lua_State* L);
+    
+    // state.cells[1] / state.prices.apple — element proxies for <array>/<map>
+    static int lua_elem_index(lua_State* L);
+    static int lua_elem_newindex(lua_State* L);
+    static int lua_elem_len(lua_State* L);
+    static int lua_elem_pairs(lua_State* L);
+    static int lua_elem_next(lua_State* L);
 };
@@ -1,5 +1,7 @@
 #include "engines/lua/lua_fetch.h"
 #include "utils/log_config.h"
+#include "utils/trace.h"
+#include "utils/mem_tags.h"
 #include "ble/ble_bridge.h"
 
 
@@ -12,6 +14,18 @@ static const char* VERSION = "3.0.0";
 
 static lua_State* g_luaState = nullptr;
 
+// Replies that arrive while the app is suspended wait for resumeAll()
+struct Reply {
+    lua_State* L;
+    int ref;
+    bool json;
+    int status;
+    P::String body;
+};
+static P::Array<Reply> s_held;
+static bool s_paused = false;
+static uint32_t s_gen = 0;   // bumped by clearAll(): callbacks of a closed VM are dropped
+
 // Helper: push ArduinoJson value to Lua stack
 static void pushJsonToLua(lua_State* L, JsonVariantConst v) {
     if (v.isNull()) {
@@ -46,6 +60,42 @@ static void pushJsonToLua(lua_State* L, JsonVariantConst v) {
     }
 }
 
+// Call the Lua callback with {status, body, ok} and release its ref
+static void deliver(lua_State* L, int ref, bool parseAsJson, int status, const P::String& respBody) {
+    LOG_D(Log::LUA, "fetch callback: status=%d body=%d bytes", status, (int)respBody.length());
+    
+    lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+    lua_newtable(L);
+    
+    lua_pushinteger(L, status);
+    lua_setfield(L, -2, "status");
+    
+    if (parseAsJson && !respBody.empty()) {
+        auto doc = PsramJsonDoc();
+        DeserializationError err = deserializeJson(doc, respBody);
+        if (err) {
+            lua_pushstring(L, respBody.c_str());
+        } else {
+            pushJsonToLua(L, doc.as<JsonVariantConst>());
+        }
+    } else {
+        lua_pushstring(L, respBody.c_str());
+    }
+    lua_setfield(L, -2, "body");
+    
+    lua_pushboolean(L, status >= 200 && status < 300);
+    lua_setfield(L, -2, "ok");
+    
+    TRACE_SCOPE("lua.fetch");
+    MEM_SCOPE(Lua);
+    if (lua_pcall(L, 1, 0, 0) != LUA_OK) {
+        LOG_E(Log::LUA, "fetch callback error: %s", lua_tostring(L, -1));
+        lua_pop(L, 1);
+    }
+    
+    luaL_unref(L, LUA_REGISTRYINDEX, ref);
+}
+
 static int lua_fetch(lua_State* L) {
     const char* method = "GET";
     const char* url = nullptr;
@@ -128,41 +178,21 @@ static int lua_fetch(lua_State* L) {
     int capturedRef = callbackRef;
     lua_State* capturedL = L;
     bool parseAsJson = (format && strcmp(format, "json") == 0);
+    uint32_t gen = s_gen;
     
     BLEBridge::sendFetchRequest(method, url, body, authorize, format, fields,
-        [capturedRef, capturedL, parseAsJson](int status, const P::String& respBody) {
+        [capturedRef, capturedL, parseAsJson, gen](int status, const P::String& respBody) {
             if (capturedRef == LUA_NOREF) return;
-            
-            LOG_D(Log::LUA, "fetch callback: status=%d body=%d bytes", status, (int)respBody.length());
-            
-            lua_rawgeti(capturedL, LUA_REGISTRYINDEX, capturedRef);
-            lua_newtable(capturedL);
-            
-            lua_pushinteger(capturedL, status);
-            lua_setfield(capturedL, -2, "status");
-            
-            if (parseAsJson && !respBody.empty()) {
-                auto doc = PsramJsonDoc();
-                DeserializationError err = deserializeJson(doc, respBody);
-                if (err) {
-                    lua_pushstring(capturedL, respBody.c_str());
-                } else {
-                    pushJsonToLua(capturedL, doc.as<JsonVariantConst>());
-                }
-            } else {
-                lua_pushstring(capturedL, respBody.c_str());
+            // VM closed since the request went out: its registry is gone with it
+            if (gen != s_gen) {
+                LOG_D(Log::LUA, "fetch callback dropped: engine closed");
+                return;
             }
-            lua_setfield(capturedL, -2, "body");
-            
-            lua_pushboolean(capturedL, status >= 200 && status < 300);
-            lua_setfield(capturedL, -2, "ok");
-            
-            if (lua_pcall(capturedL, 1, 0, 0) != LUA_OK) {
-                LOG_E(Log::LUA, "fetch callback error: %s", lua_tostring(capturedL, -1));
-                lua_pop(capturedL, 1);
+            if (s_paused) {
+                s_held.push_back({capturedL, capturedRef, parseAsJson, status, respBody});
+                return;
             }
-            
-            luaL_unref(capturedL, LUA_REGISTRYINDEX, capturedRef);
+            deliver(capturedL, capturedRef, parseAsJson, status, respBody);
         }
     );
     
@@ -194,4 +224,32 @@ void registerAll(lua_State* L) {
     LOG_I(Log::LUA, "LuaFetch v%s registered: net.* + fetch()", VERSION);
 }
 
+void pauseAll() {
+    s_paused = true;
+}
+
+void resumeAll() {
+    s_paused = false;
+    // A callback may start new fetches: take the list first
+    P::Array<Reply> held = std::move(s_held);
+    s_held.clear();
+    uint32_t gen = s_gen;
+    for (auto& r : held) {
+        if (gen != s_gen || s_paused) {
+            // Closed or suspended again from inside a callback
+            if (gen == s_gen) s_held.push_back(std::move(r));
+            continue;
+        }
+        deliver(r.L, r.ref, r.json, r.status, r.body);
+    }
+}
+
+void clearAll() {
+    for (auto& r : s_held) luaL_unref(r.L, LUA_REGISTRYINDEX, r.ref);
+    s_held.clear();
+    s_paused = false;
+    s_gen++;
+    g_luaState = nullptr;
+}
+
 } // namespace LuaFetch
@@ -15,4 +15,11 @@ namespace LuaFetch {
 
 void registerAll(lua_State* L);
 
+/// App suspend/resume: replies received while paused are held, then delivered in order
+void pauseAll();
+void resumeAll();
+
+/// VM shutdown: drop held replies; callbacks of requests still in flight become no-ops
+void clearAll();
+
 } // namespace LuaFetch
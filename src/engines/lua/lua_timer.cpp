@@ -1,13 +1,24 @@
 #include "engines/lua/lua_timer.h"
 #include "core/call_queue.h"
 #include "utils/log_config.h"
+#include "utils/trace.h"
+#include "utils/mem_tags.h"
 #include "lvgl.h"
+#include <algorithm>
 
 namespace LuaTimer {
 
 static const char* TAG = "LuaTimer";
 static lua_State* g_luaState = nullptr;
 
+// Timers created from Lua (pause/resume with the app, delete with the VM)
+static P::Array<lv_timer_t*> s_timers;
+
+static void forget(lv_timer_t* timer) {
+    auto it = std::find(s_timers.begin(), s_timers.end(), timer);
+    if (it != s_timers.end()) s_timers.erase(it);
+}
+
 // Timer callback data — supports both string name and function ref
 struct TimerData {
     P::String funcName;    // non-empty if callback is a string
@@ -21,6 +32,8 @@ static void timer_callback(lv_timer_t* timer) {
     
     if (data->funcRef != LUA_NOREF && g_luaState) {
         // Function ref callback — call directly
+        TRACE_SCOPE("lua.timer");
+        MEM_SCOPE(Lua);
         lua_rawgeti(g_luaState, LUA_REGISTRYINDEX, data->funcRef);
         if (lua_pcall(g_luaState, 0, 0, 0) != LUA_OK) {
             LOG_E(Log::LUA, "timer callback error: %s", lua_tostring(g_luaState, -1));
@@ -36,6 +49,7 @@ static void timer_callback(lv_timer_t* timer) {
             luaL_unref(g_luaState, LUA_REGISTRYINDEX, data->funcRef);
         }
         delete data;
+        forget(timer);
         lv_timer_delete(timer);
     }
 }
@@ -73,6 +87,7 @@ static int lua_timer_once(lua_State* L) {
     
     lv_timer_t* timer = lv_timer_create(timer_callback, delayMs, data);
     lv_timer_set_repeat_count(timer, 1);
+    s_timers.push_back(timer);
     
     return 0;
 }
@@ -90,7 +105,7 @@ static int lua_timer_interval(lua_State* L) {
     LOG_D(Log::LUA, "timer.interval(%s, %d)", 
           data->funcName.empty() ? "<function>" : data->funcName.c_str(), intervalMs);
     
-    lv_timer_create(timer_callback, intervalMs, data);
+    s_timers.push_back(lv_timer_create(timer_callback, intervalMs, data));
     
     return 0;
 }
@@ -100,10 +115,8 @@ static int lua_timer_clear(lua_State* L) {
     const char* name = luaL_checkstring(L, 1);
     LOG_D(Log::LUA, "timer.clear('%s')", name);
     
-    // Walk LVGL timer list and remove matching
-    lv_timer_t* t = lv_timer_get_next(nullptr);
-    while (t) {
-        lv_timer_t* next = lv_timer_get_next(t);
+    for (size_t i = s_timers.size(); i-- > 0;) {
+        lv_timer_t* t = s_timers[i];
         TimerData* data = (TimerData*)lv_timer_get_user_data(t);
         if (data && data->funcName == name) {
             if (data->funcRef != LUA_NOREF && g_luaState) {
@@ -111,8 +124,8 @@ static int lua_timer_clear(lua_State* L) {
             }
             delete data;
             lv_timer_delete(t);
+            s_timers.erase(s_timers.begin() + i);
         }
-        t = next;
     }
     
     return 0;
@@ -147,4 +160,21 @@ void registerAll(lua_State* L) {
     LOG_I(Log::LUA, "Registered: timer.once/interval/clear + setTimeout()");
 }
 
+void pauseAll() {
+    for (auto* t : s_timers) lv_timer_pause(t);
+}
+
+void resumeAll() {
+    for (auto* t : s_timers) lv_timer_resume(t);
+}
+
+void clearAll() {
+    for (auto* t : s_timers) {
+        delete (TimerData*)lv_timer_get_user_data(t);
+        lv_timer_delete(t);
+    }
+    s_timers.clear();
+    g_luaState = nullptr;
+}
+
 } // namespace LuaTimer
@@ -19,4 +19,11 @@ namespace LuaTimer {
 /// Register timer.*, setTimeout(), getQueueStats() into Lua
 void registerAll(lua_State* L);
 
+/// App suspended/resumed (hot app cache)
+void pauseAll();
+void resumeAll();
+
+/// VM shutdown: delete all Lua timers (refs die with the VM)
+void clearAll();
+
 } // namespace LuaTimer
@@ -2,6 +2,10 @@
 #include "utils/log_config.h"
 #include "utils/psram_alloc.h"
 #include "ui/ui_engine.h"
+#include "ui/ui_list.h"
+#include "engines/lua/lua_csv.h"
+#include <cctype>
+#include <cstdlib>
 
 // Forward declarations - implemented in ui_engine.cpp
 namespace UI {
@@ -44,6 +48,118 @@ static int lua_getAttr(lua_State* L) {
     return 1;
 }
 
+// ============ <list> data sources ============
+// Rows are read on demand while scrolling; the Lua value is pinned in the registry.
+// Reads go through the main thread: ui.setList may run in a coroutine that
+// is collected long before the list is.
+
+static lua_State* mainThread(lua_State* L) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+    lua_State* main = lua_tothread(L, -1);
+    lua_pop(L, 1);
+    return main;
+}
+
+// "" = whole item, "2" = 1-based column number
+static bool isColumnNumber(const P::String& name) {
+    return !name.empty() && isdigit((unsigned char)name[0]);
+}
+
+class LuaTableSource : public UI::ListSource {
+public:
+    LuaTableSource(lua_State* L, int ref) : m_L(L), m_ref(ref) {}
+    ~LuaTableSource() override { if (m_L) luaL_unref(m_L, LUA_REGISTRYINDEX, m_ref); }
+
+    size_t count() const override {
+        if (!m_L) return 0;
+        lua_rawgeti(m_L, LUA_REGISTRYINDEX, m_ref);
+        size_t n = lua_rawlen(m_L, -1);
+        lua_pop(m_L, 1);
+        return n;
+    }
+
+    P::String field(size_t row, const P::String& name) const override {
+        if (!m_L) return "";
+        lua_rawgeti(m_L, LUA_REGISTRYINDEX, m_ref);
+        lua_rawgeti(m_L, -1, (lua_Integer)row + 1);
+        if (lua_istable(m_L, -1) && !name.empty()) {
+            if (isColumnNumber(name)) lua_rawgeti(m_L, -1, atoi(name.c_str()));
+            else lua_getfield(m_L, -1, name.c_str());
+            lua_remove(m_L, -2);
+        }
+        P::String out;
+        if (lua_isboolean(m_L, -1)) out = lua_toboolean(m_L, -1) ? "true" : "false";
+        else if (const char* s = lua_tostring(m_L, -1)) out = s;
+        lua_pop(m_L, 2);
+        return out;
+    }
+
+    void detach() override { m_L = nullptr; }
+
+private:
+    lua_State* m_L;
+    int m_ref;
+};
+
+class CSVSource : public UI::ListSource {
+public:
+    CSVSource(lua_State* L, int ref, LuaCSV::CSVObject* csv) : m_L(L), m_ref(ref), m_csv(csv) {}
+    ~CSVSource() override { if (m_L) luaL_unref(m_L, LUA_REGISTRYINDEX, m_ref); }
+
+    size_t count() const override { return m_L ? LuaCSV::rowCount(m_csv) : 0; }
+
+    P::String field(size_t row, const P::String& name) const override {
+        if (!m_L) return "";
+        if (name.empty()) return LuaCSV::rowText(m_csv, row);
+        if (isColumnNumber(name)) return LuaCSV::field(m_csv, row, atoi(name.c_str()) - 1);
+        
+        auto it = m_cols.find(name);
+        if (it == m_cols.end()) it = m_cols.emplace(name, LuaCSV::columnIndex(m_csv, name.c_str())).first;
+        return it->second >= 0 ? LuaCSV::field(m_csv, row, it->second) : "";
+    }
+
+    void detach() override { m_L = nullptr; }
+
+private:
+    lua_State* m_L;
+    int m_ref;
+    LuaCSV::CSVObject* m_csv;
+    mutable P::Map<P::String, int> m_cols;
+};
+
+static int lua_setList(lua_State* L) {
+    const char* id = luaL_checkstring(L, 1);
+    
+    P::Ptr<UI::ListSource> source;
+    if (auto* csv = LuaCSV::toCSV(L, 2)) {
+        lua_pushvalue(L, 2);
+        int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+        source = P::Ptr<UI::ListSource>(P::create<CSVSource>(mainThread(L), ref, csv).release());
+    } else {
+        luaL_checktype(L, 2, LUA_TTABLE);
+        lua_pushvalue(L, 2);
+        int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+        source = P::Ptr<UI::ListSource>(P::create<LuaTableSource>(mainThread(L), ref).release());
+    }
+    
+    bool ok = UI::List::setSource(id, std::move(source));
+    lua_pushboolean(L, ok ? 1 : 0);
+    return 1;
+}
+
+static int lua_refreshList(lua_State* L) {
+    const char* id = luaL_checkstring(L, 1);
+    lua_pushboolean(L, UI::List::refresh(id) ? 1 : 0);
+    return 1;
+}
+
+static int lua_scrollList(lua_State* L) {
+    const char* id = luaL_checkstring(L, 1);
+    int row = (int)luaL_checkinteger(L, 2);
+    lua_pushboolean(L, UI::List::scrollTo(id, row) ? 1 : 0);
+    return 1;
+}
+
 static int lua_freeze(lua_State* L) {
     return 0;
 }
@@ -59,6 +175,9 @@ static const luaL_Reg ui_lib[] = {
     {"focus",    lua_focus},
     {"freeze",   lua_freeze},
     {"unfreeze", lua_unfreeze},
+    {"setList",     lua_setList},
+    {"refreshList", lua_refreshList},
+    {"scrollList",  lua_scrollList},
     {nullptr, nullptr}
 };
 
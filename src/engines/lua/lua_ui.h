@@ -12,6 +12,9 @@ extern "C" {
  *   ui.getAttr(id, attr)
  *   ui.focus(id)
  *   ui.freeze() / ui.unfreeze()
+ *   ui.setList(id, table|csv)  — data source of <list>
+ *   ui.refreshList(id)         — re-read after in-place changes
+ *   ui.scrollList(id, row)
  */
 
 namespace LuaUI {
@@ -110,11 +110,11 @@ static int yaml_load(lua_State* L) {
 
     size_t sz = file.size();
     std::string text(sz, '\0');
-    file.readBytes(&text[0], sz);
+    text.resize(file.readBytes(&text[0], sz));
     file.close();
 
-    // Parse YAML → Lua table
-    int ok = YamlParser::parseToLua(L, text.c_str());
+    // Parse YAML → Lua table (strings go from the buffer straight to Lua)
+    int ok = YamlParser::parseToLua(L, text.data(), text.size());
     if (!ok) {
         return 2; // nil, error already on stack
     }
@@ -136,9 +136,10 @@ static int yaml_load(lua_State* L) {
 // ─── YAML.loadText(text) ───────────────────────────────
 
 static int yaml_loadText(lua_State* L) {
-    const char* text = luaL_checkstring(L, 1);
+    size_t len = 0;
+    const char* text = luaL_checklstring(L, 1, &len);
 
-    int ok = YamlParser::parseToLua(L, text);
+    int ok = YamlParser::parseToLua(L, text, len);
     if (!ok) {
         return 2;
     }
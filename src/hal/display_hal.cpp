@@ -20,6 +20,8 @@ static int               s_bufLines  = 0;
 static int               s_bootLines = 0;      // max achieved at boot (fragmentation ceiling)
 static lv_display_t*     s_display   = nullptr;
 static SemaphoreHandle_t s_mutex     = nullptr;
+static lv_display_flush_cb_t s_panelFlush = nullptr;   // Device flush callback
+static display_flush_tap_t   s_flushTap   = nullptr;
 
 // ============================================
 // display_init
@@ -92,7 +94,8 @@ bool display_init() {
     // 7. Create LVGL display — flush callback from Device (raw function pointer)
     s_display = lv_display_create(SCREEN_WIDTH, SCREEN_HEIGHT);
     lv_display_set_color_format(s_display, LV_COLOR_FORMAT_RGB565);
-    lv_display_set_flush_cb(s_display, dev.getFlushCallback());
+    s_panelFlush = dev.getFlushCallback();
+    lv_display_set_flush_cb(s_display, s_panelFlush);
     lv_display_set_buffers(s_display, s_buf, nullptr, s_bufSize, LV_DISPLAY_RENDER_MODE_PARTIAL);
 
     // 8. Create LVGL input device — touch callback from Device (raw function pointer)
@@ -129,6 +132,21 @@ void* display_get_framebuffer() {
     return nullptr;
 }
 
+// ============================================
+// Flush tap (screen mirroring)
+// ============================================
+static void flushTapped(lv_display_t* disp, const lv_area_t* area, uint8_t* px) {
+    s_flushTap(area, px);
+    s_panelFlush(disp, area, px);
+}
+
+void display_set_flush_tap(display_flush_tap_t tap) {
+    if (!s_display) return;
+    s_flushTap = tap;
+    // Swap the callback itself: no extra call per flush while not mirroring
+    lv_display_set_flush_cb(s_display, tap ? flushTapped : s_panelFlush);
+}
+
 void display_set_brightness(uint8_t level) {
     Device::inst().setBrightness(level);
 }
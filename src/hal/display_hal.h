@@ -32,6 +32,11 @@ void display_unlock();
 // Framebuffer access (for screenshots; may return nullptr)
 void* display_get_framebuffer();
 
+// Flush tap (screen mirroring): sees every flushed area (RGB565) before
+// the panel does. nullptr restores the plain Device flush callback.
+typedef void (*display_flush_tap_t)(const lv_area_t* area, const uint8_t* px);
+void display_set_flush_tap(display_flush_tap_t tap);
+
 // Brightness control (0=off, 255=max)
 void display_set_brightness(uint8_t level);
 
@@ -0,0 +1,139 @@
+#include "hal/render_stats.h"
+#include "utils/log_config.h"
+#include <esp_timer.h>
+#include <cstring>
+
+static const char* TAG = "RenderStats";
+
+namespace RenderStats {
+
+static bool     s_enabled = false;
+static int64_t  s_startUs = 0;
+static int64_t  s_frameStart = 0;
+static int64_t  s_flushStart = 0;
+static uint32_t s_framePixels = 0;
+static uint32_t s_frames = 0;
+static uint32_t s_flushes = 0;
+
+static Histogram s_frameUs(1000);       // 1 ms .. 1 s
+static Histogram s_flushUs(250);        // 0.25 ms .. 256 ms
+static Histogram s_pixels(1024);        // 1K .. 1M px
+static Histogram s_handlerUs(1000);
+
+// ---- Histogram ----
+
+void Histogram::add(uint32_t v) {
+    int i = 0;
+    for (uint32_t edge = base; v >= edge && i < BUCKETS - 1; edge <<= 1) i++;
+    buckets[i]++;
+    count++;
+    sum += v;
+    if (v > max) max = v;
+}
+
+uint32_t Histogram::percentile(uint32_t pct) const {
+    if (!count) return 0;
+    uint64_t want = ((uint64_t)count * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS - 1; i++) {
+        seen += buckets[i];
+        if (seen >= want) return base << i;
+    }
+    return max;
+}
+
+void Histogram::clear() {
+    count = 0;
+    sum = 0;
+    max = 0;
+    memset(buckets, 0, sizeof(buckets));
+}
+
+// ---- LVGL display events ----
+
+static void onEvent(lv_event_t* e) {
+    int64_t now = esp_timer_get_time();
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_REFR_START:
+            s_frameStart = now;
+            s_framePixels = 0;
+            break;
+        case LV_EVENT_FLUSH_START: {
+            const lv_area_t* a = (const lv_area_t*)lv_event_get_param(e);
+            if (a) s_framePixels += lv_area_get_size(a);
+            s_flushStart = now;
+            break;
+        }
+        case LV_EVENT_FLUSH_FINISH:
+            s_flushUs.add((uint32_t)(now - s_flushStart));
+            s_flushes++;
+            break;
+        case LV_EVENT_REFR_READY:
+            // Refresh timer also runs when nothing is invalid: not a frame
+            if (s_framePixels && s_frameStart) {
+                s_frameUs.add((uint32_t)(now - s_frameStart));
+                s_pixels.add(s_framePixels);
+                s_frames++;
+            }
+            s_frameStart = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+// ---- API ----
+
+void enable(bool on) {
+    lv_display_t* disp = lv_display_get_default();
+    if (!disp || on == s_enabled) return;
+
+    if (on) {
+        reset();
+        lv_display_add_event_cb(disp, onEvent, LV_EVENT_ALL, nullptr);
+    } else {
+        lv_display_remove_event_cb_with_user_data(disp, onEvent, nullptr);
+    }
+    s_enabled = on;
+    LOG_I(Log::UI, "Render stats %s", on ? "on" : "off");
+}
+
+bool enabled() {
+    return s_enabled;
+}
+
+void reset() {
+    s_frameUs.clear();
+    s_flushUs.clear();
+    s_pixels.clear();
+    s_handlerUs.clear();
+    s_frames = 0;
+    s_flushes = 0;
+    s_frameStart = 0;
+    s_startUs = esp_timer_get_time();
+}
+
+Report report() {
+    return {
+        s_enabled,
+        (uint32_t)((esp_timer_get_time() - s_startUs) / 1000),
+        s_frames,
+        s_flushes,
+        &s_frameUs,
+        &s_flushUs,
+        &s_pixels,
+        &s_handlerUs,
+    };
+}
+
+void timerHandler() {
+    if (!s_enabled) {
+        lv_timer_handler();
+        return;
+    }
+    int64_t t0 = esp_timer_get_time();
+    lv_timer_handler();
+    s_handlerUs.add((uint32_t)(esp_timer_get_time() - t0));
+}
+
+} // namespace RenderStats
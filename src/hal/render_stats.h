@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <lvgl.h>
+
+/**
+ * RenderStats — per-frame LVGL refresh statistics ("perf" console command)
+ *
+ * Independent of LV_USE_SYSMON / LV_USE_PERF_MONITOR / LV_USE_PROFILER:
+ * while enabled, one display event callback watches REFR_START/READY and
+ * FLUSH_START/FINISH, and the main loop times lv_timer_handler(). Disabled,
+ * the callback is not registered at all and timerHandler() is a plain call.
+ *
+ * Histograms use log2 buckets: bucket 0 < base, bucket i in
+ * [base * 2^(i-1), base * 2^i), the last one is open-ended.
+ */
+namespace RenderStats {
+
+static constexpr int BUCKETS = 12;
+
+struct Histogram {
+    uint32_t base;              // upper bound of bucket 0
+    uint32_t count = 0;
+    uint64_t sum = 0;
+    uint32_t max = 0;
+    uint32_t buckets[BUCKETS] = {};
+
+    explicit Histogram(uint32_t b) : base(b) {}
+    void add(uint32_t v);
+    uint32_t percentile(uint32_t pct) const;   // bucket upper bound
+    void clear();
+};
+
+struct Report {
+    bool enabled;
+    uint32_t ms;                // since enable/reset
+    uint32_t frames;            // refreshes that drew something
+    uint32_t flushes;
+    const Histogram* frameUs;   // REFR_START..REFR_READY (render + flush)
+    const Histogram* flushUs;   // one flush_cb call
+    const Histogram* pixels;    // pixels flushed per frame
+    const Histogram* handlerUs; // whole lv_timer_handler()
+};
+
+void enable(bool on);
+bool enabled();
+void reset();
+Report report();
+
+/// lv_timer_handler(), timed while stats are on
+void timerHandler();
+
+} // namespace RenderStats
@@ -7,14 +7,20 @@
 #include <lvgl.h>
 #include "esp_heap_caps.h"
 #include "hal/display_hal.h"
+#include "hal/render_stats.h"
 #include "core/app_manager.h"
 #include "core/state_store.h"
 #include "ui/ui_task.h"
 #include "ui/ui_engine.h"
 #include "utils/task_queue.h"
+#include "utils/log_config.h"
+#include "utils/mirror.h"
+#include "utils/trace.h"
 #include "console/console.h"
 #include "console/serial_transport.h"
 #include "core/call_queue.h"
+#include "core/persist.h"
+#include "engines/lua/lua_csv.h"
 #include "ble/ble_bridge.h"
 #include "ble/bin_transfer.h"
 #include "ble/bin_receive.h"
@@ -92,17 +98,47 @@ void setup() {
 }
 
 void loop() {
+    TRACE_SPAN(loopSpan, "loop");
+    
     // Serial commands via SerialTransport
     static char cmdBuf[256];
     static int cmdPos = 0;
     static int cmdId = 0;
+    static bool skipLf = false;  // "file write" line ended in CR: its LF may still be in flight
     while (Serial.available()) {
+        // "file write": the window's raw bytes follow the command line
+        if (uint32_t want = BinReceive::serialPending()) {
+            if (skipLf) {
+                skipLf = false;
+                if (Serial.peek() == '\n') {
+                    Serial.read();
+                    continue;
+                }
+            }
+            uint8_t raw[256];
+            size_t n = Serial.available();
+            if (n > want) n = want;
+            if (n > sizeof(raw)) n = sizeof(raw);
+            n = Serial.readBytes(raw, n);
+            BinReceive::onData(raw, n);
+            continue;
+        }
+        skipLf = false;  // window already closed (done or timed out)
         char c = Serial.read();
         if (c == '\n' || c == '\r') {
             if (cmdPos > 0) {
+                TRACE_SCOPE("console");
                 cmdBuf[cmdPos] = '\0';
+                // Only a window this command opened takes the following bytes
+                // (not one a BLE client has open)
+                uint32_t window = BinReceive::fileWindow();
                 auto result = Console::exec(cmdBuf);
                 Console::SerialTransport::instance().sendResult(++cmdId, result);
+                uint32_t opened = BinReceive::fileWindow();
+                if (result.success && opened && opened != window) {
+                    skipLf = (c == '\r');
+                    BinReceive::attachSerial();
+                }
                 cmdPos = 0;
             }
         } else if (cmdPos < (int)sizeof(cmdBuf) - 1) {
@@ -119,27 +155,68 @@ void loop() {
         }
     }
     
-    CallQueue::process();
+    {
+        TRACE_SCOPE("CallQueue");
+        CallQueue::process();
+    }
     
     // Process BLE only if initialized
     if (BLEBridge::isInitialized()) {
+        TRACE_SCOPE("ble");
         BLEBridge::processBleQueue();
         
         // Send binary transfer chunks (screenshot, app pull, app list, etc.)
         if (BinTransfer::isInProgress()) {
             BinTransfer::sendNextChunk();
         }
-        
-        // Deferred save after BLE receive completes (LittleFS needs main loop stack)
+    }
+    
+    // Deferred save after BLE/Serial receive completes (LittleFS needs main loop stack)
+    {
+        TRACE_SCOPE("BinReceive");
         BinReceive::process();
     }
     
-    App::Manager::instance().processPendingLaunch();
+    {
+        TRACE_SCOPE("pendingLaunch");
+        App::Manager::instance().processPendingLaunch();
+    }
+    
+    // Debounced persist="true" writes (LittleFS needs main loop stack)
+    {
+        TRACE_SCOPE("Persist");
+        Persist::process();
+    }
+    
+    // Write-behind CSV journals (same stack constraint)
+    {
+        TRACE_SCOPE("csv");
+        LuaCSV::process();
+    }
     
     display_lock();
-    UI::processTasks();  // Process UI update tasks from state changes
-    lv_timer_handler();
+    {
+        TRACE_SCOPE("ui.tasks");
+        UI::processTasks();  // Process UI update tasks from state changes
+    }
+    {
+        TRACE_SCOPE("lv_timer_handler");
+        RenderStats::timerHandler();  // lv_timer_handler(), timed when "perf on"
+    }
     display_unlock();
     
+    // Deferred log records -> Serial, outside rendering
+    {
+        TRACE_SCOPE("log.drain");
+        Log::drain(32);
+    }
+    
+    // Screen mirror strips, paced by fps and Serial TX room
+    {
+        TRACE_SCOPE("mirror");
+        Mirror::process();
+    }
+    
+    TRACE_END(loopSpan);  // idle delay is not part of the frame
     delay(5);
 }
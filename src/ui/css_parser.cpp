@@ -20,6 +20,7 @@ int32_t parse_coord_h(const char* s);
 
 #include "widgets/widget_common.h"
 #include "utils/log_config.h"
+#include "utils/trace.h"
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
@@ -42,6 +43,7 @@ Css& Css::instance() {
 
 void Css::clear() {
     m_rules.clear();
+    m_matchCache.clear();
 }
 
 P::String Css::trim(std::string_view s) {
@@ -107,6 +109,7 @@ static P::Map<P::String, P::String> parseProperties(std::string_view block) {
 // ============ Parse CSS ============
 
 void Css::parse(std::string_view css) {
+    m_matchCache.clear();
     size_t pos = 0;
     while (pos < css.size()) {
         while (pos < css.size() && std::isspace(static_cast<unsigned char>(css[pos]))) pos++;
@@ -263,16 +266,40 @@ void Css::applyProps(Widget& w, const P::Map<P::String, P::String>& props) const
 
 // ============ Main cascade method ============
 
+const P::Array<uint16_t>& Css::resolve(const char* tag, const char* classNames) const {
+    P::String key = tag ? tag : "";
+    key += '|';
+    if (classNames) key += classNames;
+    
+    auto it = m_matchCache.find(key);
+    if (it != m_matchCache.end()) return it->second;
+    if (m_matchCache.size() >= MAX_MATCH_CACHE) m_matchCache.clear();
+    
+    // Specificity order: TAG(0) < CLASS(1) < TAG_CLASS(2); ID is per-widget
+    P::Array<uint16_t> list;
+    for (int spec = 0; spec <= 2; spec++) {
+        SelectorType st = static_cast<SelectorType>(spec);
+        for (size_t i = 0; i < m_rules.size(); i++) {
+            if (m_rules[i].type == st && matches(m_rules[i], tag, nullptr, classNames)) {
+                list.push_back((uint16_t)i);
+            }
+        }
+    }
+    return m_matchCache.emplace(std::move(key), std::move(list)).first->second;
+}
+
 void Css::applyMatching(Widget& w, const char* tag, const char* id, const char* classNames) const {
     if (!w.handle) return;
+    TRACE_SCOPE("css.apply");
 
     // Apply in specificity order: TAG(0) < CLASS(1) < TAG_CLASS(2) < ID(3)
-    for (int spec = 0; spec <= 3; spec++) {
-        SelectorType st = static_cast<SelectorType>(spec);
-        for (const auto& rule : m_rules) {
-            if (rule.type == st && matches(rule, tag, id, classNames)) {
-                applyProps(w, rule.properties);
-            }
+    for (uint16_t idx : resolve(tag, classNames)) {
+        applyProps(w, m_rules[idx].properties);
+    }
+    if (!id || !id[0]) return;
+    for (const auto& rule : m_rules) {
+        if (rule.type == SelectorType::ID && matches(rule, tag, id, classNames)) {
+            applyProps(w, rule.properties);
         }
     }
 }
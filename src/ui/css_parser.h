@@ -60,6 +60,14 @@ private:
     };
     
     P::Array<Rule> m_rules;
+    
+    // tag|classNames -> matching non-ID rule indices in cascade order.
+    // Widgets sharing tag+class (grids, <repeat>) resolve once. Class
+    // bindings make a key per distinct class string: cleared at the cap.
+    static constexpr size_t MAX_MATCH_CACHE = 64;
+    mutable P::Map<P::String, P::Array<uint16_t>> m_matchCache;
+    const P::Array<uint16_t>& resolve(const char* tag, const char* classNames) const;
+    
     static const P::Map<P::String, P::String> s_empty;
     static const P::String s_emptyStr;
     
@@ -11,6 +11,7 @@
 #include "core/state_store.h"
 #include "utils/string_utils.h"
 #include "utils/log_config.h"
+#include "utils/mem_tags.h"
 
 #include <cstdlib>
 #include <cstring>
@@ -69,9 +70,15 @@ void Engine::init() {
 }
 
 int Engine::render(const char* html) {
+    MEM_SCOPE(Ui);
     return ui_html_render_internal(html);
 }
 
+int Engine::render(const char* html, const ParsedElement& doc) {
+    MEM_SCOPE(Ui);
+    return ui_html_render_internal(html, &doc);
+}
+
 void Engine::clear() {
     s_focusedTextarea = nullptr;
     ui_clear_internal();
@@ -176,6 +183,14 @@ const char* Engine::stateVarDefault(int i) const {
     return buf;
 }
 
+const char* Engine::stateVarValue(int i) const {
+    static char buf[ATTR_VAL_LEN];
+    auto val = State::store().getAsString(State::store().nameAt(i));
+    strncpy(buf, val.c_str(), sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    return buf;
+}
+
 // ============ Handler setters ============
 
 void Engine::setOnClickHandler(OnClickHandler handler) {
@@ -20,6 +20,8 @@ typedef struct _lv_obj_t lv_obj_t;
 
 namespace UI {
 
+struct ParsedElement;
+
 // ============ DATA STRUCTURES ============
 // Timer, Style, Element определены в ui_types.h
 
@@ -69,6 +71,8 @@ public:
     // Lifecycle
     void init();
     int render(const char* html);
+    /// Same, with the document already parsed (speculative app preload)
+    int render(const char* html, const ParsedElement& doc);
     void clear();
     
     // Element access
@@ -91,6 +95,7 @@ public:
     const char* stateVarName(int i) const;
     const char* stateVarType(int i) const;
     const char* stateVarDefault(int i) const;
+    const char* stateVarValue(int i) const;
     
     // Handler types
     using OnClickHandler = void (*)(const char* func_name);
@@ -118,7 +123,7 @@ public:
     bool canvasRefresh(const char* id);
     
     // Version
-    static constexpr const char* version() { return "5.2.0"; }
+    static constexpr const char* version() { return "5.6.0"; }
     const char* appVersion() const;
     const char* appOsRequirement() const;
     const char* appIcon() const;
@@ -11,6 +11,7 @@
 #include "ui/ui_types.h"
 #include "ui/html_parser.h"
 #include "ui/css_parser.h"
+#include "ui/ui_list.h"
 #include "utils/string_utils.h"
 #include "ui/xml_utils.h"
 #include "utils/font.h"
@@ -24,9 +25,14 @@
 #include "widgets/widget_image.h"
 #include "widgets/widget_button.h"
 #include "core/state_store.h"
+#include "core/computed.h"
+#include "core/persist.h"
+#include "utils/task_queue.h"
 #include "hal/display_hal.h"
 #include "ble/ble_bridge.h"
 #include "utils/log_config.h"
+#include "utils/trace.h"
+#include "utils/mem_tags.h"
 #include "esp_heap_caps.h"
 #include "esp_system.h"
 #include <Arduino.h>
@@ -126,7 +132,32 @@ static void parse_vars_to_store(const UI::ParsedElement& section, Store& store)
             store.defineFloat(nameStr, var.getFloat("default"));
         } else if (var.is("string")) {
             store.defineString(nameStr, P::String(var.get("default")));
+        } else if (var.is("array")) {
+            // <array name="cells" type="string" size="32" default=""/>
+            VarType elemType = Store::stringToType(P::String(var.get("type", "string")).c_str());
+            int size = var.getInt("size");
+            if (size <= 0) {
+                LOG_W(Log::UI, "array %s: missing size", nameStr.c_str());
+                continue;
+            }
+            store.defineArray(nameStr, elemType, size, Store::fromString(elemType, P::String(var.get("default"))));
+        } else if (var.is("map")) {
+            // <map name="prices" type="int"><item key="apple" value="3"/></map>
+            VarType elemType = Store::stringToType(P::String(var.get("type", "string")).c_str());
+            store.defineMap(nameStr, elemType);
+            for (const auto& item : var.children) {
+                auto key = item.get("key");
+                if (key.empty()) continue;
+                store.setFromString(Store::elementPath(nameStr, P::String(key)), P::String(item.get("value")), false);
+            }
+            store.keepMapDefaults(nameStr);
+        } else if (var.is("computed")) {
+            // <computed name="total" expr="a + b * 2"/> - defined in State by Computed::finalize()
+            Computed::define(nameStr, P::String(var.get("expr")).c_str(), P::String(var.get("type")).c_str());
+            continue;
         }
+        
+        if (var.getBool("persist")) Persist::track(nameStr);
     }
 }
 
@@ -137,6 +168,8 @@ static void parse_state(const UI::ParsedElement& root) {
     
     LOG_D(Log::UI, "state:");
     parse_vars_to_store(*state, State::store());
+    Persist::open(app_path.c_str());
+    Computed::finalize();
 }
 
 // Parse <timer> tags
@@ -278,12 +311,14 @@ static void parse_system(const UI::ParsedElement& root) {
 }
 
 // Parse metadata sections (config, state, timer, script, style) from <app>
-static void parse_head(const char *html) {
+static void parse_head(const char *html, const UI::ParsedElement* preparsed) {
     // Clear previous CSS
     UI::Css::instance().clear();
     
-    // Parse using new C++ parser
-    auto doc = UI::Parser::parse(html);
+    // Parse using new C++ parser (or take the launcher's preload)
+    UI::ParsedElement parsed;
+    if (!preparsed) parsed = UI::Parser::parse(html);
+    const UI::ParsedElement& doc = preparsed ? *preparsed : parsed;
     
     LOG_D(Log::UI, "parse_head: doc has %d children", (int)doc.children.size());
     for (const auto& child : doc.children) {
@@ -600,6 +635,52 @@ static bool template_has_var(const char *tpl, const char *varname) {
     return strstr(tpl, search) != nullptr;
 }
 
+// ============ BINDING INDEX ============
+// varname -> indices into elements[] that reference it ({var}, bind, visible, bgcolor, color).
+// Built lazily on update, so every element push site is covered without hooks.
+
+static P::Map<P::String, P::Array<uint16_t>> s_bindIndex;
+static size_t s_bindIndexed = 0;
+
+static void bind_index_add(const P::String& var, size_t idx) {
+    if (var.empty()) return;
+    auto& list = s_bindIndex[var];
+    if (list.empty() || list.back() != idx) list.push_back((uint16_t)idx);
+}
+
+// Same {var} scanning rules as render_template
+static void bind_index_scan(const P::String& tpl, size_t idx) {
+    const char *p = tpl.c_str();
+    while ((p = strchr(p, '{')) != nullptr) {
+        const char *close = strchr(p, '}');
+        if (!close) break;
+        if ((close - p) < VAR_NAME_LEN) {
+            bind_index_add(P::String(p + 1, close - p - 1), idx);
+            p = close + 1;
+        } else {
+            p++;
+        }
+    }
+}
+
+static void bind_index_sync() {
+    for (; s_bindIndexed < elements.size(); s_bindIndexed++) {
+        const auto& el = elements[s_bindIndexed];
+        if (!el) continue;
+        bind_index_scan(el->tpl, s_bindIndexed);
+        bind_index_scan(el->classTemplate, s_bindIndexed);
+        bind_index_add(el->bind, s_bindIndexed);
+        bind_index_add(el->visibleBind, s_bindIndexed);
+        bind_index_add(el->bgcolorBind, s_bindIndexed);
+        bind_index_add(el->colorBind, s_bindIndexed);
+    }
+}
+
+static void bind_index_clear() {
+    s_bindIndex.clear();
+    s_bindIndexed = 0;
+}
+
 // Update all elements that bind to this variable
 // Forward declarations
 static void ui_update_bindings_internal(const char *varname, const char *value);
@@ -617,17 +698,34 @@ void ui_update_bindings(const char *varname, const char *value) {
 
 // Internal function that actually updates bindings
 static void ui_update_bindings_internal(const char *varname, const char *value) {
+    TRACE_SCOPE("bindings");
+    MEM_SCOPE(Ui);
     LOG_V(Log::UI, "update_bindings: var=%s val=%s elements=%d", varname, value, (int)elements.size());
     
     // First update internal state
     ui_set_state(varname, value);
     
+    // <list for="array"> rows are not elements, rebind directly
+    UI::List::onStateChange(varname);
+    
+    Persist::markChanged(varname);
+    
+    // Inputs of <computed>: re-evaluated once per task flush
+    if (Computed::markChanged(varname)) UI::postTask(makeComputedFlush());
+    
+    // Only elements that reference varname (cells[5] touches just its own cell)
+    bind_index_sync();
+    auto dep = s_bindIndex.find(varname);
+    if (dep == s_bindIndex.end()) return;
+    const auto& deps = dep->second;
+    
     // Prevent recursion
     g_updating_from_binding = true;
     
-    // Then find and update all elements
-    for (size_t i = 0; i < elements.size(); i++) {
-        if (!elements[i]) {
+    // Then update dependent elements
+    for (size_t k = 0; k < deps.size(); k++) {
+        size_t i = deps[k];
+        if (i >= elements.size() || !elements[i]) {
             continue;
         }
         
@@ -939,8 +1037,9 @@ const char* ui_get_current_page_id() {
 
 // Event handlers + widget builders moved to ui_widget_builder.cpp
 
-// Forward declaration for recursive use by create_tabs
+// Forward declarations for recursive use by create_tabs / create_element
 static void parse_children(const char *html, int len, lv_obj_t *parent);
+static void expand_repeat(const char* astart, const char* aend, const P::String& body, lv_obj_t* parent);
 
 // ============ Tabs widget ============
 // <tabs id="t" x="0" y="0" w="100%" h="100%" barh="32">
@@ -1049,15 +1148,51 @@ void create_tabs(const char* astart, const char* aend, const char* content, lv_o
     LOG_I(Log::UI, "tabs: id=%s barh=%d", id.empty() ? "?" : id.c_str(), barh);
 }
 
-// Parse children of a page (labels, buttons, etc.)
-static void parse_children(const char *html, int len, lv_obj_t *parent) {
-    const char *p = html;
-    const char *end = html + len;
+// ============ Repeat ============
+// <repeat count="8" var="r" from="0">...widgets...</repeat>
+// <repeat for="cells" var="i">...widgets...</repeat>   count = size of array state
+//
+// Body is parsed once into prototypes: one per widget tag, its attributes
+// and content split into literal/expression segments. An instance only
+// fills in the loop var and hands the prototype to the widget builder.
+// Loop var refs: {r} {r+1} {r-1} {r*40} {r*40+10}.
+// Substituted before state templates, so {cells[{r}]} -> {cells[3]}.
+// A nested <repeat> with the same var (default "i" too) shadows it: its
+// body is left for the inner expansion, its attributes are still ours.
+
+namespace {
+
+constexpr int MAX_REPEAT = 256;
+
+struct RepeatSeg {
+    P::String text;         // literal
+    bool isExpr = false;    // loop var: value * mul + add
+    int mul = 1;
+    int add = 0;
+};
+
+// Widget tag of the body; attrs keep the closing '>'
+struct RepeatNode {
     char tag[TAG_BUF_LEN];
-    
+    P::Array<RepeatSeg> attrs;
+    P::Array<RepeatSeg> content;
+};
+
+// Widget tag found by next_tag: attributes [astart, aend), aend at '>',
+// content [cstart, cend) (empty when self-closing or unclosed)
+struct TagSpan {
+    const char *astart, *aend;
+    const char *cstart, *cend;
+};
+
+} // anonymous namespace
+
+// Next widget tag in [p, end) -> tag, span; p moves past it.
+// Closing tags, comments, <page> and <tab> are skipped.
+static bool next_tag(const char *&p, const char *end, const char *html, char *tag, TagSpan& t) {
     while (p < end) {
         while (p < end && *p != '<') p++;
-        if (p >= end) break;
+        if (p >= end) return false;
         p++;
         
         if (*p == '/' || *p == '!') {
@@ -1067,15 +1202,13 @@ static void parse_children(const char *html, int len, lv_obj_t *parent) {
         }
         
         // Read tag
-        int ti = 0;
+        size_t ti = 0;
         while (p < end && !isspace((unsigned char)*p) && *p != '>' && *p != '/' && ti < TAG_BUF_LEN - 1) {
             tag[ti++] = tolower((unsigned char)*p++);
         }
         tag[ti] = '\0';
         if (!tag[0]) continue;
         
-        LOG_I(Log::UI, "parse_tag: [%s]", tag);
-        
         // Skip nested pages and tab tags (tabs are handled inside create_tabs)
         if (strcmp(tag, Layout::Page) == 0 || strcmp(tag, Element::Tab) == 0) {
             while (p < end && *p != '>') p++;
@@ -1083,50 +1216,229 @@ static void parse_children(const char *html, int len, lv_obj_t *parent) {
             continue;
         }
         
-        const char *astart = p;
+        t.astart = p;
         while (p < end && *p != '>') p++;
-        if (p >= end) break;
-        const char *aend = p;
+        if (p >= end) return false;
+        t.aend = p;
         bool self_close = (p > html && *(p-1) == '/');
         p++;
         
-        P::String content;
+        t.cstart = t.cend = p;
         if (!self_close) {
-            const char *cstart = p;
             char closing[PATTERN_BUF_LEN];
             snprintf(closing, sizeof(closing), "</%s>", tag);
-            const char *cend = strstr(p, closing);
+            // <repeat> may nest, needs depth-aware close
+            const char *cend = strcmp(tag, Element::Repeat) == 0 ? findTagClose(p, tag) : strstr(p, closing);
             if (cend && cend < end) {
-                content.assign(cstart, cend - cstart);
+                t.cend = cend;
                 p = cend + strlen(closing);
             }
         }
+        return true;
+    }
+    return false;
+}
+
+static void create_element(const char *tag, const char *astart, const char *aend,
+                           const P::String& content, lv_obj_t *parent) {
+    if (strcmp(tag, Element::Label) == 0) {
+        create_label(astart, aend, content.c_str(), parent);
+    } else if (strcmp(tag, Element::Button) == 0) {
+        create_button(astart, aend, content.c_str(), parent);
+    } else if (strcmp(tag, Element::Switch) == 0) {
+        create_switch(astart, aend, parent);
+    } else if (strcmp(tag, Element::Slider) == 0) {
+        create_slider(astart, aend, parent);
+    } else if (strcmp(tag, Element::Input) == 0) {
+        create_input(astart, aend, content.c_str(), parent);
+    } else if (strcmp(tag, Element::Canvas) == 0) {
+        create_canvas(astart, aend, parent);
+    } else if (strcmp(tag, Element::Image) == 0) {
+        create_image(astart, aend, parent);
+    } else if (strcmp(tag, Element::Markdown) == 0) {
+        create_markdown(astart, aend, content.c_str(), parent);
+    } else if (strcmp(tag, Element::Tabs) == 0) {
+        create_tabs(astart, aend, content.c_str(), parent);
+    } else if (strcmp(tag, Element::Repeat) == 0) {
+        expand_repeat(astart, aend, content, parent);
+    } else if (strcmp(tag, Element::List) == 0) {
+        create_list(astart, aend, content.c_str(), parent);
+    }
+}
+
+// "{r}", "{r+1}", "{r*40+10}" at p -> seg, returns past '}' (nullptr if not a loop ref)
+static const char* parse_repeat_expr(const char *p, const P::String& var, RepeatSeg& seg) {
+    const char *q = p + 1;
+    if (strncmp(q, var.c_str(), var.size()) != 0) return nullptr;
+    q += var.size();
+    
+    char *num = nullptr;
+    seg = RepeatSeg{};
+    seg.isExpr = true;
+    if (*q == '*') {
+        seg.mul = (int)strtol(q + 1, &num, 10);
+        if (num == q + 1) return nullptr;
+        q = num;
+    }
+    if (*q == '+' || *q == '-') {
+        seg.add = (int)strtol(q, &num, 10);
+        if (num == q) return nullptr;
+        q = num;
+    }
+    return *q == '}' ? q + 1 : nullptr;
+}
+
+static P::String repeat_var(const char *astart, const char *aend) {
+    P::String var = getAttr(astart, aend, "var");
+    if (var.empty()) var = "i";
+    return var;
+}
+
+// Nested <repeat> at p that rebinds var -> its body [*bodyStart, return), else nullptr
+static const char* shadowing_repeat(const char *p, const P::String& var, const char **bodyStart) {
+    size_t tlen = strlen(Element::Repeat);
+    if (strncmp(p + 1, Element::Repeat, tlen) != 0) return nullptr;
+    const char *astart = p + 1 + tlen;
+    if (*astart != ' ' && *astart != '>') return nullptr;
+    const char *aend = strchr(astart, '>');
+    if (!aend || aend[-1] == '/') return nullptr;
+    
+    if (repeat_var(astart, aend) != var) return nullptr;
+    *bodyStart = aend + 1;
+    return findTagClose(aend + 1, Element::Repeat);
+}
+
+static void add_literal(const char *from, const char *to, P::Array<RepeatSeg>& segs) {
+    if (from >= to) return;
+    RepeatSeg text;
+    text.text.assign(from, to - from);
+    segs.push_back(std::move(text));
+}
+
+// [begin, end) -> literal and loop var segments
+static void compile_segments(const char *begin, const char *end, const P::String& var,
+                             P::Array<RepeatSeg>& segs) {
+    const char *lit = begin;
+    const char *p = begin;
+    const char *skipFrom = nullptr, *skipTo = nullptr;
+    
+    while (p < end) {
+        if (*p != '{' && *p != '<') {
+            p++;
+            continue;
+        }
+        if (skipFrom && p >= skipFrom) {
+            p = skipTo;             // shadowed body stays literal
+            skipFrom = nullptr;
+            continue;
+        }
+        if (*p == '<') {
+            if (!skipFrom) {
+                const char *bodyStart = nullptr;
+                const char *close = shadowing_repeat(p, var, &bodyStart);
+                if (close) {
+                    skipFrom = bodyStart;
+                    skipTo = close;
+                }
+            }
+            p++;
+            continue;
+        }
         
-        if (strcmp(tag, Element::Label) == 0) {
-            create_label(astart, aend, content.c_str(), parent);
-        } else if (strcmp(tag, Element::Button) == 0) {
-            create_button(astart, aend, content.c_str(), parent);
-        } else if (strcmp(tag, Element::Switch) == 0) {
-            create_switch(astart, aend, parent);
-        } else if (strcmp(tag, Element::Slider) == 0) {
-            create_slider(astart, aend, parent);
-        } else if (strcmp(tag, Element::Input) == 0) {
-            create_input(astart, aend, content.c_str(), parent);
-        } else if (strcmp(tag, Element::Canvas) == 0) {
-            create_canvas(astart, aend, parent);
-        } else if (strcmp(tag, Element::Image) == 0) {
-            create_image(astart, aend, parent);
-        } else if (strcmp(tag, Element::Markdown) == 0) {
-            create_markdown(astart, aend, content.c_str(), parent);
-        } else if (strcmp(tag, Element::Tabs) == 0) {
-            create_tabs(astart, aend, content.c_str(), parent);
+        RepeatSeg expr;
+        const char *next = parse_repeat_expr(p, var, expr);
+        if (!next) {
+            p++;
+            continue;
         }
+        add_literal(lit, p, segs);
+        segs.push_back(expr);
+        p = lit = next;
+    }
+    add_literal(lit, end, segs);
+}
+
+static void compile_repeat(const P::String& body, const P::String& var, P::Array<RepeatNode>& nodes) {
+    const char *p = body.c_str();
+    const char *end = p + body.size();
+    TagSpan t;
+    RepeatNode node;
+    while (next_tag(p, end, body.c_str(), node.tag, t)) {
+        node.attrs.clear();
+        node.content.clear();
+        compile_segments(t.astart, t.aend + 1, var, node.attrs);
+        if (strcmp(node.tag, Element::Repeat) == 0 && repeat_var(t.astart, t.aend) == var) {
+            add_literal(t.cstart, t.cend, node.content);     // shadowed: inner expansion's
+        } else {
+            compile_segments(t.cstart, t.cend, var, node.content);
+        }
+        nodes.push_back(node);
+    }
+}
+
+static void fill_segments(const P::Array<RepeatSeg>& segs, int i, P::String& out) {
+    char num[12];
+    out.clear();
+    for (const auto& seg : segs) {
+        if (!seg.isExpr) {
+            out += seg.text;
+            continue;
+        }
+        snprintf(num, sizeof(num), "%d", i * seg.mul + seg.add);
+        out += num;
+    }
+}
+
+static void expand_repeat(const char* astart, const char* aend, const P::String& body, lv_obj_t* parent) {
+    P::String var = repeat_var(astart, aend);
+    int from = getAttrInt(astart, aend, "from", 0);
+    int count = getAttrInt(astart, aend, "count", 0);
+    
+    auto forName = getAttr(astart, aend, "for");
+    if (!forName.empty()) {
+        count = (int)State::store().sizeOf(forName);
+        if (count == 0) LOG_W(Log::UI, "repeat: for=%s is not an array", forName.c_str());
+    }
+    if (count > MAX_REPEAT) {
+        LOG_W(Log::UI, "repeat: count %d clamped to %d", count, MAX_REPEAT);
+        count = MAX_REPEAT;
+    }
+    if (count <= 0 || body.empty()) return;
+    
+    P::Array<RepeatNode> nodes;
+    compile_repeat(body, var, nodes);
+    
+    P::String attrs, content;
+    for (int i = from; i < from + count; i++) {
+        for (const auto& node : nodes) {
+            fill_segments(node.attrs, i, attrs);
+            fill_segments(node.content, i, content);
+            create_element(node.tag, attrs.c_str(), attrs.c_str() + attrs.size() - 1, content, parent);
+        }
+    }
+    
+    LOG_D(Log::UI, "repeat: var=%s x%d (%d widgets each)", var.c_str(), count, (int)nodes.size());
+}
+
+// Parse children of a page (labels, buttons, etc.)
+static void parse_children(const char *html, int len, lv_obj_t *parent) {
+    const char *p = html;
+    const char *end = html + len;
+    char tag[TAG_BUF_LEN];
+    TagSpan t;
+    
+    while (next_tag(p, end, html, tag, t)) {
+        LOG_I(Log::UI, "parse_tag: [%s]", tag);
+        P::String content(t.cstart, t.cend - t.cstart);
+        create_element(tag, t.astart, t.aend, content, parent);
     }
 }
 
 void ui_html_init_internal(void) {
     // Clear all vectors
     elements.clear();
+    bind_index_clear();
+    UI::List::clear();
     s_deferredZIndex.clear();
     timers.clear();
     styles.clear();
@@ -1147,8 +1459,10 @@ void ui_html_init_internal(void) {
     // Reset app metadata
     app_icon.clear();
     
-    // Clear stores
+    // Clear stores (pending persist writes go out first)
+    Persist::close();
     State::store().clear();
+    Computed::clear();
     
     // Clear keyboards array
     memset(g_keyboards, 0, sizeof(g_keyboards));
@@ -1162,7 +1476,7 @@ void ui_html_init_internal(void) {
     LOG_I(Log::UI, "Init v%s", UI::Engine::version());
 }
 
-int ui_html_render_internal(const char *html) {
+int ui_html_render_internal(const char *html, const UI::ParsedElement* doc) {
     if (!html) return INVALID_INDEX;
     
     LOG_D(Log::UI, "render_internal: starting");
@@ -1171,7 +1485,7 @@ int ui_html_render_internal(const char *html) {
     
     // Pass 0: Parse <head>/<app> sections
     LOG_D(Log::UI, "render_internal: parse_head...");
-    parse_head(html);
+    parse_head(html, doc);
     LOG_D(Log::UI, "render_internal: parse_head done");
     
     if (!app_version.empty() && app_version != "0.0") {
@@ -1429,6 +1743,8 @@ void ui_clear_internal(void) {
     
     LOG_D(Log::UI, "clear: clearing elements vector...");
     elements.clear();
+    bind_index_clear();
+    UI::List::clear();
     s_deferredZIndex.clear();
     page_count = 0;
     current_page = 0;
@@ -68,7 +68,8 @@ extern lv_obj_t* g_keyboards[MAX_SCREENS];
 // ============ Internal functions (defined in ui_html.cpp) ============
 
 void ui_html_init_internal(void);
-int  ui_html_render_internal(const char* html);
+namespace UI { struct ParsedElement; }
+int  ui_html_render_internal(const char* html, const UI::ParsedElement* doc = nullptr);
 void ui_clear_internal(void);
 lv_obj_t* ui_get_internal(const char* id);
 void ui_set_text_internal(const char* id, const char* text);
@@ -146,4 +147,8 @@ void create_canvas(const char* astart, const char* aend, lv_obj_t* parent);
 void create_markdown(const char* astart, const char* aend, const char* content, lv_obj_t* parent);
 void create_tabs(const char* astart, const char* aend, const char* content, lv_obj_t* parent);
 
+// ============ Virtualized list (defined in ui_list.cpp) ============
+
+void create_list(const char* astart, const char* aend, const char* content, lv_obj_t* parent);
+
 #endif // UI_HTML_INTERNAL_H
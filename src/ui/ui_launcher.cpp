@@ -18,12 +18,18 @@
 #include <cstring>
 #include <cctype>
 #include <ctime>
+#include <algorithm>
 
 #include "ui_layout.h"
 #include "_generated_icons.h"
 
 static const char* TAG = "Launcher";
 
+// Pages kept alive on each side of the current one
+static constexpr size_t KEEP_PAGES = 1;
+// Neighbours are built after the swipe frame is out
+static constexpr uint32_t WINDOW_DELAY_MS = 40;
+
 namespace UI {
 
 // ============================================
@@ -189,12 +195,10 @@ lv_obj_t* Launcher::loadIcon(lv_obj_t* cell, const LauncherAppInfo& app, size_t
 #endif
 
 #ifndef NO_PNG_ICONS
-    // 3. PSRAM preloaded
+    // 3. PSRAM (decoded on first show of the page, see IconCache)
     if (!iconSrc) {
   #ifdef PRELOAD_ICONS_TO_PSRAM
-        if (app.hasIcon && app.iconDsc) {
-            iconSrc = app.iconDsc;
-        }
+        iconSrc = App::Manager::instance().iconFor(appIdx);
   #endif
     }
     
@@ -261,6 +265,10 @@ lv_obj_t* Launcher::loadIcon(lv_obj_t* cell, const LauncherAppInfo& app, size_t
 // Static callbacks -> instance methods
 // ============================================
 
+// Tap filter: shorter presses are ignored, longer moves are swipes
+static constexpr uint32_t TAP_MIN_MS = 60;
+static constexpr int SWIPE_THRESHOLD = SCREEN_WIDTH * 8 / 100;
+
 void Launcher::onGestureStatic(lv_event_t* e) {
     auto* self = (Launcher*)lv_event_get_user_data(e);
     lv_dir_t dir = lv_indev_get_gesture_dir(lv_indev_active());
@@ -277,6 +285,30 @@ void Launcher::onTouchStartStatic(lv_event_t* e) {
     }
 }
 
+// Held past the tap filter without moving: start reading/compiling the app
+// while the finger is still down. Swipes that begin on an icon never get here.
+void Launcher::onCellPressStatic(lv_event_t* e) {
+    auto* data = (Launcher::CellData*)lv_event_get_user_data(e);
+    auto* self = data->self;
+    lv_indev_t* indev = lv_indev_active();
+    if (!indev || self->m_touchStartX < 0) return;
+    if (data->appIdx >= self->m_apps.size()) return;
+    
+    lv_point_t p;
+    lv_indev_get_point(indev, &p);
+    int dx = abs(p.x - self->m_touchStartX);
+    int dy = abs(p.y - self->m_touchStartY);
+    if (dx > SWIPE_THRESHOLD || dy > SWIPE_THRESHOLD) {
+        // Turned into a swipe after the preload was requested
+        if (self->m_preloadQueued) App::Manager::instance().cancelPreload();
+        return;
+    }
+    if (self->m_preloadQueued || lv_tick_get() - self->m_touchStartTime < TAP_MIN_MS) return;
+    
+    self->m_preloadQueued = true;
+    App::Manager::instance().queuePreload(self->m_apps[data->appIdx].name);
+}
+
 void Launcher::onCellClickStatic(lv_event_t* e) {
     auto* data = (Launcher::CellData*)lv_event_get_user_data(e);
     auto* self = data->self;
@@ -285,6 +317,7 @@ void Launcher::onCellClickStatic(lv_event_t* e) {
     lv_indev_t* indev = lv_indev_active();
     if (!indev || self->m_touchStartX < 0) {
         self->m_touchStartX = -1;
+        App::Manager::instance().cancelPreload();
         return;
     }
     
@@ -293,18 +326,19 @@ void Launcher::onCellClickStatic(lv_event_t* e) {
     uint32_t duration = lv_tick_get() - self->m_touchStartTime;
     
     // Filter too short clicks
-    if (duration < 60) {
+    if (duration < TAP_MIN_MS) {
         self->m_touchStartX = -1;
+        App::Manager::instance().cancelPreload();
         return;
     }
     
     // Filter swipes
     int dx = abs(p.x - self->m_touchStartX);
     int dy = abs(p.y - self->m_touchStartY);
-    const int SWIPE_THRESHOLD = SCREEN_WIDTH * 8 / 100;
     
     if (dx > SWIPE_THRESHOLD || dy > SWIPE_THRESHOLD) {
         self->m_touchStartX = -1;
+        App::Manager::instance().cancelPreload();
         return;
     }
     
@@ -317,6 +351,12 @@ void Launcher::updateClocksStatic(lv_timer_t* t) {
     self->updateClocks();
 }
 
+void Launcher::updateWindowStatic(lv_timer_t* t) {
+    auto* self = (Launcher*)lv_timer_get_user_data(t);
+    self->m_windowTimer = nullptr;  // one-shot, LVGL deletes it
+    self->updateWindow();
+}
+
 // ============================================
 // Instance callback methods
 // ============================================
@@ -325,10 +365,12 @@ void Launcher::onTouchStart(int16_t x, int16_t y) {
     m_touchStartX = x;
     m_touchStartY = y;
     m_touchStartTime = lv_tick_get();
+    m_preloadQueued = false;
 }
 
 void Launcher::onGesture(lv_dir_t dir) {
     m_touchStartX = -1;
+    App::Manager::instance().cancelPreload();
     
     // Swipe down → open shade
     if (dir == LV_DIR_BOTTOM) {
@@ -347,6 +389,7 @@ void Launcher::onGesture(lv_dir_t dir) {
     }
     
     if (newPage != m_currentPage) {
+        ensurePage(newPage);  // normally already built as a neighbour
         lv_obj_add_flag(m_pages[m_currentPage], LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(m_pages[newPage], LV_OBJ_FLAG_HIDDEN);
         
@@ -370,6 +413,11 @@ void Launcher::onGesture(lv_dir_t dir) {
             }
         }
         m_currentPage = newPage;
+        
+        if (!m_windowTimer) {
+            m_windowTimer = lv_timer_create(updateWindowStatic, WINDOW_DELAY_MS, this);
+            lv_timer_set_repeat_count(m_windowTimer, 1);
+        }
     }
 }
 
@@ -491,11 +539,10 @@ void Launcher::createAppCell(lv_obj_t* pageObj, size_t appIdx, int x, int y, int
     lv_obj_add_flag(cell, LV_OBJ_FLAG_EVENT_BUBBLE);
     lv_obj_clear_flag(cell, LV_OBJ_FLAG_SCROLLABLE);
     
-    // Heap-allocate callback data (freed in release())
-    auto* cellData = new CellData{this, appIdx};
-    m_cellData.push_back(cellData);
+    CellData* cellData = &m_cellData[appIdx];
     
     lv_obj_add_event_cb(cell, onTouchStartStatic, LV_EVENT_PRESSED, this);
+    lv_obj_add_event_cb(cell, onCellPressStatic, LV_EVENT_PRESSING, cellData);
     lv_obj_add_event_cb(cell, onCellClickStatic, LV_EVENT_RELEASED, cellData);
     
     // Load icon
@@ -526,10 +573,6 @@ void Launcher::createAppCell(lv_obj_t* pageObj, size_t appIdx, int x, int y, int
 
 void Launcher::createPage(lv_obj_t* scr, size_t pageIdx, size_t totalApps) {
     const int COLS = LAUNCHER_COLS;
-    const int ROWS_PAGE1 = LAUNCHER_ROWS_PAGE1;
-    const int ROWS_OTHER = LAUNCHER_ROWS_OTHER;
-    const int APPS_PAGE1 = COLS * ROWS_PAGE1;
-    const int APPS_OTHER = COLS * ROWS_OTHER;
     const int CELL_WIDTH = LAUNCHER_CELL_WIDTH;
     const int CELL_HEIGHT_PAGE1 = LAUNCHER_CELL_HEIGHT_P1;
     const int CELL_HEIGHT_OTHER = LAUNCHER_CELL_HEIGHT;
@@ -545,10 +588,10 @@ void Launcher::createPage(lv_obj_t* scr, size_t pageIdx, size_t totalApps) {
     lv_obj_add_flag(pageObj, LV_OBJ_FLAG_GESTURE_BUBBLE);
     lv_obj_add_flag(pageObj, LV_OBJ_FLAG_EVENT_BUBBLE);
     
-    if (pageIdx > 0) {
+    if (pageIdx != m_currentPage) {
         lv_obj_add_flag(pageObj, LV_OBJ_FLAG_HIDDEN);
     }
-    m_pages.push_back(pageObj);
+    m_pages[pageIdx] = pageObj;
     
     int iconOffsetY = 0;
     
@@ -561,26 +604,79 @@ void Launcher::createPage(lv_obj_t* scr, size_t pageIdx, size_t totalApps) {
     }
     
     // App cells
-    int rows = (pageIdx == 0) ? ROWS_PAGE1 : ROWS_OTHER;
     int cellHeight = (pageIdx == 0) ? CELL_HEIGHT_PAGE1 : CELL_HEIGHT_OTHER;
     int gridWidth = COLS * CELL_WIDTH;
     int marginX = (PAGE_WIDTH - gridWidth) / 2;
     
-    for (int row = 0; row < rows; row++) {
-        for (int col = 0; col < COLS; col++) {
-            size_t appIdx;
-            if (pageIdx == 0) {
-                appIdx = row * COLS + col;
-            } else {
-                appIdx = APPS_PAGE1 + (pageIdx - 1) * APPS_OTHER + row * COLS + col;
-            }
-            if (appIdx >= totalApps) break;
-            
-            int x = col * CELL_WIDTH + marginX;
-            int y = row * cellHeight + iconOffsetY;
-            
-            createAppCell(pageObj, appIdx, x, y, cellHeight);
-        }
+    size_t first, end;
+    appRange(pageIdx, first, end);
+    for (size_t appIdx = first; appIdx < end && appIdx < totalApps; appIdx++) {
+        int row = (appIdx - first) / COLS;
+        int col = (appIdx - first) % COLS;
+        int x = col * CELL_WIDTH + marginX;
+        int y = row * cellHeight + iconOffsetY;
+        
+        createAppCell(pageObj, appIdx, x, y, cellHeight);
+    }
+}
+
+// ============================================
+// Page window (virtualization)
+// ============================================
+
+// App indices [first, end) shown on a page
+void Launcher::appRange(size_t pageIdx, size_t& first, size_t& end) {
+    const size_t APPS_PAGE1 = LAUNCHER_COLS * LAUNCHER_ROWS_PAGE1;
+    const size_t APPS_OTHER = LAUNCHER_COLS * LAUNCHER_ROWS_OTHER;
+    first = (pageIdx == 0) ? 0 : APPS_PAGE1 + (pageIdx - 1) * APPS_OTHER;
+    end = first + ((pageIdx == 0) ? APPS_PAGE1 : APPS_OTHER);
+    if (end > m_apps.size()) end = m_apps.size();
+    if (first > end) first = end;
+}
+
+void Launcher::ensurePage(size_t pageIdx) {
+    if (pageIdx >= m_pages.size() || m_pages[pageIdx]) return;
+    createPage(m_screen, pageIdx, m_apps.size());
+    // Dots are drawn above pages
+    if (m_dotsContainer) lv_obj_move_foreground(m_dotsContainer);
+}
+
+void Launcher::releasePage(size_t pageIdx) {
+    lv_obj_t* page = m_pages[pageIdx];
+    if (!page) return;
+    
+    // Clock labels of this page die with it
+    auto drop = [page](P::Array<lv_obj_t*>& labels) {
+        labels.erase(std::remove_if(labels.begin(), labels.end(),
+            [page](lv_obj_t* l) { return lv_obj_get_parent(l) == page; }), labels.end());
+    };
+    drop(m_clockLabels);
+    drop(m_bigDateLabels);
+    drop(m_compactDayLabels);
+    drop(m_compactDateLabels);
+    
+    size_t first, end;
+    appRange(pageIdx, first, end);
+    for (size_t i = first; i < end; i++) {
+        m_icons[i] = nullptr;
+#if defined(PRELOAD_ICONS_TO_PSRAM) && !defined(NO_PNG_ICONS)
+        App::Manager::instance().releaseIcon(i);
+#endif
+    }
+    
+    lv_obj_delete(page);
+    m_pages[pageIdx] = nullptr;
+}
+
+// Current page ± KEEP_PAGES materialised, everything else released
+void Launcher::updateWindow() {
+    size_t lo = m_currentPage > KEEP_PAGES ? m_currentPage - KEEP_PAGES : 0;
+    size_t hi = m_currentPage + KEEP_PAGES;
+    for (size_t i = 0; i < m_pages.size(); i++) {
+        if (i < lo || i > hi) releasePage(i);
+    }
+    for (size_t i = lo; i <= hi && i < m_pages.size(); i++) {
+        ensurePage(i);
     }
 }
 
@@ -628,8 +724,10 @@ void Launcher::createDots(lv_obj_t* scr, size_t numPages) {
 void Launcher::show(const std::vector<LauncherAppInfo>& apps) {
     LOG_I(Log::APP, "Launcher::show() - %d apps", (int)apps.size());
     
+    // Previous launcher objects are already gone with the screen content
+    release();
+    
     // Store apps
-    m_apps.clear();
     for (const auto& app : apps) {
         m_apps.push_back(app);
     }
@@ -649,19 +747,12 @@ void Launcher::show(const std::vector<LauncherAppInfo>& apps) {
     }
     if (m_numPages < 1) m_numPages = 1;
     
-    // Reset UI state (m_cellData freed via cleanup() before show())
-    m_pages.clear();
-    m_dots.clear();
-    m_dotsContainer = nullptr;
-    m_icons.clear();
-    m_clockLabels.clear();
-    m_bigDateLabels.clear();
-    m_compactDayLabels.clear();
-    m_compactDateLabels.clear();
-    m_currentPage = 0;
-    m_touchStartX = -1;
-    
+    m_pages.resize(m_numPages, nullptr);
     m_icons.resize(m_apps.size(), nullptr);
+    m_cellData.resize(m_apps.size());
+    for (size_t i = 0; i < m_cellData.size(); i++) {
+        m_cellData[i] = CellData{this, i};
+    }
     
     // Setup screen
     lv_obj_t* scr = lv_screen_active();
@@ -672,15 +763,16 @@ void Launcher::show(const std::vector<LauncherAppInfo>& apps) {
     
     // Gesture handler
     lv_obj_add_event_cb(scr, onGestureStatic, LV_EVENT_GESTURE, this);
+    m_screen = scr;
     
-    // Create pages
-    for (size_t page = 0; page < m_numPages; page++) {
-        createPage(scr, page, totalApps);
-    }
+    // First page now, neighbours after the first frame
+    createPage(scr, 0, totalApps);
     
     // Create dots
     if (m_numPages > 1) {
         createDots(scr, m_numPages);
+        m_windowTimer = lv_timer_create(updateWindowStatic, WINDOW_DELAY_MS, this);
+        lv_timer_set_repeat_count(m_windowTimer, 1);
     }
     
     // Clock timer
@@ -697,13 +789,22 @@ void Launcher::release() {
         lv_timer_delete(m_clockTimer);
         m_clockTimer = nullptr;
     }
+    if (m_windowTimer) {
+        lv_timer_delete(m_windowTimer);
+        m_windowTimer = nullptr;
+    }
     
-    // Free heap-allocated cell data
-    for (auto* cd : m_cellData) {
-        delete cd;
+#if defined(PRELOAD_ICONS_TO_PSRAM) && !defined(NO_PNG_ICONS)
+    // Decoded icons of built pages (objects are deleted with the screen)
+    for (size_t p = 0; p < m_pages.size(); p++) {
+        if (!m_pages[p]) continue;
+        size_t first, end;
+        appRange(p, first, end);
+        for (size_t i = first; i < end; i++) App::Manager::instance().releaseIcon(i);
     }
-    m_cellData.clear();
+#endif
     
+    m_cellData.clear();
     m_apps.clear();
     m_pages.clear();
     m_dots.clear();
@@ -713,6 +814,7 @@ void Launcher::release() {
     m_bigDateLabels.clear();
     m_compactDayLabels.clear();
     m_compactDateLabels.clear();
+    m_screen = nullptr;
     m_currentPage = 0;
     m_numPages = 0;
     m_touchStartX = -1;
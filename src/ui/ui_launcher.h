@@ -15,13 +15,11 @@ struct LauncherAppInfo {
     P::String title;
     P::String category;
     P::String iconPath;
-    
-    // Pre-decoded icon
-    const lv_image_dsc_t* iconDsc = nullptr;
-    bool hasIcon = false;
 };
 
-/// Launcher UI - displays app grid with pages and clock
+/// Launcher UI - displays app grid with pages and clock.
+/// Only the current page and its neighbours exist as LVGL objects;
+/// others are built/deleted as the user swipes (see KEEP_PAGES).
 class Launcher {
 public:
     ~Launcher() { release(); }
@@ -49,6 +47,10 @@ private:
     
     // UI creation
     void createPage(lv_obj_t* scr, size_t pageIdx, size_t totalApps);
+    void appRange(size_t pageIdx, size_t& first, size_t& end);
+    void ensurePage(size_t pageIdx);
+    void releasePage(size_t pageIdx);
+    void updateWindow();
     void createAppCell(lv_obj_t* page, size_t appIdx, int x, int y, int cellHeight);
     void createDots(lv_obj_t* scr, size_t numPages);
     void createBigClock(lv_obj_t* page);
@@ -57,8 +59,10 @@ private:
     // Callbacks (static, access instance via user_data)
     static void onGestureStatic(lv_event_t* e);
     static void onTouchStartStatic(lv_event_t* e);
+    static void onCellPressStatic(lv_event_t* e);
     static void onCellClickStatic(lv_event_t* e);
     static void updateClocksStatic(lv_timer_t* t);
+    static void updateWindowStatic(lv_timer_t* t);
     
     // Instance methods for callbacks
     void onGesture(lv_dir_t dir);
@@ -71,7 +75,7 @@ private:
     
     // State
     P::Array<LauncherAppInfo> m_apps;
-    P::Array<lv_obj_t*> m_pages;
+    P::Array<lv_obj_t*> m_pages;              // nullptr = not materialised
     P::Array<lv_obj_t*> m_dots;
     P::Array<lv_obj_t*> m_icons;
     P::Array<lv_obj_t*> m_clockLabels;
@@ -80,6 +84,8 @@ private:
     P::Array<lv_obj_t*> m_compactDateLabels;  // "24 февраля"
     lv_obj_t* m_dotsContainer = nullptr;
     lv_timer_t* m_clockTimer = nullptr;
+    lv_timer_t* m_windowTimer = nullptr;      // deferred neighbour build/release
+    lv_obj_t* m_screen = nullptr;
     size_t m_currentPage = 0;
     size_t m_numPages = 0;
     
@@ -87,10 +93,11 @@ private:
     int16_t m_touchStartX = -1;
     int16_t m_touchStartY = -1;
     uint32_t m_touchStartTime = 0;
+    bool m_preloadQueued = false;   // preload already requested for this press
     
-    // Cell callback data (heap allocated, pointers stable)
+    // Cell callback data, one per app (sized once in show(), pointers stable)
     struct CellData { Launcher* self; size_t appIdx; };
-    P::Array<CellData*> m_cellData;
+    P::Array<CellData> m_cellData;
     
     // Time tracking
     uint32_t m_startMillis = 0;
@@ -0,0 +1,367 @@
+/**
+ * ui_list.cpp - Virtualized <list> widget
+ *
+ * Container scrolls over a 1px spacer placed at rows * rowh; a fixed pool
+ * of row labels (visible + overscan) is repositioned on scroll. Pool slot
+ * for row r is r % pool, so rows that stay on screen are not rebound.
+ */
+
+#include "lvgl.h"
+#include "ui/ui_list.h"
+#include "ui/ui_engine.h"
+#include "ui/ui_html_internal.h"
+#include "ui/xml_utils.h"
+#include "widgets/widget_common.h"
+#include "core/state_store.h"
+#include "utils/string_utils.h"
+#include "utils/log_config.h"
+#include <cstdlib>
+
+static const char* TAG = "ui_list";
+
+using namespace UI::XmlUtils;
+using namespace UI::StringUtils;
+
+namespace {
+
+constexpr int OVERSCAN = 2;
+constexpr int DEFAULT_ROW_H = 32;
+constexpr int MAX_POOL = 64;
+
+// Row template segment: literal text, {#} or {.field}
+struct Seg {
+    enum Kind : uint8_t { Text, Index, Field };
+    Kind kind = Text;
+    P::String text;         // literal, or field name ("" = whole item)
+};
+
+class ArraySource : public UI::ListSource {
+public:
+    explicit ArraySource(const P::String& name) : m_name(name) {}
+
+    size_t count() const override { return State::store().sizeOf(m_name); }
+
+    P::String field(size_t row, const P::String&) const override {
+        return State::store().getAsString(Store::elementPath(m_name, row));
+    }
+
+    const char* stateName() const override { return m_name.c_str(); }
+
+private:
+    P::String m_name;
+};
+
+struct ListView {
+    P::String id;
+    lv_obj_t* cont = nullptr;
+    lv_obj_t* spacer = nullptr;
+    P::Array<lv_obj_t*> pool;
+    P::Array<int> slotRow;          // row bound to pool slot, -1 = none
+    P::Array<Seg> tpl;
+    P::Ptr<UI::ListSource> source;
+    P::String onclick;
+    P::String selected;             // int state var receiving clicked row
+    P::String buf;                  // render buffer, reused
+    int rowH = DEFAULT_ROW_H;
+    size_t rows = 0;
+
+    const P::String& render(size_t row) {
+        buf.clear();
+        char num[12];
+        for (const auto& seg : tpl) {
+            switch (seg.kind) {
+                case Seg::Text:
+                    buf += seg.text;
+                    break;
+                case Seg::Index:
+                    snprintf(num, sizeof(num), "%u", (unsigned)row);
+                    buf += num;
+                    break;
+                case Seg::Field:
+                    if (source) buf += source->field(row, seg.text);
+                    break;
+            }
+        }
+        return buf;
+    }
+
+    void bindRow(size_t slot, int row) {
+        lv_obj_t* obj = pool[slot];
+        slotRow[slot] = row;
+        if (row < 0 || (size_t)row >= rows) {
+            lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+            return;
+        }
+        lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_set_y(obj, row * rowH);
+        lv_obj_set_user_data(obj, (void*)(intptr_t)row);
+        lv_label_set_text(obj, render(row).c_str());
+    }
+
+    void layout(bool force) {
+        if (pool.empty()) return;
+        int first = lv_obj_get_scroll_y(cont) / rowH - OVERSCAN;
+        if (first < 0) first = 0;
+
+        size_t n = pool.size();
+        for (size_t k = 0; k < n; k++) {
+            int row = first + (int)k;
+            size_t slot = (size_t)row % n;
+            if (!force && slotRow[slot] == row) continue;
+            bindRow(slot, row);
+        }
+    }
+
+    void updateCount() {
+        rows = source ? source->count() : 0;
+        int32_t bottom = (int32_t)rows * rowH - 1;
+        lv_obj_set_y(spacer, bottom > 0 ? bottom : 0);
+    }
+
+    void rebindIfVisible(int row) {
+        if (pool.empty()) return;
+        size_t slot = (size_t)row % pool.size();
+        if (slotRow[slot] == row) bindRow(slot, row);
+    }
+};
+
+} // anonymous namespace
+
+static MPArray<ListView> s_lists;
+
+static ListView* findList(const char* id) {
+    for (auto& v : s_lists) {
+        if (v->id == id) return v.get();
+    }
+    LOG_W(Log::UI, "list not found: %s", id);
+    return nullptr;
+}
+
+// "{#}: {.name}" -> segments
+static void compile_row_template(const P::String& src, P::Array<Seg>& out) {
+    const char* lit = src.c_str();
+    const char* p = lit;
+
+    auto flush = [&](const char* upto) {
+        if (upto <= lit) return;
+        Seg s;
+        s.text.assign(lit, upto - lit);
+        out.push_back(std::move(s));
+    };
+
+    while ((p = strchr(p, '{')) != nullptr) {
+        const char* close = strchr(p, '}');
+        if (!close) break;
+
+        Seg s;
+        if (close == p + 2 && p[1] == '#') {
+            s.kind = Seg::Index;
+        } else if (p[1] == '.') {
+            s.kind = Seg::Field;
+            s.text.assign(p + 2, close - p - 2);
+        } else {
+            p++;
+            continue;
+        }
+        flush(p);
+        out.push_back(std::move(s));
+        p = lit = close + 1;
+    }
+    flush(src.c_str() + src.size());
+}
+
+// ============ Events ============
+
+static void list_scroll_cb(lv_event_t* e) {
+    auto* view = static_cast<ListView*>(lv_event_get_user_data(e));
+    view->layout(false);
+}
+
+static void list_row_click_cb(lv_event_t* e) {
+    auto* view = static_cast<ListView*>(lv_event_get_user_data(e));
+    lv_obj_t* row = (lv_obj_t*)lv_event_get_target(e);
+    int idx = (int)(intptr_t)lv_obj_get_user_data(row);
+    if (idx < 0 || (size_t)idx >= view->rows) return;
+
+    s_in_lvgl_callback = true;
+    LOG_I(Log::UI, "list %s: row %d", view->id.c_str(), idx);
+
+    if (!view->selected.empty()) {
+        char val[SMALL_BUF_LEN];
+        snprintf(val, sizeof(val), "%d", idx);
+        ui_update_bindings(view->selected.c_str(), val);
+        if (g_state_change_handler) {
+            g_state_change_handler(view->selected.c_str(), val);
+        }
+    }
+    if (!view->onclick.empty() && g_onclick_handler) {
+        g_onclick_handler(view->onclick.c_str());
+    }
+    s_in_lvgl_callback = false;
+}
+
+// ============ Builder ============
+
+void create_list(const char* astart, const char* aend, const char* content, lv_obj_t* parent) {
+    auto id = getAttr(astart, aend, "id");
+    if (id.empty()) {
+        static int auto_id = 0;
+        char idbuf[SMALL_BUF_LEN];
+        snprintf(idbuf, sizeof(idbuf), "_list%d", auto_id++);
+        id = idbuf;
+    }
+
+    int32_t x = parse_coord_w(getAttr(astart, aend, "x").c_str());
+    int32_t y = parse_coord_h(getAttr(astart, aend, "y").c_str());
+    int32_t w = parse_coord_w(getAttr(astart, aend, "w").c_str());
+    int32_t h = parse_coord_h(getAttr(astart, aend, "h").c_str());
+    int rowH = getAttrInt(astart, aend, "rowh", DEFAULT_ROW_H);
+    if (rowH <= 0) rowH = DEFAULT_ROW_H;
+    auto cssClass = getAttr(astart, aend, "class");
+    auto rowClass = getAttr(astart, aend, "rowclass");
+    auto visible = getAttr(astart, aend, "visible");
+    auto bgcolorAttr = getAttr(astart, aend, "bgcolor");
+    auto colorAttr = getAttr(astart, aend, "color");
+
+    lv_obj_t* cont = lv_obj_create(parent);
+    lv_obj_remove_style_all(cont);
+    if (x || y) lv_obj_set_pos(cont, x, y);
+    lv_obj_set_size(cont, w > 0 ? w : lv_pct(FULL_SIZE_PCT), h > 0 ? h : lv_pct(FULL_SIZE_PCT));
+    lv_obj_set_scroll_dir(cont, LV_DIR_VER);
+    lv_obj_set_scrollbar_mode(cont, LV_SCROLLBAR_MODE_ACTIVE);
+    lv_obj_add_flag(cont, LV_OBJ_FLAG_SCROLL_MOMENTUM);
+
+    if (!bgcolorAttr.empty()) {
+        lv_obj_set_style_bg_color(cont, lv_color_hex(parse_color(bgcolorAttr.c_str())), 0);
+        lv_obj_set_style_bg_opa(cont, LV_OPA_COVER, 0);
+    }
+    if (!colorAttr.empty()) {
+        lv_obj_set_style_text_color(cont, lv_color_hex(parse_color(colorAttr.c_str())), 0);
+    }
+    Widget{cont}.applyCss("list", id.c_str(), cssClass.c_str());
+
+    auto view = P::create<ListView>();
+    view->id = id;
+    view->cont = cont;
+    view->rowH = rowH;
+    view->onclick = getAttr(astart, aend, "onclick");
+    view->selected = getAttr(astart, aend, "selected");
+    compile_row_template(trimmed(content), view->tpl);
+    if (view->tpl.empty()) {
+        Seg whole;
+        whole.kind = Seg::Field;
+        view->tpl.push_back(whole);
+    }
+
+    auto forName = getAttr(astart, aend, "for");
+    if (!forName.empty()) {
+        view->source = P::Ptr<UI::ListSource>(P::create<ArraySource>(forName).release());
+    }
+
+    // Spacer defines scroll extent; must stay visible (hidden children are skipped)
+    view->spacer = lv_obj_create(cont);
+    lv_obj_remove_style_all(view->spacer);
+    lv_obj_set_size(view->spacer, 1, 1);
+    lv_obj_clear_flag(view->spacer, LV_OBJ_FLAG_CLICKABLE);
+
+    // Pool: visible rows + overscan on both sides
+    lv_obj_update_layout(cont);
+    int viewH = lv_obj_get_content_height(cont);
+    int poolSize = (viewH + rowH - 1) / rowH + 2 * OVERSCAN;
+    if (poolSize > MAX_POOL) poolSize = MAX_POOL;
+
+    bool clickable = !view->onclick.empty() || !view->selected.empty();
+    for (int i = 0; i < poolSize; i++) {
+        lv_obj_t* row = lv_label_create(cont);
+        lv_obj_set_size(row, lv_pct(FULL_SIZE_PCT), rowH);
+        lv_label_set_long_mode(row, LV_LABEL_LONG_DOT);
+        lv_label_set_text_static(row, "");
+        Widget{row}.applyCss("row", nullptr, rowClass.c_str());
+
+        // Center text vertically (font known after CSS)
+        int lineH = lv_font_get_line_height(lv_obj_get_style_text_font(row, LV_PART_MAIN));
+        if (rowH > lineH) lv_obj_set_style_pad_top(row, (rowH - lineH) / 2, 0);
+
+        lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+        if (clickable) {
+            lv_obj_add_flag(row, LV_OBJ_FLAG_CLICKABLE);
+            lv_obj_add_event_cb(row, list_row_click_cb, LV_EVENT_CLICKED, view.get());
+        }
+        view->pool.push_back(row);
+        view->slotRow.push_back(INVALID_INDEX);
+    }
+
+    lv_obj_add_event_cb(cont, list_scroll_cb, LV_EVENT_SCROLL, view.get());
+
+    view->updateCount();
+    view->layout(true);
+
+    ElementDesc d;
+    d.id = id.c_str();
+    d.obj = cont;
+    d.visibleBind = contains(visible, '{') ? visible.c_str() : nullptr;
+    store_element(d);
+
+    LOG_I(Log::UI, "list: id=%s rowh=%d pool=%d rows=%d", id.c_str(), rowH, poolSize, (int)view->rows);
+    s_lists.push_back(std::move(view));
+}
+
+// ============ API ============
+
+namespace UI {
+namespace List {
+
+bool setSource(const char* id, P::Ptr<ListSource> source) {
+    auto* view = findList(id);
+    if (!view) return false;
+    view->source = std::move(source);
+    view->updateCount();
+    view->layout(true);
+    return true;
+}
+
+bool refresh(const char* id) {
+    auto* view = findList(id);
+    if (!view) return false;
+    view->updateCount();
+    view->layout(true);
+    return true;
+}
+
+bool scrollTo(const char* id, int row) {
+    auto* view = findList(id);
+    if (!view) return false;
+    if (row < 0) row = 0;
+    lv_obj_scroll_to_y(view->cont, (int32_t)row * view->rowH, LV_ANIM_OFF);
+    view->layout(false);
+    return true;
+}
+
+void onStateChange(const char* varname) {
+    if (s_lists.empty() || !strchr(varname, '[')) return;
+
+    P::String base, sub;
+    if (!Store::splitPath(varname, base, sub)) return;
+    int row = atoi(sub.c_str());
+
+    for (auto& v : s_lists) {
+        if (v->source && base == v->source->stateName()) {
+            v->rebindIfVisible(row);
+        }
+    }
+}
+
+void detachSources() {
+    for (auto& v : s_lists) {
+        if (v->source) v->source->detach();
+        v->updateCount();       // detached source counts 0
+        v->layout(true);        // hide rows still showing its data
+    }
+}
+
+void clear() {
+    s_lists.clear();
+}
+
+} // namespace List
+} // namespace UI
@@ -0,0 +1,65 @@
+#pragma once
+/**
+ * ui_list.h - Virtualized <list> widget
+ *
+ *   <list id="log" x="0" y="40" w="100%" h="400" rowh="32" for="items"
+ *         selected="selRow" onclick="onRow">{#}. {.}</list>
+ *
+ * Only visible rows + overscan exist as LVGL objects, recycled while
+ * scrolling (LVGL momentum scroll). Memory and per-frame cost do not
+ * depend on the number of rows.
+ *
+ * Data source: array state (for="items"), or set from script
+ * (ui.setList(id, table|csv) — see lua_ui.cpp).
+ *
+ * Row template: {#} row index (0-based), {.} whole item,
+ *               {.name} field by name, {.2} field by number (1-based).
+ */
+
+#include "utils/psram_alloc.h"
+#include <cstddef>
+
+typedef struct _lv_obj_t lv_obj_t;
+
+namespace UI {
+
+// ============ Data source ============
+
+class ListSource {
+public:
+    virtual ~ListSource() = default;
+
+    virtual size_t count() const = 0;
+
+    /// Field of a row: name "" = whole item, "2" = column number, else column name
+    virtual P::String field(size_t row, const P::String& name) const = 0;
+
+    /// Array state name when rows follow State (per-element refresh), else ""
+    virtual const char* stateName() const { return ""; }
+
+    /// Script VM is going away — drop references, report 0 rows
+    virtual void detach() {}
+};
+
+namespace List {
+
+/// Replace data source of list `id` (takes ownership). Rebinds visible rows.
+bool setSource(const char* id, P::Ptr<ListSource> source);
+
+/// Re-read count and visible rows (after in-place data changes)
+bool refresh(const char* id);
+
+/// Scroll so that `row` is at the top
+bool scrollTo(const char* id, int row);
+
+/// State element changed ("items[5]") — rebinds that row if visible
+void onStateChange(const char* varname);
+
+/// Script engine shutdown — detach all script-backed sources
+void detachSources();
+
+/// Drop all lists (LVGL objects are deleted with the screen)
+void clear();
+
+} // namespace List
+} // namespace UI
@@ -1,4 +1,5 @@
 #include "ui/ui_task.h"
+#include "core/computed.h"
 
 UpdateLabelTask::UpdateLabelTask(const P::String& labelId, const P::String& value)
     : m_labelId(labelId), m_value(value) {}
@@ -28,6 +29,12 @@ P::String UpdateBindingTask::key() const {
     return P::String("bind:") + m_varName.c_str();
 }
 
+void ComputedFlushTask::execute() {
+    Computed::flush([](const P::String& name, const P::String& value) {
+        ui_update_bindings(name.c_str(), value.c_str());
+    });
+}
+
 std::unique_ptr<ITask> makeUpdateLabel(const P::String& labelId, const P::String& value) {
     return std::make_unique<UpdateLabelTask>(labelId, value);
 }
@@ -35,3 +42,7 @@ std::unique_ptr<ITask> makeUpdateLabel(const P::String& labelId, const P::String
 std::unique_ptr<ITask> makeUpdateBinding(const P::String& varName, const P::String& value) {
     return std::make_unique<UpdateBindingTask>(varName, value);
 }
+
+std::unique_ptr<ITask> makeComputedFlush() {
+    return std::make_unique<ComputedFlushTask>();
+}
@@ -47,5 +47,15 @@ public:
     P::String key() const override;
 };
 
+/**
+ * ComputedFlushTask - пересчёт <computed> переменных, один раз за цикл задач
+ */
+class ComputedFlushTask : public ITask {
+public:
+    void execute() override;
+    P::String key() const override { return "computed"; }
+};
+
 std::unique_ptr<ITask> makeUpdateLabel(const P::String& labelId, const P::String& value);
 std::unique_ptr<ITask> makeUpdateBinding(const P::String& varName, const P::String& value);
+std::unique_ptr<ITask> makeComputedFlush();
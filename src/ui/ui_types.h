@@ -42,6 +42,8 @@ namespace Tag {
         constexpr const char* Markdown = "markdown";
         constexpr const char* Tabs = "tabs";
         constexpr const char* Tab = "tab";
+        constexpr const char* Repeat = "repeat";
+        constexpr const char* List = "list";
     }
     
     namespace TypeTag {
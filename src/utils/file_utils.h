@@ -3,11 +3,14 @@
  *
  * fs_exists() uses stat() instead of LittleFS.exists() to avoid
  * noisy VFS error logs for non-existent files.
+ * fs_stat() takes a LittleFS path and adds the VFS mount prefix itself.
  */
 
 #pragma once
 
 #include <sys/stat.h>
+#include <cstdio>
+#include <cstdint>
 
 /// Silent file existence check (no VFS error spam)
 inline bool fs_exists(const char* path) {
@@ -16,3 +19,14 @@ inline bool fs_exists(const char* path) {
     // stat() returns 0 on success, -1 on error (not found)
     return stat(path, &st) == 0;
 }
+
+/// Silent size + mtime of a LittleFS path ("/apps/x/x.bax"). false if missing.
+inline bool fs_stat(const char* path, uint32_t& size, uint32_t& mtime) {
+    char vfsPath[128];
+    snprintf(vfsPath, sizeof(vfsPath), "/littlefs%s", path);
+    struct stat st;
+    if (stat(vfsPath, &st) != 0) return false;
+    size = (uint32_t)st.st_size;
+    mtime = (uint32_t)st.st_mtime;
+    return true;
+}
@@ -0,0 +1,213 @@
+#include "utils/icon_cache.h"
+#include "utils/file_utils.h"
+#include "utils/psram_alloc.h"
+#include "utils/log_config.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <lz4.h>
+#include <cstring>
+
+// lodepng is compiled into LVGL — declare extern to use directly
+extern "C" {
+    unsigned lodepng_decode32(unsigned char** out, unsigned* w, unsigned* h,
+                              const unsigned char* in, size_t insize);
+}
+
+namespace IconCache {
+
+static const char* TAG = "IconCache";
+static constexpr uint32_t MAGIC = 0x314E4349;  // "ICN1"
+
+struct Header {
+    uint32_t magic;
+    uint32_t pngSize;
+    uint32_t pngMtime;
+    uint32_t pngHash;
+    uint16_t w;
+    uint16_t h;
+    uint8_t cf;                 // lv_color_format_t
+    uint8_t reserved[3];
+    uint32_t rawSize;
+    uint32_t compSize;          // == rawSize: stored uncompressed
+};
+
+static uint32_t fnv1a(const uint8_t* p, size_t len) {
+    uint32_t h = 2166136261u;
+    while (len--) h = (h ^ *p++) * 16777619u;
+    return h;
+}
+
+static P::String binPath(const char* pngPath) {
+    P::String path(pngPath);
+    size_t dot = path.rfind('.');
+    if (dot != P::String::npos) path.resize(dot);
+    return path + ".bin";
+}
+
+static uint8_t* readAll(const char* path, size_t& size) {
+    File f = LittleFS.open(path, "r");
+    if (!f) return nullptr;
+    size = f.size();
+    uint8_t* buf = (uint8_t*)ps_malloc(size ? size : 1);
+    if (buf) f.read(buf, size);
+    f.close();
+    return buf;
+}
+
+static void fill(lv_image_dsc_t& dsc, const Header& h, uint8_t* data) {
+    dsc = {};
+    dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    dsc.header.cf = h.cf;
+    dsc.header.w = h.w;
+    dsc.header.h = h.h;
+    dsc.header.stride = h.w * 2;
+    dsc.data = data;
+    dsc.data_size = h.rawSize;
+}
+
+// Cached pixels, or nullptr when the .bin is missing/stale
+static uint8_t* readCache(const P::String& path, uint32_t pngSize, uint32_t pngMtime,
+                          const char* pngPath, Header& h) {
+    File f = LittleFS.open(path.c_str(), "r");
+    if (!f) return nullptr;
+
+    if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h) || h.magic != MAGIC ||
+        h.pngSize != pngSize || h.compSize > h.rawSize ||
+        f.size() != sizeof(h) + h.compSize) {
+        f.close();
+        return nullptr;
+    }
+
+    // Same size, other mtime: trust content hash, then remember the mtime
+    if (h.pngMtime != pngMtime) {
+        f.close();
+        size_t len;
+        uint8_t* png = readAll(pngPath, len);
+        bool same = png && fnv1a(png, len) == h.pngHash;
+        free(png);
+        if (!same) return nullptr;
+        h.pngMtime = pngMtime;
+        f = LittleFS.open(path.c_str(), "r+");
+        if (!f) return nullptr;
+        f.write((const uint8_t*)&h, sizeof(h));  // leaves position at payload
+    }
+
+    uint8_t* raw = (uint8_t*)ps_malloc(h.rawSize);
+    uint8_t* comp = h.compSize < h.rawSize ? (uint8_t*)ps_malloc(h.compSize) : raw;
+    if (!raw || !comp) {
+        free(raw);
+        if (comp != raw) free(comp);
+        f.close();
+        return nullptr;
+    }
+
+    bool ok = f.read(comp, h.compSize) == h.compSize;
+    f.close();
+    if (ok && comp != raw) {
+        ok = LZ4_decompress_safe((const char*)comp, (char*)raw, h.compSize, h.rawSize) == (int)h.rawSize;
+        free(comp);
+    }
+    if (!ok) {
+        free(raw);
+        return nullptr;
+    }
+    return raw;
+}
+
+static void writeCache(const P::String& path, Header& h, const uint8_t* raw) {
+    int bound = LZ4_compressBound(h.rawSize);
+    char* comp = (char*)ps_malloc(bound);
+    // State on heap: the default 16 KB stack table would overflow loopTask
+    void* state = ps_malloc(LZ4_sizeofState());
+    int n = 0;
+    if (comp && state) {
+        n = LZ4_compress_fast_extState(state, (const char*)raw, comp, h.rawSize, bound, 1);
+    }
+    free(state);
+
+    const uint8_t* payload = raw;
+    h.compSize = h.rawSize;
+    if (n > 0 && (uint32_t)n < h.rawSize) {
+        payload = (const uint8_t*)comp;
+        h.compSize = n;
+    }
+
+    File f = LittleFS.open(path.c_str(), "w");
+    if (f) {
+        f.write((const uint8_t*)&h, sizeof(h));
+        f.write(payload, h.compSize);
+        f.close();
+        LOG_D(Log::APP, "Cached %s (%u -> %u bytes)", path.c_str(), (unsigned)h.rawSize, (unsigned)h.compSize);
+    } else {
+        LOG_W(Log::APP, "Cannot write %s", path.c_str());
+    }
+    free(comp);
+}
+
+static uint8_t* decode(const char* pngPath, Header& h) {
+    size_t len;
+    uint8_t* png = readAll(pngPath, len);
+    if (!png) return nullptr;
+
+    unsigned char* pixels = nullptr;
+    unsigned w, hgt;
+    unsigned error = lodepng_decode32(&pixels, &w, &hgt, png, len);
+    h.pngHash = fnv1a(png, len);
+    free(png);
+    if (error || !pixels) {
+        LOG_W(Log::APP, "PNG decode failed: %s (%u)", pngPath, error);
+        return nullptr;
+    }
+
+    size_t count = (size_t)w * hgt;
+    bool alpha = false;
+    for (size_t i = 0; i < count && !alpha; i++) alpha = pixels[i * 4 + 3] != 0xFF;
+
+    h.w = w;
+    h.h = hgt;
+    h.cf = alpha ? LV_COLOR_FORMAT_RGB565A8 : LV_COLOR_FORMAT_RGB565;
+    h.rawSize = count * (alpha ? 3 : 2);
+
+    uint8_t* out = (uint8_t*)ps_malloc(h.rawSize);
+    if (out) {
+        // RGB565A8: color plane, then alpha plane
+        uint16_t* dst = (uint16_t*)out;
+        uint8_t* a8 = out + count * 2;
+        const uint8_t* src = pixels;
+        for (size_t i = 0; i < count; i++, src += 4) {
+            dst[i] = ((src[0] >> 3) << 11) | ((src[1] >> 2) << 5) | (src[2] >> 3);
+            if (alpha) a8[i] = src[3];
+        }
+    }
+    lv_free(pixels);
+    return out;
+}
+
+bool load(const char* pngPath, lv_image_dsc_t& dsc, uint8_t*& data) {
+    uint32_t pngSize, pngMtime;
+    if (!fs_stat(pngPath, pngSize, pngMtime)) return false;
+
+    P::String path = binPath(pngPath);
+    Header h = {};
+    uint8_t* pixels = readCache(path, pngSize, pngMtime, pngPath, h);
+    if (!pixels) {
+        h = {};
+        pixels = decode(pngPath, h);
+        if (!pixels) return false;
+        h.magic = MAGIC;
+        h.pngSize = pngSize;
+        h.pngMtime = pngMtime;
+        writeCache(path, h, pixels);
+    }
+
+    fill(dsc, h, pixels);
+    data = pixels;
+    return true;
+}
+
+void invalidate(const char* pngPath) {
+    P::String path = binPath(pngPath);
+    if (fs_exists((P::String("/littlefs") + path).c_str())) LittleFS.remove(path.c_str());
+}
+
+} // namespace IconCache
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <lvgl.h>
+
+/**
+ * IconCache — PNG icons decoded once, stored next to the PNG as .bin.
+ *
+ *   /apps/calc/icon.png  ->  /apps/calc/icon.bin
+ *
+ * .bin = header (PNG size, mtime, FNV-1a hash, w/h/cf) + LZ4 block of
+ * RGB565 (LV_COLOR_FORMAT_RGB565) or RGB565 + A8 plane when the PNG has
+ * transparency (LV_COLOR_FORMAT_RGB565A8).
+ *
+ * Validation is stat()-only while PNG size and mtime match; an mtime change
+ * with the same size re-hashes the PNG before decoding again.
+ */
+namespace IconCache {
+
+/// Load icon into a PSRAM buffer (caller frees with free()).
+/// path: LittleFS path of the PNG (without "C:").
+bool load(const char* pngPath, lv_image_dsc_t& dsc, uint8_t*& data);
+
+/// PNG was replaced — drop its .bin
+void invalidate(const char* pngPath);
+
+} // namespace IconCache
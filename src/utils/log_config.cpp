@@ -4,19 +4,15 @@
 namespace Log {
 
 // Defaults: Info для основных, Warn для шумных
-static Level s_levels[COUNT] = { Info, Info, Info, Info, Info };
+Level g_levels[COUNT] = { Info, Info, Info, Info, Info };
 // All categories default to Info
 
 void set(Cat cat, Level lvl) {
-    if (cat < COUNT) s_levels[cat] = lvl;
+    if (cat < COUNT) g_levels[cat] = lvl;
 }
 
 void setAll(Level lvl) {
-    for (int i = 0; i < COUNT; i++) s_levels[i] = lvl;
-}
-
-Level get(Cat cat) {
-    return (cat < COUNT) ? s_levels[cat] : Disabled;
+    for (int i = 0; i < COUNT; i++) g_levels[i] = lvl;
 }
 
 const char* catName(Cat cat) {
@@ -69,7 +65,7 @@ static bool isLevel(const char* s) {
 static void print() {
     log_printf("[Log]\r\n");
     for (int i = 0; i < COUNT; i++) {
-        log_printf("  %s = %s\r\n", catName((Cat)i), levelName(s_levels[i]));
+        log_printf("  %s = %s\r\n", catName((Cat)i), levelName(g_levels[i]));
     }
 }
 
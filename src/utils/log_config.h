@@ -2,6 +2,31 @@
 
 #include <cstdint>
 
+// ============================================================
+// Compile-time floor per category (0..5 = Disabled..Verbose).
+// Calls above the floor compile to nothing, format strings included:
+//   -DLOG_MIN_LEVEL=3      всё выше Info вырезано
+//   -DLOG_MIN_UI=2         UI: только Error/Warn
+// ============================================================
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 5
+#endif
+#ifndef LOG_MIN_UI
+#define LOG_MIN_UI LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LUA
+#define LOG_MIN_LUA LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_STATE
+#define LOG_MIN_STATE LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_APP
+#define LOG_MIN_APP LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_BLE
+#define LOG_MIN_BLE LOG_MIN_LEVEL
+#endif
+
 namespace Log {
 
 enum Cat : uint8_t { 
@@ -22,9 +47,14 @@ enum Level : uint8_t {
     Verbose 
 };
 
+constexpr uint8_t MIN_LEVELS[COUNT] = { LOG_MIN_UI, LOG_MIN_LUA, LOG_MIN_STATE, LOG_MIN_APP, LOG_MIN_BLE };
+
+// Runtime levels (inline check in LOG_*, no call)
+extern Level g_levels[COUNT];
+
 void set(Cat cat, Level lvl);
 void setAll(Level lvl);
-Level get(Cat cat);
+inline Level get(Cat cat) { return (cat < COUNT) ? g_levels[cat] : Disabled; }
 
 const char* catName(Cat cat);
 const char* levelName(Level lvl);
@@ -60,12 +90,22 @@ int log_printf(const char *fmt, ...);
 #define OS_LOGV(tag, fmt, ...) OS_LOG("V", tag, fmt, ##__VA_ARGS__)
 
 // ============================================================
-// LOG_* — категорийные макросы с runtime-фильтрацией.
+// LOG_* — категорийные макросы: compile-time floor + runtime level.
+// Deferred mode (log deferred on) пишет бинарную запись в ring
+// вместо printf — см. utils/log_ring.h.
 // Использование: LOG_I(Log::UI, "loaded %d widgets", count);
 // ============================================================
 
-#define LOG_E(cat, fmt, ...) do { if (Log::get(cat) >= Log::Error)   OS_LOGE(TAG, fmt, ##__VA_ARGS__); } while(0)
-#define LOG_W(cat, fmt, ...) do { if (Log::get(cat) >= Log::Warn)    OS_LOGW(TAG, fmt, ##__VA_ARGS__); } while(0)
-#define LOG_I(cat, fmt, ...) do { if (Log::get(cat) >= Log::Info)    OS_LOGI(TAG, fmt, ##__VA_ARGS__); } while(0)
-#define LOG_D(cat, fmt, ...) do { if (Log::get(cat) >= Log::Debug)   OS_LOGD(TAG, fmt, ##__VA_ARGS__); } while(0)
-#define LOG_V(cat, fmt, ...) do { if (Log::get(cat) >= Log::Verbose) OS_LOGV(TAG, fmt, ##__VA_ARGS__); } while(0)
+#include "utils/log_ring.h"
+
+#define LOG_AT(lvl, letter, cat, fmt, ...) do { \
+    if (Log::MIN_LEVELS[cat] >= (lvl) && Log::g_levels[cat] >= (lvl)) { \
+        if (Log::deferred()) Log::record((lvl), (cat), TAG, fmt, ##__VA_ARGS__); \
+        else OS_LOG(letter, TAG, fmt, ##__VA_ARGS__); \
+    } } while(0)
+
+#define LOG_E(cat, fmt, ...) LOG_AT(Log::Error,   "E", cat, fmt, ##__VA_ARGS__)
+#define LOG_W(cat, fmt, ...) LOG_AT(Log::Warn,    "W", cat, fmt, ##__VA_ARGS__)
+#define LOG_I(cat, fmt, ...) LOG_AT(Log::Info,    "I", cat, fmt, ##__VA_ARGS__)
+#define LOG_D(cat, fmt, ...) LOG_AT(Log::Debug,   "D", cat, fmt, ##__VA_ARGS__)
+#define LOG_V(cat, fmt, ...) LOG_AT(Log::Verbose, "V", cat, fmt, ##__VA_ARGS__)
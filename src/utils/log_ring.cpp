@@ -0,0 +1,262 @@
+#include "utils/log_config.h"
+#include <esp_heap_caps.h>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Log {
+
+bool g_deferred = false;
+Slot* g_ring = nullptr;
+std::atomic<uint32_t> g_head{0};
+
+static uint32_t s_tail = 0;
+static uint32_t s_dropped = 0;
+static uint32_t s_droppedShown = 0;
+
+// Plain copy of a committed slot
+struct Rec {
+    uint32_t ms;
+    const char* fmt;
+    const char* tag;
+    uint8_t level;
+    uint8_t nargs;
+    uint8_t used;
+    uint8_t types[SLOT_ARGS];
+    uint8_t data[SLOT_DATA];
+};
+
+uint32_t nowMs() {
+    return (uint32_t)(esp_timer_get_time() / 1000ULL);
+}
+
+bool setDeferred(bool on) {
+    if (on && !g_ring) {
+        size_t bytes = RING_SLOTS * sizeof(Slot);
+        g_ring = (Slot*)heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM);
+        if (!g_ring) g_ring = (Slot*)heap_caps_calloc(1, bytes, MALLOC_CAP_DEFAULT);
+        if (!g_ring) return false;
+        s_tail = g_head.load(std::memory_order_relaxed);
+    }
+    g_deferred = on;
+    return true;
+}
+
+uint32_t dropped() {
+    return s_dropped;
+}
+
+// 1 = copied, 0 = not committed yet, -1 = overwritten by a newer record
+static int readSlot(uint32_t idx, Rec& r) {
+    const Slot& s = g_ring[idx & (RING_SLOTS - 1)];
+    uint32_t seq = s.seq.load(std::memory_order_acquire);
+    if (seq != idx + 1) return (seq && (int32_t)(seq - (idx + 1)) > 0) ? -1 : 0;
+
+    r.ms = s.ms;
+    r.fmt = s.fmt;
+    r.tag = s.tag;
+    r.level = s.level;
+    r.nargs = s.nargs;
+    r.used = s.used;
+    memcpy(r.types, s.types, sizeof(r.types));
+    memcpy(r.data, s.data, sizeof(r.data));
+
+    // Writer may have lapped us while copying
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s.seq.load(std::memory_order_relaxed) == seq ? 1 : -1;
+}
+
+// ---- printf replay ----
+
+struct ArgReader {
+    const Rec& r;
+    uint8_t i = 0;
+    uint8_t off = 0;
+
+    bool next(uint8_t& type, const uint8_t*& p, uint8_t& len) {
+        if (i >= r.nargs) return false;
+        type = r.types[i++];
+        p = r.data + off;
+        switch (type) {
+            case ArgStr:    len = *p++; off += 1 + len; break;
+            case ArgInt64:
+            case ArgDouble: len = 8; off += 8; break;
+            default:        len = 4; off += 4; break;
+        }
+        return true;
+    }
+};
+
+static bool isIntConv(char c) { return strchr("diouxXc", c) != nullptr; }
+static bool isFloatConv(char c) { return strchr("fFeEgGaA", c) != nullptr; }
+
+// Re-applies each conversion to its stored arg. Length modifiers in fmt
+// are replaced by the stored width, so %lu / %zu / %lld all decode.
+static void format(const Rec& r, char* out, size_t cap) {
+    ArgReader args{r};
+    size_t n = 0;
+    const char* f = r.fmt ? r.fmt : "(null)";
+
+    auto emit = [&](int written) {
+        if (written > 0) n += (size_t)written;
+        if (n >= cap) n = cap - 1;
+    };
+
+    while (*f && n + 1 < cap) {
+        if (*f != '%') { out[n++] = *f++; continue; }
+        if (f[1] == '%') { out[n++] = '%'; f += 2; continue; }
+
+        // %[flags][width][.prec][len]conv
+        char spec[24];
+        size_t k = 0;
+        spec[k++] = *f++;
+        while (*f && strchr("-+ #0", *f) && k < 8) spec[k++] = *f++;
+        for (int part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*f != '.') break;
+                spec[k++] = *f++;
+            }
+            if (*f == '*') {
+                // '*' consumed an int arg at record time
+                uint8_t t, len; const uint8_t* p;
+                int32_t v = 0;
+                if (args.next(t, p, len) && t == ArgInt) memcpy(&v, p, 4);
+                int w = snprintf(spec + k, 8, "%d", (int)v);
+                k += (w > 0 && w < 8) ? w : 0;
+                f++;
+            } else {
+                while (*f >= '0' && *f <= '9') {
+                    if (k < 18) spec[k++] = *f;
+                    f++;
+                }
+            }
+        }
+        while (*f && strchr("hljztL", *f)) f++;
+        char conv = *f ? *f++ : 's';
+
+        uint8_t type, len;
+        const uint8_t* p;
+        if (!args.next(type, p, len)) {
+            emit(snprintf(out + n, cap - n, "<?>"));
+            continue;
+        }
+
+        switch (type) {
+            case ArgInt: {
+                int32_t v;
+                memcpy(&v, p, 4);
+                if (!isIntConv(conv)) conv = 'd';
+                spec[k++] = conv; spec[k] = 0;
+                if (conv == 'd' || conv == 'i' || conv == 'c') emit(snprintf(out + n, cap - n, spec, (int)v));
+                else emit(snprintf(out + n, cap - n, spec, (unsigned)v));
+                break;
+            }
+            case ArgInt64: {
+                int64_t v;
+                memcpy(&v, p, 8);
+                if (!isIntConv(conv) || conv == 'c') conv = 'd';
+                spec[k++] = 'l'; spec[k++] = 'l'; spec[k++] = conv; spec[k] = 0;
+                if (conv == 'd' || conv == 'i') emit(snprintf(out + n, cap - n, spec, (long long)v));
+                else emit(snprintf(out + n, cap - n, spec, (unsigned long long)v));
+                break;
+            }
+            case ArgDouble: {
+                double v;
+                memcpy(&v, p, 8);
+                if (!isFloatConv(conv)) conv = 'g';
+                spec[k++] = conv; spec[k] = 0;
+                emit(snprintf(out + n, cap - n, spec, v));
+                break;
+            }
+            case ArgStr: {
+                char s[SLOT_DATA + 1];
+                memcpy(s, p, len);
+                s[len] = 0;
+                spec[k++] = 's'; spec[k] = 0;
+                emit(snprintf(out + n, cap - n, spec, s));
+                break;
+            }
+            default: {
+                uint32_t v;
+                memcpy(&v, p, 4);
+                emit(snprintf(out + n, cap - n, conv == 'p' ? "0x%08x" : "%u", (unsigned)v));
+                break;
+            }
+        }
+    }
+    out[n] = 0;
+}
+
+void drain(int maxRecords) {
+    if (!g_ring) return;
+
+    uint32_t head = g_head.load(std::memory_order_acquire);
+    if (head - s_tail > RING_SLOTS) {
+        s_dropped += head - s_tail - RING_SLOTS;
+        s_tail = head - RING_SLOTS;
+    }
+
+    static const char LETTERS[] = "-EWIDV";
+    char line[192];
+    Rec r;
+    while (maxRecords-- > 0 && s_tail != head) {
+        int res = readSlot(s_tail, r);
+        if (res == 0) break;          // still being written
+        if (res < 0) {                // lapped: oldest record is gone
+            s_dropped++;
+            s_tail++;
+            continue;
+        }
+        format(r, line, sizeof(line));
+        log_printf("[%6u][%c][%s] %s\r\n", (unsigned)r.ms,
+                   LETTERS[r.level <= Verbose ? r.level : 0], r.tag ? r.tag : "?", line);
+        s_tail++;
+    }
+
+    if (s_dropped != s_droppedShown) {
+        OS_LOGW("Log", "%u records dropped (ring full)", (unsigned)(s_dropped - s_droppedShown));
+        s_droppedShown = s_dropped;
+    }
+}
+
+// ---- dump for tools/log_decode.py ----
+
+struct DumpHeader {
+    char magic[4];      // "BLOG"
+    uint16_t version;
+    uint16_t slotSize;
+    uint32_t count;
+    uint32_t dropped;
+};
+
+uint8_t* dump(uint32_t& size) {
+    size = 0;
+    if (!g_ring) return nullptr;
+
+    uint32_t head = g_head.load(std::memory_order_acquire);
+    uint32_t from = head > RING_SLOTS ? head - RING_SLOTS : 0;
+    size_t cap = sizeof(DumpHeader) + (size_t)(head - from) * sizeof(Slot);
+    uint8_t* buf = (uint8_t*)heap_caps_malloc(cap, MALLOC_CAP_SPIRAM);
+    if (!buf) buf = (uint8_t*)heap_caps_malloc(cap, MALLOC_CAP_DEFAULT);
+    if (!buf) return nullptr;
+
+    // Last RING_SLOTS committed records, drained or not
+    uint32_t count = 0;
+    uint8_t* out = buf + sizeof(DumpHeader);
+    for (uint32_t idx = from; idx != head; idx++) {
+        const Slot& s = g_ring[idx & (RING_SLOTS - 1)];
+        uint32_t seq = s.seq.load(std::memory_order_acquire);
+        if (seq != idx + 1) continue;
+        memcpy(out, (const void*)&s, sizeof(Slot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != seq) continue;
+        out += sizeof(Slot);
+        count++;
+    }
+
+    DumpHeader h = {{'B', 'L', 'O', 'G'}, 1, (uint16_t)sizeof(Slot), count, s_dropped};
+    memcpy(buf, &h, sizeof(h));
+    size = sizeof(DumpHeader) + count * sizeof(Slot);
+    return buf;
+}
+
+} // namespace Log
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Deferred binary log — LOG_* in hot paths without formatting or UART.
+ *
+ * With deferred mode on, LOG_x stores {timestamp, fmt ptr, TAG ptr, raw args}
+ * in a fixed-slot PSRAM ring (lock-free, multi-producer: one fetch_add per
+ * record). fmt/TAG are string literals, so only their flash addresses are
+ * kept; %s arguments are copied (truncated) because they may not outlive
+ * the call.
+ *
+ * The main loop drains the ring to Serial as text (Log::drain); "log dump"
+ * returns raw slots for tools/log_decode.py, which resolves pointers from
+ * the firmware ELF. When the ring laps the reader, oldest records are lost
+ * and counted.
+ */
+namespace Log {
+
+enum ArgType : uint8_t { ArgInt = 'i', ArgInt64 = 'I', ArgDouble = 'd', ArgStr = 's', ArgPtr = 'p' };
+
+static constexpr uint32_t RING_SLOTS = 1024;     // power of two
+static constexpr size_t SLOT_ARGS = 8;
+static constexpr size_t SLOT_DATA = 36;
+
+/// 64-byte record. Layout is read by tools/log_decode.py — keep in sync.
+struct Slot {
+    std::atomic<uint32_t> seq;  // index + 1 when committed, 0 while written
+    uint32_t ms;
+    const char* fmt;            // string literal (flash)
+    const char* tag;            // file TAG (flash)
+    uint8_t level;
+    uint8_t cat;
+    uint8_t nargs;
+    uint8_t used;               // bytes of data
+    uint8_t types[SLOT_ARGS];
+    uint8_t data[SLOT_DATA];
+};
+static_assert(sizeof(void*) != 4 || sizeof(Slot) == 64, "Slot layout is shared with the host decoder");
+
+extern bool g_deferred;
+extern Slot* g_ring;
+extern std::atomic<uint32_t> g_head;
+
+inline bool deferred() { return g_deferred; }
+
+/// Enable/disable deferred mode (allocates the ring on first enable)
+bool setDeferred(bool on);
+
+/// Format up to maxRecords pending records to Serial. Main loop.
+void drain(int maxRecords);
+
+/// Copy of pending records for the host decoder (caller frees with free())
+uint8_t* dump(uint32_t& size);
+
+/// Records lost because the ring was lapped
+uint32_t dropped();
+
+// ---- encoding (inline, no formatting) ----
+
+struct ArgWriter {
+    Slot& s;
+    void raw(uint8_t type, const void* p, size_t n) {
+        if (s.nargs >= SLOT_ARGS || s.used + n > SLOT_DATA) {
+            s.used = SLOT_DATA;  // drop the rest too: later args must not shift
+            return;
+        }
+        s.types[s.nargs++] = type;
+        memcpy(s.data + s.used, p, n);
+        s.used += n;
+    }
+    void str(const char* v) {
+        if (!v) v = "(null)";
+        if (s.nargs >= SLOT_ARGS || s.used >= SLOT_DATA) return;
+        size_t room = SLOT_DATA - s.used - 1;
+        size_t n = strnlen(v, room);
+        s.types[s.nargs++] = ArgStr;
+        s.data[s.used++] = (uint8_t)n;
+        memcpy(s.data + s.used, v, n);
+        s.used += n;
+    }
+    template<typename T>
+    void put(T v) {
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+            str(v);
+        } else if constexpr (std::is_floating_point_v<D>) {
+            double d = v;
+            raw(ArgDouble, &d, sizeof(d));
+        } else if constexpr (std::is_pointer_v<D>) {
+            uint32_t p = (uint32_t)(uintptr_t)v;
+            raw(ArgPtr, &p, sizeof(p));
+        } else if constexpr (sizeof(D) > 4) {
+            int64_t i = (int64_t)v;
+            raw(ArgInt64, &i, sizeof(i));
+        } else {
+            int32_t i = (int32_t)v;
+            raw(ArgInt, &i, sizeof(i));
+        }
+    }
+};
+
+uint32_t nowMs();
+
+template<typename... Args>
+inline void record(uint8_t level, uint8_t cat, const char* tag, const char* fmt, Args... args) {
+    uint32_t idx = g_head.fetch_add(1, std::memory_order_relaxed);
+    Slot& s = g_ring[idx & (RING_SLOTS - 1)];
+    s.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.ms = nowMs();
+    s.fmt = fmt;
+    s.tag = tag;
+    s.level = level;
+    s.cat = cat;
+    s.nargs = 0;
+    s.used = 0;
+    ArgWriter w{s};
+    (w.put(args), ...);
+    s.seq.store(idx + 1, std::memory_order_release);
+}
+
+} // namespace Log
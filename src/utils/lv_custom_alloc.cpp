@@ -9,9 +9,12 @@
  *
  * Small allocs (draw temps, masks) → DRAM (fast)
  * Large allocs (objects, styles, text) → PSRAM (unlimited)
+ *
+ * Everything is charged to MemTags::Lvgl ("mem show").
  */
 
 #include "esp_heap_caps.h"
+#include "utils/mem_tags.h"
 #include <cstring>
 
 /// Threshold: allocs up to this size try DRAM first
@@ -32,25 +35,25 @@ void* lv_malloc_core(size_t size) {
 
     // Small allocs → try fast DRAM first
     if (size <= DRAM_THRESHOLD) {
-        void* p = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        void* p = MemTags::alloc(MemTags::Lvgl, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
         if (p) return p;
         // DRAM full → fallback to PSRAM
     }
 
     // Large allocs (or DRAM fallback) → PSRAM
-    return heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    return MemTags::alloc(MemTags::Lvgl, size, MALLOC_CAP_SPIRAM);
 }
 
 void* lv_realloc_core(void* p, size_t new_size) {
     if (!p) return lv_malloc_core(new_size);
-    if (new_size == 0) { heap_caps_free(p); return nullptr; }
+    if (new_size == 0) { MemTags::free(p); return nullptr; }
 
     // Try in-place first. MALLOC_CAP_8BIT covers both DRAM and PSRAM.
-    return heap_caps_realloc(p, new_size, MALLOC_CAP_8BIT);
+    return MemTags::realloc(p, new_size, MALLOC_CAP_8BIT);
 }
 
 void lv_free_core(void* p) {
-    heap_caps_free(p);  // works for both DRAM and PSRAM
+    MemTags::free(p);  // works for both DRAM and PSRAM
 }
 
 } // extern "C"
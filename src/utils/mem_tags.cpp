@@ -0,0 +1,156 @@
+#include "utils/mem_tags.h"
+#include "utils/log_config.h"
+#include <esp_heap_caps.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char* TAG = "MemTags";
+
+namespace MemTags {
+
+Counter g_counters[COUNT];
+
+static const char* const NAMES[COUNT] = {
+    "other", "lvgl", "lua", "store", "ui", "json", "csv", "ble", "screenshot"
+};
+
+const char* name(Tag t) {
+    return t < COUNT ? NAMES[t] : "?";
+}
+
+// ---- Tagged blocks ----
+
+#if MEM_TAGS
+
+static constexpr size_t HEADER = sizeof(uint32_t);
+static constexpr uint32_t SIZE_MASK = (1u << 28) - 1;
+
+static void* rawAlloc(size_t size, uint32_t caps) {
+    return caps ? heap_caps_malloc(size, caps) : ::malloc(size);
+}
+
+static void* rawRealloc(void* p, size_t size, uint32_t caps) {
+    return caps ? heap_caps_realloc(p, size, caps) : ::realloc(p, size);
+}
+
+void* alloc(Tag t, size_t size, uint32_t caps) {
+    if (size > SIZE_MASK) return nullptr;
+    uint32_t* h = (uint32_t*)rawAlloc(size + HEADER, caps);
+    if (!h) return nullptr;
+    *h = ((uint32_t)t << 28) | (uint32_t)size;
+    charge(t, size);
+    return h + 1;
+}
+
+void* realloc(void* p, size_t size, uint32_t caps) {
+    if (!p) return alloc(t_current, size, caps);
+    if (size > SIZE_MASK) return nullptr;
+    uint32_t* h = (uint32_t*)p - 1;
+    Tag t = (Tag)(*h >> 28);
+    size_t old = *h & SIZE_MASK;
+    h = (uint32_t*)rawRealloc(h, size + HEADER, caps);
+    if (!h) return nullptr;
+    *h = ((uint32_t)t << 28) | (uint32_t)size;
+    resize(t, old, size);
+    return h + 1;
+}
+
+void free(void* p) {
+    if (!p) return;
+    uint32_t* h = (uint32_t*)p - 1;
+    discharge((Tag)(*h >> 28), *h & SIZE_MASK);
+    ::free(h);     // heap_caps_free() for any caps
+}
+
+#else
+
+void* alloc(Tag, size_t size, uint32_t caps) {
+    return caps ? heap_caps_malloc(size, caps) : ::malloc(size);
+}
+
+void* realloc(void* p, size_t size, uint32_t caps) {
+    return caps ? heap_caps_realloc(p, size, caps) : ::realloc(p, size);
+}
+
+void free(void* p) {
+    ::free(p);
+}
+
+#endif
+
+// ---- Snapshots ----
+
+Snapshot snapshot() {
+    Snapshot s;
+    for (int i = 0; i < COUNT; i++) {
+        s.bytes[i] = g_counters[i].bytes.load(std::memory_order_relaxed);
+        s.blocks[i] = g_counters[i].blocks.load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+static Snapshot diff(const Snapshot& now, const Snapshot& then) {
+    Snapshot d;
+    for (int i = 0; i < COUNT; i++) {
+        d.bytes[i] = now.bytes[i] - then.bytes[i];
+        d.blocks[i] = now.blocks[i] - then.blocks[i];
+    }
+    return d;
+}
+
+void resetPeaks() {
+    for (auto& c : g_counters) {
+        c.peak.store(c.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        c.allocs.store(0, std::memory_order_relaxed);
+    }
+}
+
+static Snapshot s_mark;
+static bool s_marked = false;
+
+void mark() {
+    s_mark = snapshot();
+    s_marked = true;
+}
+
+bool marked() {
+    return s_marked;
+}
+
+Snapshot sinceMark() {
+    return diff(snapshot(), s_mark);
+}
+
+// ---- Leak check across app runs ----
+
+static Snapshot s_launcher;
+static bool s_haveLauncher = false;
+static Cycle s_cycle;
+
+void launcherCheckpoint(const char* leftApp) {
+    Snapshot now = snapshot();
+    if (s_haveLauncher && leftApp && leftApp[0]) {
+        s_cycle.count++;
+        strncpy(s_cycle.app, leftApp, sizeof(s_cycle.app) - 1);
+        s_cycle.delta = diff(now, s_launcher);
+
+        char line[192];
+        size_t n = 0;
+        for (int i = 0; i < COUNT && n < sizeof(line); i++) {
+            if (s_cycle.delta.bytes[i] <= 0) continue;
+            n += snprintf(line + n, sizeof(line) - n, " %s +%d/%d", NAMES[i],
+                          (int)s_cycle.delta.bytes[i], (int)s_cycle.delta.blocks[i]);
+        }
+        if (n) LOG_W(Log::APP, "Leak check %s: grew%s (bytes/blocks)", leftApp, line);
+        else LOG_I(Log::APP, "Leak check %s: no growth", leftApp);
+    }
+    s_launcher = now;
+    s_haveLauncher = true;
+}
+
+const Cycle& lastCycle() {
+    return s_cycle;
+}
+
+} // namespace MemTags
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * MemTags — allocation accounting by subsystem ("mem" console command)
+ *
+ * Every P:: / M:: container, LVGL (lv_custom_alloc), Lua (lua_psram_alloc),
+ * ArduinoJson (PsramAllocator) and the screenshot / BLE buffers report to a
+ * tag: bytes in use, peak, live blocks, allocations since reset.
+ *
+ * Blocks from alloc() carry a 4-byte header {tag:4, size:28} in front of the
+ * data — ESP heap blocks are 4-byte aligned, so alignment is unchanged, and
+ * free() charges the tag the block was allocated under. Such blocks must be
+ * freed with MemTags::free(), never heap_caps_free(). Lua passes the old size
+ * itself and is counted without a header.
+ *
+ * Generic containers take the tag of the innermost MemTags::Scope on the
+ * allocating task (Other outside any scope):
+ *
+ *   void Store::set(...) {
+ *       MEM_SCOPE(Store);
+ *       ...
+ *   }
+ *
+ * A scope skipped by longjmp (luaL_error) leaves its tag current until the
+ * enclosing scope closes — every Lua entry point (execute, call, timer and
+ * fetch callbacks) opens a Lua scope for that reason.
+ *
+ * Counting is a few relaxed atomics per allocation. -DMEM_TAGS=0 in
+ * build_flags drops the header and the counters.
+ */
+
+#ifndef MEM_TAGS
+#define MEM_TAGS 1
+#endif
+
+namespace MemTags {
+
+enum Tag : uint8_t {
+    Other,          // untagged P:: / M:: containers
+    Lvgl,
+    Lua,
+    Store,          // State::Store variables
+    Ui,             // HTML parse, elements, bindings
+    Json,           // PsramJsonDoc
+    Csv,
+    Ble,
+    Screenshot,
+    COUNT
+};
+
+struct Counter {
+    std::atomic<int32_t>  bytes{0};     // requested size, without header / heap overhead
+    std::atomic<int32_t>  peak{0};
+    std::atomic<int32_t>  blocks{0};
+    std::atomic<uint32_t> allocs{0};    // since boot / resetPeaks()
+};
+
+extern Counter g_counters[COUNT];
+inline thread_local Tag t_current = Other;
+
+const char* name(Tag t);
+
+inline void charge(Tag t, size_t bytes) {
+#if MEM_TAGS
+    Counter& c = g_counters[t];
+    int32_t now = c.bytes.fetch_add((int32_t)bytes, std::memory_order_relaxed) + (int32_t)bytes;
+    if (now > c.peak.load(std::memory_order_relaxed)) c.peak.store(now, std::memory_order_relaxed);
+    c.blocks.fetch_add(1, std::memory_order_relaxed);
+    c.allocs.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+inline void discharge(Tag t, size_t bytes) {
+#if MEM_TAGS
+    Counter& c = g_counters[t];
+    c.bytes.fetch_sub((int32_t)bytes, std::memory_order_relaxed);
+    c.blocks.fetch_sub(1, std::memory_order_relaxed);
+#endif
+}
+
+/// Block grew or shrank in place (realloc)
+inline void resize(Tag t, size_t from, size_t to) {
+#if MEM_TAGS
+    Counter& c = g_counters[t];
+    int32_t delta = (int32_t)to - (int32_t)from;
+    int32_t now = c.bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (now > c.peak.load(std::memory_order_relaxed)) c.peak.store(now, std::memory_order_relaxed);
+#endif
+}
+
+/// heap_caps_malloc(size, caps) charged to t; caps 0 = plain malloc(). No fallback.
+void* alloc(Tag t, size_t size, uint32_t caps);
+inline void* alloc(size_t size, uint32_t caps) { return alloc(t_current, size, caps); }
+/// Keeps the block's tag; nullptr leaves p untouched
+void* realloc(void* p, size_t size, uint32_t caps);
+void free(void* p);
+
+class Scope {
+public:
+    explicit Scope(Tag t) : m_prev(t_current) { t_current = t; }
+    ~Scope() { t_current = m_prev; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Tag m_prev;
+};
+
+struct Snapshot {
+    int32_t bytes[COUNT];
+    int32_t blocks[COUNT];
+};
+
+Snapshot snapshot();
+void resetPeaks();              // peak = current, allocs = 0
+
+/// Manual leak check: "mem mark", then "mem diff"
+void mark();
+bool marked();
+Snapshot sinceMark();
+
+/// Automatic leak check: launcher shown with no app alive (not suspended).
+/// Each call after an app compares against the previous one.
+struct Cycle {
+    uint32_t count = 0;         // app runs compared
+    char app[48] = {};          // last app
+    Snapshot delta = {};        // launcher -> app -> launcher
+};
+
+void launcherCheckpoint(const char* leftApp);
+const Cycle& lastCycle();
+
+} // namespace MemTags
+
+#if MEM_TAGS
+#define MEM_CONCAT_(a, b) a##b
+#define MEM_CONCAT(a, b) MEM_CONCAT_(a, b)
+#define MEM_SCOPE(tag) MemTags::Scope MEM_CONCAT(_memScope, __LINE__)(MemTags::tag)
+#else
+#define MEM_SCOPE(tag) do {} while (0)
+#endif
@@ -0,0 +1,269 @@
+#include "utils/mirror.h"
+#include "hal/display_hal.h"
+#include "console/serial_frame.h"
+#include "utils/log_config.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <lz4.h>
+
+static const char* TAG = "Mirror";
+
+namespace Mirror {
+
+static_assert(STRIP_BYTES >= SCREEN_WIDTH * 2, "strip must hold one screen row");
+
+static constexpr size_t HEAD = 10;        // x, y, w, rows, flags, 0
+
+struct Rect { int16_t x1, y1, x2, y2; };  // inclusive, like lv_area_t
+
+static bool      s_active = false;
+static uint16_t* s_shadow = nullptr;      // SCREEN_WIDTH x SCREEN_HEIGHT RGB565 (PSRAM)
+static uint8_t*  s_strip = nullptr;       // strip rows gathered from the shadow
+static uint8_t*  s_out = nullptr;         // HEAD + lz4 block
+static void*     s_lz4 = nullptr;
+static int       s_fps = 10;
+static uint32_t  s_intervalMs = 100;
+static uint32_t  s_lastFrameMs = 0;
+static size_t    s_txMax = 0;             // largest availableForWrite() seen ~ empty buffer
+
+// Accumulated by flushes
+static Rect s_dirty[MAX_RECTS];
+static int  s_dirtyCount = 0;
+
+// Frame in flight
+static Rect     s_send[MAX_RECTS];
+static int      s_sendCount = 0;
+static int      s_sendIdx = 0;
+static int      s_sendRow = 0;            // next row of s_send[s_sendIdx]
+static bool     s_frameKey = false;
+static uint16_t s_frameNo = 0;
+static uint16_t s_stripNo = 0;
+static size_t   s_pending = 0;            // compressed strip in s_out, not sent yet
+static int      s_pendingRows = 0;
+
+static Stats s_stats;
+
+// ---- Dirty list ----
+
+static int32_t rectArea(const Rect& r) {
+    return (int32_t)(r.x2 - r.x1 + 1) * (r.y2 - r.y1 + 1);
+}
+
+static Rect unite(const Rect& a, const Rect& b) {
+    return { std::min(a.x1, b.x1), std::min(a.y1, b.y1), std::max(a.x2, b.x2), std::max(a.y2, b.y2) };
+}
+
+static void addDirty(Rect r) {
+    // Absorb rects whose union wastes no pixels: the bands of one
+    // invalidation (partial render), overlaps, containment
+    for (int i = 0; i < s_dirtyCount;) {
+        Rect u = unite(s_dirty[i], r);
+        if (rectArea(u) <= rectArea(s_dirty[i]) + rectArea(r)) {
+            r = u;
+            s_dirty[i] = s_dirty[--s_dirtyCount];
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+
+    if (s_dirtyCount == MAX_RECTS) {
+        // Full: merge into the rect that grows least, then re-absorb
+        int best = 0;
+        int32_t bestGrow = INT32_MAX;
+        for (int i = 0; i < s_dirtyCount; i++) {
+            int32_t grow = rectArea(unite(s_dirty[i], r)) - rectArea(s_dirty[i]);
+            if (grow < bestGrow) { bestGrow = grow; best = i; }
+        }
+        r = unite(s_dirty[best], r);
+        s_dirty[best] = s_dirty[--s_dirtyCount];
+        s_stats.merges++;
+        addDirty(r);
+        return;
+    }
+
+    s_dirty[s_dirtyCount++] = r;
+}
+
+// Flush tap: runs inside lv_timer_handler, before the panel gets px
+static void onFlush(const lv_area_t* area, const uint8_t* px) {
+    Rect r = {
+        (int16_t)std::max<int32_t>(area->x1, 0), (int16_t)std::max<int32_t>(area->y1, 0),
+        (int16_t)std::min<int32_t>(area->x2, SCREEN_WIDTH - 1), (int16_t)std::min<int32_t>(area->y2, SCREEN_HEIGHT - 1),
+    };
+    if (r.x1 > r.x2 || r.y1 > r.y2) return;
+
+    uint32_t stride = lv_draw_buf_width_to_stride(lv_area_get_width(area), LV_COLOR_FORMAT_RGB565);
+    size_t rowBytes = (size_t)(r.x2 - r.x1 + 1) * 2;
+    const uint8_t* src = px + (size_t)(r.y1 - area->y1) * stride + (size_t)(r.x1 - area->x1) * 2;
+    for (int y = r.y1; y <= r.y2; y++, src += stride) {
+        memcpy(s_shadow + (size_t)y * SCREEN_WIDTH + r.x1, src, rowBytes);
+    }
+    addDirty(r);
+}
+
+// ---- Strips ----
+
+// Next strip of the frame in flight -> s_out, returns its size (0 = error)
+static size_t compressStrip() {
+    const Rect& r = s_send[s_sendIdx];
+    int w = r.x2 - r.x1 + 1;
+    int rows = std::min<int>(STRIP_BYTES / (w * 2), r.y2 - s_sendRow + 1);
+    int raw = w * rows * 2;
+
+    uint8_t* dst = s_strip;
+    for (int y = 0; y < rows; y++, dst += w * 2) {
+        memcpy(dst, s_shadow + (size_t)(s_sendRow + y) * SCREEN_WIDTH + r.x1, w * 2);
+    }
+
+    bool last = s_sendIdx == s_sendCount - 1 && s_sendRow + rows > r.y2;
+    uint16_t head[4] = { (uint16_t)r.x1, (uint16_t)s_sendRow, (uint16_t)w, (uint16_t)rows };
+    memcpy(s_out, head, 8);
+    s_out[8] = (last ? 1 : 0) | (s_frameKey ? 2 : 0);
+    s_out[9] = 0;
+
+    int comp = LZ4_compress_fast_extState(s_lz4, (const char*)s_strip, (char*)s_out + HEAD,
+                                          raw, LZ4_compressBound(STRIP_BYTES), 1);
+    if (comp <= 0) return 0;
+
+    s_pendingRows = rows;
+    s_stats.rawBytes += raw;
+    return HEAD + comp;
+}
+
+static bool beginFrame() {
+    if (!s_dirtyCount) return false;
+    uint32_t now = millis();
+    if (now - s_lastFrameMs < s_intervalMs) return false;
+    s_lastFrameMs = now;
+
+    memcpy(s_send, s_dirty, sizeof(Rect) * s_dirtyCount);
+    s_sendCount = s_dirtyCount;
+    s_dirtyCount = 0;
+    s_sendIdx = 0;
+    s_sendRow = s_send[0].y1;
+    s_stripNo = 0;
+    s_frameNo++;
+
+    // Whole screen in one rect: host may resync from this frame alone
+    const Rect& f = s_send[0];
+    s_frameKey = s_sendCount == 1 && f.x1 == 0 && f.y1 == 0 &&
+                 f.x2 == SCREEN_WIDTH - 1 && f.y2 == SCREEN_HEIGHT - 1;
+    return true;
+}
+
+void process() {
+    if (!s_active) return;
+    if (s_sendIdx >= s_sendCount && !beginFrame()) return;
+
+    while (true) {
+        if (!s_pending && !(s_pending = compressStrip())) {
+            LOG_E(Log::UI, "LZ4 compression failed, stopping");
+            stop();
+            return;
+        }
+
+        // Send only what the TX buffer takes without blocking; a strip larger
+        // than the whole buffer goes once the buffer is empty
+        size_t room = Serial.availableForWrite();
+        if (room > s_txMax) s_txMax = room;
+        size_t wire = s_pending + s_pending / 254 + 16;   // COBS + frame overhead
+        if (room < wire && room < s_txMax) {
+            s_stats.waits++;
+            return;
+        }
+
+        SerialFrame::send(SerialFrame::Mirror, s_frameNo, s_stripNo++, s_out, s_pending);
+        s_stats.strips++;
+        s_stats.sentBytes += s_pending;
+        s_pending = 0;
+
+        s_sendRow += s_pendingRows;
+        if (s_sendRow > s_send[s_sendIdx].y2 && ++s_sendIdx < s_sendCount) {
+            s_sendRow = s_send[s_sendIdx].y1;
+        }
+        if (s_sendIdx >= s_sendCount) {
+            s_stats.frames++;
+            return;
+        }
+        if (room < wire) return;   // that write blocked: give the loop back to the UI
+    }
+}
+
+// ---- Lifecycle ----
+
+static void* allocBuf(size_t size) {
+    void* p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    return p ? p : heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
+}
+
+static void release() {
+    if (s_lz4) heap_caps_free(s_lz4);
+    if (s_out) heap_caps_free(s_out);
+    if (s_strip) heap_caps_free(s_strip);
+    if (s_shadow) heap_caps_free(s_shadow);
+    s_lz4 = nullptr;
+    s_out = nullptr;
+    s_strip = nullptr;
+    s_shadow = nullptr;
+}
+
+bool start(int fps) {
+    s_fps = std::max(1, std::min(fps, 30));
+    s_intervalMs = 1000 / s_fps;
+    if (s_active) return true;
+
+    // Shadow only fits PSRAM; the rest is small
+    s_shadow = (uint16_t*)heap_caps_malloc(SCREEN_WIDTH * SCREEN_HEIGHT * 2, MALLOC_CAP_SPIRAM);
+    s_strip = (uint8_t*)allocBuf(STRIP_BYTES);
+    s_out = (uint8_t*)allocBuf(HEAD + LZ4_compressBound(STRIP_BYTES));
+    s_lz4 = allocBuf(LZ4_sizeofState());
+    if (!s_shadow || !s_strip || !s_out || !s_lz4) {
+        LOG_E(Log::UI, "Failed to allocate mirror buffers");
+        release();
+        return false;
+    }
+
+    s_dirtyCount = 0;
+    s_sendCount = s_sendIdx = 0;
+    s_pending = 0;
+    s_frameNo = 0;
+    s_lastFrameMs = 0;
+    s_stats = Stats();
+    s_active = true;
+
+    // Full redraw fills the shadow and becomes the first (key) frame
+    display_lock();
+    display_set_flush_tap(onFlush);
+    lv_obj_invalidate(lv_screen_active());
+    display_unlock();
+
+    LOG_I(Log::UI, "Started %dx%d @ %d fps", SCREEN_WIDTH, SCREEN_HEIGHT, s_fps);
+    return true;
+}
+
+void stop() {
+    if (!s_active) return;
+    display_lock();
+    display_set_flush_tap(nullptr);
+    display_unlock();
+    s_active = false;
+    release();
+    LOG_I(Log::UI, "Stopped: %u frames, %u strips, %u -> %u bytes",
+          (unsigned)s_stats.frames, (unsigned)s_stats.strips,
+          (unsigned)s_stats.rawBytes, (unsigned)s_stats.sentBytes);
+}
+
+bool active() {
+    return s_active;
+}
+
+const Stats& stats() {
+    return s_stats;
+}
+
+int fps() {
+    return s_fps;
+}
+
+} // namespace Mirror
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <lvgl.h>
+
+/**
+ * Mirror - live screen stream over Serial framed mode
+ *
+ * The display flush is tapped (display_set_flush_tap): every flushed area
+ * is copied into a PSRAM shadow of the screen and its rect joins the dirty
+ * list. Nothing is sent from the flush — LVGL only pays a memcpy.
+ *
+ * Mirror::process() (main loop) turns the dirty list into one frame at
+ * most every 1000/fps ms: each rect goes out as row strips of <= STRIP_BYTES
+ * RGB565, LZ4-compressed, in SerialFrame 'M' frames:
+ *
+ *   id = frame number, seq = strip index in the frame
+ *   data: [x u16][y u16][w u16][rows u16][flags u8][0 u8][lz4 block]
+ *         raw strip = w * rows * 2 bytes, flags: 1 = last strip of frame,
+ *         2 = key frame (whole screen follows)
+ *
+ * Backpressure: a strip is sent only when the Serial TX buffer can take it
+ * (or is empty); otherwise it waits for the next loop. Meanwhile new
+ * flushes just merge into the dirty list, so a slow host lowers the frame
+ * rate instead of stalling the UI. Host decoder: tools/mirror_decode.py.
+ */
+
+namespace Mirror {
+
+static constexpr uint32_t STRIP_BYTES = 4096;
+static constexpr int MAX_RECTS = 8;        // dirty list; overflow merges
+
+struct Stats {
+    uint32_t frames = 0;
+    uint32_t strips = 0;
+    uint32_t rawBytes = 0;
+    uint32_t sentBytes = 0;     // compressed strip data
+    uint32_t waits = 0;         // loops where TX buffer was full
+    uint32_t merges = 0;        // dirty list overflows
+};
+
+/// Allocate shadow + buffers, tap the flush, force a full redraw
+bool start(int fps);
+void stop();
+bool active();
+
+/// Main loop: emit the next strip(s) when due and the TX buffer has room
+void process();
+
+const Stats& stats();
+int fps();
+
+} // namespace Mirror
@@ -8,9 +8,11 @@
 #include <cstdlib>
 #include <string_view>
 #include "esp_heap_caps.h"
+#include "utils/mem_tags.h"
 
 // ============ M:: DRAM (Memory) ============
 // For statics, created before psramInit()
+// Allocations are charged to the current MemTags::Scope (utils/mem_tags.h)
 
 namespace M {
 
@@ -19,13 +21,13 @@ struct Allocator {
     using value_type = T;
     
     T* allocate(size_t n) {
-        void* p = malloc(n * sizeof(T));
+        void* p = MemTags::alloc(n * sizeof(T), 0);
         if (!p) throw std::bad_alloc();
         return static_cast<T*>(p);
     }
     
     void deallocate(T* p, size_t) noexcept {
-        free(p);
+        MemTags::free(p);
     }
     
     template<typename U>
@@ -96,16 +98,16 @@ struct Allocator {
     
     T* allocate(size_t n) {
         size_t bytes = n * sizeof(T);
-        void* p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+        void* p = MemTags::alloc(bytes, MALLOC_CAP_SPIRAM);
         if (!p) {
-            p = heap_caps_malloc(bytes, MALLOC_CAP_DEFAULT);
+            p = MemTags::alloc(bytes, MALLOC_CAP_DEFAULT);
         }
         if (!p) throw std::bad_alloc();
         return static_cast<T*>(p);
     }
     
     void deallocate(T* p, size_t) noexcept {
-        free(p);
+        MemTags::free(p);
     }
     
     template<typename U>
@@ -184,7 +186,7 @@ struct Deleter {
     void operator()(T* p) const {
         if (p) {
             p->~T();
-            free(p);
+            MemTags::free(p);
         }
     }
 };
@@ -196,9 +198,9 @@ using Ptr = std::unique_ptr<T, Deleter<T>>;
 // Create object in PSRAM
 template<typename T, typename... Args>
 Ptr<T> create(Args&&... args) {
-    void* p = heap_caps_malloc(sizeof(T), MALLOC_CAP_SPIRAM);
+    void* p = MemTags::alloc(sizeof(T), MALLOC_CAP_SPIRAM);
     if (!p) {
-        p = heap_caps_malloc(sizeof(T), MALLOC_CAP_DEFAULT);
+        p = MemTags::alloc(sizeof(T), MALLOC_CAP_DEFAULT);
     }
     if (!p) return nullptr;
     return Ptr<T>(new(p) T(std::forward<Args>(args)...));
@@ -5,21 +5,25 @@
  * Usage:
  *   #include "utils/psram_json.h"
  *   auto doc = PsramJsonDoc();
+ *
+ * Charged to MemTags::Json.
  */
 
 #include <ArduinoJson.h>
 #include <esp_heap_caps.h>
+#include "utils/mem_tags.h"
 
 struct PsramAllocator : ArduinoJson::Allocator {
     void* allocate(size_t size) override {
-        void* p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
-        if (!p) p = heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
+        void* p = MemTags::alloc(MemTags::Json, size, MALLOC_CAP_SPIRAM);
+        if (!p) p = MemTags::alloc(MemTags::Json, size, MALLOC_CAP_DEFAULT);
         return p;
     }
-    void deallocate(void* p) override { free(p); }
+    void deallocate(void* p) override { MemTags::free(p); }
     void* reallocate(void* p, size_t size) override {
-        void* np = heap_caps_realloc(p, size, MALLOC_CAP_SPIRAM);
-        if (!np) np = heap_caps_realloc(p, size, MALLOC_CAP_DEFAULT);
+        if (!p) return allocate(size);
+        void* np = MemTags::realloc(p, size, MALLOC_CAP_SPIRAM);
+        if (!np) np = MemTags::realloc(p, size, MALLOC_CAP_DEFAULT);
         return np;
     }
 
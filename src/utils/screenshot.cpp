@@ -1,10 +1,13 @@
 #include "utils/screenshot.h"
 #include "hal/device.h"
 #include "utils/log_config.h"
+#include "utils/mem_tags.h"
 #include <Arduino.h>
 #include <lvgl.h>
 #include <esp_heap_caps.h>
 #include <lz4.h>
+#include "src/core/lv_refr_private.h"
+#include "src/display/lv_display_private.h"
 
 static const char* TAG = "Screenshot";
 
@@ -31,9 +34,9 @@ static const uint8_t bayer4[4][4] = {
 };
 
 // Convert RGB565 pixels to target format
-// imageWidth needed for BW dithering (x,y from pixel index)
+// imageWidth needed for BW dithering (x,y from pixel index), y0 = first row (bands)
 static uint32_t convertPixels(uint16_t* src, uint8_t* dst, uint32_t pixelCount, 
-                               ColorFormat format, uint32_t imageWidth = 0) {
+                               ColorFormat format, uint32_t imageWidth = 0, uint32_t y0 = 0) {
     switch (format) {
         case COLOR_RGB16:
             memcpy(dst, src, pixelCount * 2);
@@ -82,7 +85,7 @@ static uint32_t convertPixels(uint16_t* src, uint8_t* dst, uint32_t pixelCount,
                         white = true;
                     } else {
                         uint32_t x = idx % w;
-                        uint32_t y = idx / w;
+                        uint32_t y = y0 + idx / w;
                         white = gray > bayer4[y & 3][x & 3];
                     }
                     if (white) byte |= (1 << (7 - bit));
@@ -101,38 +104,43 @@ static uint32_t convertPixels(uint16_t* src, uint8_t* dst, uint32_t pixelCount,
 // Convert RGB565 pixels to palette-indexed format
 // Output: [1:count][N*2:palette RGB565][pixels: 4bpp if N<=16, 8bpp if N<=256]
 // Returns total output size, or 0 if too many colors (>256)
+// dst must hold 1 + 512 + pixelCount bytes: indices are staged after the
+// largest possible palette and packed down once the palette size is known.
 static uint32_t convertPalette(uint16_t* src, uint8_t* dst, uint32_t pixelCount) {
-    // Phase 1: scan unique colors (linear search, fast for ≤256)
+    // Phase 1: unique colors via open-addressed hash (512 slots, load <= 1/2)
+    static constexpr uint32_t SLOTS = 512;
+    static uint16_t keys[SLOTS];
+    static int16_t slots[SLOTS];     // palette index, -1 = empty
     uint16_t palette[256];
     uint32_t paletteSize = 0;
+    memset(slots, 0xFF, sizeof(slots));
     
-    // Temp buffer for indices (freed before return)
-    uint8_t* indices = (uint8_t*)heap_caps_malloc(pixelCount, MALLOC_CAP_SPIRAM);
-    if (!indices) {
-        LOG_E(Log::UI, "Palette: failed to allocate indices buffer");
-        return 0;
-    }
+    uint8_t* indices = dst + 1 + 256 * 2;
+    uint16_t lastColor = 0;
+    int lastIdx = -1;                // runs of one color skip the lookup
     
     for (uint32_t i = 0; i < pixelCount; i++) {
         uint16_t color = src[i];
         
-        // Find in palette
-        uint32_t idx = 0;
-        for (; idx < paletteSize; idx++) {
-            if (palette[idx] == color) break;
-        }
-        
-        if (idx == paletteSize) {
-            // New color
-            if (paletteSize >= 256) {
-                LOG_D(Log::UI, "Palette: >256 unique colors, fallback to rgb16");
-                heap_caps_free(indices);
-                return 0;  // too many colors
+        if (color != lastColor || lastIdx < 0) {
+            uint32_t h = (color * 0x9E3779B1u) >> 23;
+            while (slots[h] >= 0 && keys[h] != color) h = (h + 1) & (SLOTS - 1);
+            
+            if (slots[h] < 0) {
+                // New color
+                if (paletteSize >= 256) {
+                    LOG_D(Log::UI, "Palette: >256 unique colors, fallback to rgb16");
+                    return 0;  // too many colors
+                }
+                keys[h] = color;
+                slots[h] = (int16_t)paletteSize;
+                palette[paletteSize++] = color;
             }
-            palette[paletteSize++] = color;
+            lastColor = color;
+            lastIdx = slots[h];
         }
         
-        indices[i] = (uint8_t)idx;
+        indices[i] = (uint8_t)lastIdx;
     }
     
     LOG_D(Log::UI, "Palette: %lu unique colors", paletteSize);
@@ -149,7 +157,7 @@ static uint32_t convertPalette(uint16_t* src, uint8_t* dst, uint32_t pixelCount)
         dst[pos++] = (palette[i] >> 8) & 0xFF;
     }
     
-    // Pixel indices
+    // Pixel indices (write position never passes the read position)
     if (paletteSize <= 16) {
         // 4bpp packed: high nibble = first pixel
         for (uint32_t i = 0; i < pixelCount; i += 2) {
@@ -159,12 +167,10 @@ static uint32_t convertPalette(uint16_t* src, uint8_t* dst, uint32_t pixelCount)
         }
     } else {
         // 8bpp: one byte per pixel
-        for (uint32_t i = 0; i < pixelCount; i++) {
-            dst[pos++] = indices[i];
-        }
+        memmove(dst + pos, indices, pixelCount);
+        pos += pixelCount;
     }
     
-    heap_caps_free(indices);
     return pos;
 }
 
@@ -207,7 +213,235 @@ static void downscaleNearest(uint16_t* src, uint16_t* dst,
     }
 }
 
+// Summed-area table: box averages for every tiny-mode scale from one pass
+// over the screen. Sums wrap mod 2^16 per channel (R|B packed in u32, G in
+// u16); a 32x32 box sums below 65536, so wrapped differences stay exact.
+struct AreaSums {
+    uint32_t* rb = nullptr;     // (w+1) x (h+1), row/column 0 = 0
+    uint16_t* g = nullptr;
+    uint32_t w = 0, h = 0;
+    
+    bool build(const uint16_t* src, uint32_t srcW, uint32_t srcH) {
+        w = srcW;
+        h = srcH;
+        size_t n = (size_t)(w + 1) * (h + 1);
+        rb = (uint32_t*)MemTags::alloc(MemTags::Screenshot, n * sizeof(uint32_t), MALLOC_CAP_SPIRAM);
+        g = (uint16_t*)MemTags::alloc(MemTags::Screenshot, n * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        if (!rb || !g) {
+            release();
+            return false;
+        }
+        
+        memset(rb, 0, (w + 1) * sizeof(uint32_t));
+        memset(g, 0, (w + 1) * sizeof(uint16_t));
+        for (uint32_t y = 0; y < h; y++) {
+            const uint16_t* row = src + y * w;
+            uint32_t* rbUp = rb + y * (w + 1);
+            uint32_t* rbRow = rbUp + (w + 1);
+            uint16_t* gUp = g + y * (w + 1);
+            uint16_t* gRow = gUp + (w + 1);
+            uint32_t rbAcc = 0;
+            uint16_t gAcc = 0;
+            rbRow[0] = 0;
+            gRow[0] = 0;
+            for (uint32_t x = 0; x < w; x++) {
+                uint16_t p = row[x];
+                rbAcc += ((uint32_t)(p >> 11) << 16) | (p & 0x1F);
+                gAcc += (p >> 5) & 0x3F;
+                rbRow[x + 1] = rbUp[x + 1] + rbAcc;
+                gRow[x + 1] = gUp[x + 1] + gAcc;
+            }
+        }
+        return true;
+    }
+    
+    // Same result as downscaleImage(src, dst, w, h, scale), scale <= 32
+    void downscale(uint16_t* dst, uint32_t scale) const {
+        uint32_t dstW = w / scale;
+        uint32_t dstH = h / scale;
+        uint32_t count = scale * scale;
+        uint32_t stride = w + 1;
+        
+        for (uint32_t y = 0; y < dstH; y++) {
+            const uint32_t* rb0 = rb + y * scale * stride;
+            const uint32_t* rb1 = rb0 + scale * stride;
+            const uint16_t* g0 = g + y * scale * stride;
+            const uint16_t* g1 = g0 + scale * stride;
+            for (uint32_t x = 0; x < dstW; x++) {
+                uint32_t x0 = x * scale, x1 = x0 + scale;
+                uint32_t rbSum = rb1[x1] - rb1[x0] - rb0[x1] + rb0[x0];
+                uint16_t gSum = g1[x1] - g1[x0] - g0[x1] + g0[x0];
+                uint32_t r = (rbSum >> 16) / count;
+                uint32_t b = (rbSum & 0xFFFF) / count;
+                dst[y * dstW + x] = (r << 11) | ((gSum / count) << 5) | b;
+            }
+        }
+    }
+    
+    void release() {
+        MemTags::free(rb);
+        MemTags::free(g);
+        rb = nullptr;
+        g = nullptr;
+    }
+};
+
+// ============ Banded capture ============
+
+// Render screen rows [y1, y1 + lines) into draw_buf — lv_snapshot_take_to_draw_buf
+// limited to a band (buffer covers the band only)
+static bool renderBand(lv_obj_t* scr, lv_draw_buf_t* draw_buf, int32_t y1, int32_t lines) {
+    if (!lv_draw_buf_reshape(draw_buf, LV_COLOR_FORMAT_RGB565, SCREEN_WIDTH, lines, LV_STRIDE_AUTO)) {
+        return false;
+    }
+    lv_draw_buf_clear(draw_buf, NULL);
+
+    lv_area_t area = { 0, y1, SCREEN_WIDTH - 1, y1 + lines - 1 };
+
+    lv_layer_t layer;
+    lv_memzero(&layer, sizeof(layer));
+    layer.draw_buf = draw_buf;
+    layer.buf_area = area;
+    layer.color_format = LV_COLOR_FORMAT_RGB565;
+    layer._clip_area = area;
+    layer.phy_clip_area = area;
+#if LV_DRAW_TRANSFORM_USE_MATRIX
+    lv_matrix_identity(&layer.matrix);
+#endif
+
+    lv_display_t* dispOld = lv_refr_get_disp_refreshing();
+    lv_display_t* disp = lv_obj_get_display(scr);
+    lv_layer_t* layerOld = disp->layer_head;
+    disp->layer_head = &layer;
+
+    lv_refr_set_disp_refreshing(disp);
+    lv_obj_redraw(&layer, scr);
+    while (layer.draw_task_head) {
+        lv_draw_dispatch_wait_for_request();
+        lv_draw_dispatch();
+    }
+
+    disp->layer_head = layerOld;
+    lv_refr_set_disp_refreshing(dispOld);
+    return true;
+}
+
+// Output grows with compressed bands (PSRAM realloc). The caller frees the
+// output with heap_caps_free(), so only work buffers are MemTags::Screenshot.
+static bool reserve(uint8_t*& buf, uint32_t& cap, uint32_t need) {
+    if (need <= cap) return true;
+    uint32_t newCap = cap ? cap : 16 * 1024;
+    while (newCap < need) newCap *= 2;
+    uint8_t* p = (uint8_t*)heap_caps_realloc(buf, newCap, MALLOC_CAP_SPIRAM);
+    if (!p) return false;
+    buf = p;
+    cap = newCap;
+    return true;
+}
+
+static bool captureBands(CaptureResult& out, int scale, const char* color) {
+    ColorFormat colorFmt = parseColorFormat(color);
+    uint32_t s = scale > 1 ? scale : 1;
+    uint32_t bandLines = (BAND_LINES + s - 1) / s * s;
+    uint32_t outW = SCREEN_WIDTH / s;
+    uint32_t outH = SCREEN_HEIGHT / s;
+
+    // Band pixels (downscaled in place), converted band, LZ4 state
+    uint32_t bandSize = SCREEN_WIDTH * bandLines * sizeof(uint16_t);
+    uint32_t colorCap = outW * (bandLines / s) * sizeof(uint16_t) + 1 + 256 * 2;
+    uint8_t* band = (uint8_t*)MemTags::alloc(MemTags::Screenshot, bandSize, MALLOC_CAP_SPIRAM);
+    uint8_t* colorBuf = (uint8_t*)MemTags::alloc(MemTags::Screenshot, colorCap, MALLOC_CAP_SPIRAM);
+    void* lz4State = MemTags::alloc(MemTags::Screenshot, LZ4_sizeofState(), MALLOC_CAP_SPIRAM);
+    uint8_t* outBuf = nullptr;
+    uint32_t outCap = 0;
+    uint32_t outSize = 0;
+    uint32_t rawTotal = 0;
+    bool ok = band && colorBuf && lz4State;
+    if (!ok) LOG_E(Log::UI, "Failed to allocate band buffers");
+
+    lv_draw_buf_t draw_buf;
+    if (ok) lv_draw_buf_init(&draw_buf, SCREEN_WIDTH, bandLines, LV_COLOR_FORMAT_RGB565,
+                             LV_STRIDE_AUTO, band, bandSize);
+
+    lv_obj_t* scr = lv_scr_act();
+    lv_obj_update_layout(scr);
+
+    auto downscale = (colorFmt == COLOR_PALETTE) ? downscaleNearest : downscaleImage;
+
+    for (uint32_t y = 0; ok && y + s <= SCREEN_HEIGHT; y += bandLines) {
+        uint32_t lines = SCREEN_HEIGHT - y < bandLines ? (SCREEN_HEIGHT - y) / s * s : bandLines;
+        if (!renderBand(scr, &draw_buf, y, lines)) {
+            LOG_E(Log::UI, "Band render failed at row %u", y);
+            ok = false;
+            break;
+        }
+
+        uint16_t* pixels = (uint16_t*)band;
+        uint32_t rows = lines / s;
+        if (s > 1) downscale(pixels, pixels, SCREEN_WIDTH, lines, s);
+
+        // Palette may fall back per band: each band carries its color
+        ColorFormat bandFmt = colorFmt;
+        uint32_t rawSize = 0;
+        if (colorFmt == COLOR_PALETTE) rawSize = convertPalette(pixels, colorBuf, outW * rows);
+        if (!rawSize) {
+            if (bandFmt == COLOR_PALETTE) bandFmt = COLOR_RGB16;
+            rawSize = convertPixels(pixels, colorBuf, outW * rows, bandFmt, outW, y / s);
+        }
+
+        uint32_t bound = LZ4_compressBound(rawSize);
+        if (!reserve(outBuf, outCap, outSize + 12 + bound)) {
+            LOG_E(Log::UI, "Failed to grow output to %u bytes", outSize + 12 + bound);
+            ok = false;
+            break;
+        }
+        int comp = LZ4_compress_fast_extState(lz4State, (const char*)colorBuf,
+                                              (char*)outBuf + outSize + 12, rawSize, bound, 1);
+        if (comp <= 0) {
+            LOG_E(Log::UI, "LZ4 compression failed");
+            ok = false;
+            break;
+        }
+
+        uint8_t* h = outBuf + outSize;
+        h[0] = rows & 0xFF;
+        h[1] = rows >> 8;
+        h[2] = bandFmt;
+        h[3] = 0;
+        memcpy(h + 4, &rawSize, 4);
+        memcpy(h + 8, &comp, 4);
+        outSize += 12 + comp;
+        rawTotal += rawSize;
+    }
+
+    MemTags::free(lz4State);
+    MemTags::free(colorBuf);
+    MemTags::free(band);
+
+    if (!ok || !outSize) {
+        if (outBuf) heap_caps_free(outBuf);
+        return false;
+    }
+
+    out.buffer = outBuf;
+    out.size = outSize;
+    out.rawSize = rawTotal;
+    out.width = outW;
+    out.height = outH;
+    out.color = color;
+    out.format = "lz4b";
+
+    LOG_I(Log::UI, "Captured bands: %lux%lu, %lu bytes (raw %lu), work %lu bytes",
+          outW, outH, outSize, rawTotal, bandSize + colorCap + LZ4_sizeofState());
+    return true;
+}
+
 bool capture(CaptureResult& out, const char* mode, int scale, const char* color) {
+    if (strcmp(mode, "band") == 0) {
+        LOG_I(Log::UI, "Capture: mode=band, scale=%d, color=%s", scale, color);
+        return captureBands(out, scale, color);
+    }
+
     ColorFormat colorFmt = parseColorFormat(color);
     bool tinyMode = (strcmp(mode, "tiny") == 0);
     
@@ -216,7 +450,7 @@ bool capture(CaptureResult& out, const char* mode, int scale, const char* color)
     // Allocate full framebuffer
     uint32_t fullSize = SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(lv_color_t);
     
-    uint8_t* fullBuffer = (uint8_t*)heap_caps_malloc(fullSize, MALLOC_CAP_SPIRAM);
+    uint8_t* fullBuffer = (uint8_t*)MemTags::alloc(MemTags::Screenshot, fullSize, MALLOC_CAP_SPIRAM);
     if (!fullBuffer) {
         LOG_E(Log::UI, "Failed to allocate full buffer");
         return false;
@@ -233,32 +467,32 @@ bool capture(CaptureResult& out, const char* mode, int scale, const char* color)
     
     if (res != LV_RESULT_OK) {
         LOG_E(Log::UI, "Snapshot failed: %d", res);
-        heap_caps_free(fullBuffer);
+        MemTags::free(fullBuffer);
         return false;
     }
     #else
     LOG_E(Log::UI, "LV_USE_SNAPSHOT not enabled!");
-    heap_caps_free(fullBuffer);
+    MemTags::free(fullBuffer);
     return false;
     #endif
     
     // Allocate work buffers
     uint32_t maxDownscaledSize = SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(lv_color_t);
     
-    uint8_t* downscaledBuffer = (uint8_t*)heap_caps_malloc(maxDownscaledSize, MALLOC_CAP_SPIRAM);
-    uint8_t* colorBuffer = (uint8_t*)heap_caps_malloc(maxDownscaledSize, MALLOC_CAP_SPIRAM);
+    uint8_t* downscaledBuffer = (uint8_t*)MemTags::alloc(MemTags::Screenshot, maxDownscaledSize, MALLOC_CAP_SPIRAM);
+    uint8_t* colorBuffer = (uint8_t*)MemTags::alloc(MemTags::Screenshot, maxDownscaledSize, MALLOC_CAP_SPIRAM);
     int maxCompressedSize = LZ4_compressBound(maxDownscaledSize);
     uint8_t* compressedBuffer = (uint8_t*)heap_caps_malloc(maxCompressedSize, MALLOC_CAP_SPIRAM);
     int lz4StateSize = LZ4_sizeofState();
-    void* lz4State = heap_caps_malloc(lz4StateSize, MALLOC_CAP_SPIRAM);
+    void* lz4State = MemTags::alloc(MemTags::Screenshot, lz4StateSize, MALLOC_CAP_SPIRAM);
     
     if (!downscaledBuffer || !colorBuffer || !compressedBuffer || !lz4State) {
         LOG_E(Log::UI, "Failed to allocate work buffers");
-        if (lz4State) heap_caps_free(lz4State);
+        MemTags::free(lz4State);
         if (compressedBuffer) heap_caps_free(compressedBuffer);
-        if (colorBuffer) heap_caps_free(colorBuffer);
-        if (downscaledBuffer) heap_caps_free(downscaledBuffer);
-        heap_caps_free(fullBuffer);
+        MemTags::free(colorBuffer);
+        MemTags::free(downscaledBuffer);
+        MemTags::free(fullBuffer);
         return false;
     }
     
@@ -287,12 +521,22 @@ bool capture(CaptureResult& out, const char* mode, int scale, const char* color)
     auto downscale = (colorFmt == COLOR_PALETTE) ? downscaleNearest : downscaleImage;
     
     if (tinyMode) {
+        // Averaging: one summed-area pass, then each scale costs its output
+        // size only (falls back to per-scale downscale without memory)
+        AreaSums sums;
+        bool useSums = colorFmt != COLOR_PALETTE &&
+                       sums.build((uint16_t*)fullBuffer, SCREEN_WIDTH, SCREEN_HEIGHT);
+        
         for (uint32_t s = 2; s <= 32; s++) {
             outW = SCREEN_WIDTH / s;
             outH = SCREEN_HEIGHT / s;
             
-            downscale((uint16_t*)fullBuffer, (uint16_t*)downscaledBuffer,
-                          SCREEN_WIDTH, SCREEN_HEIGHT, s);
+            if (useSums) {
+                sums.downscale((uint16_t*)downscaledBuffer, s);
+            } else {
+                downscale((uint16_t*)fullBuffer, (uint16_t*)downscaledBuffer,
+                              SCREEN_WIDTH, SCREEN_HEIGHT, s);
+            }
             
             colorSize = doConvert((uint16_t*)downscaledBuffer, outW * outH, outW);
             
@@ -313,6 +557,7 @@ bool capture(CaptureResult& out, const char* mode, int scale, const char* color)
                 break;
             }
         }
+        sums.release();
     } else {
         if (scale <= 1) {
             outW = SCREEN_WIDTH;
@@ -342,10 +587,10 @@ bool capture(CaptureResult& out, const char* mode, int scale, const char* color)
     }
     
     // Free work buffers (keep compressedBuffer — it becomes the output)
-    heap_caps_free(lz4State);
-    heap_caps_free(colorBuffer);
-    heap_caps_free(downscaledBuffer);
-    heap_caps_free(fullBuffer);
+    MemTags::free(lz4State);
+    MemTags::free(colorBuffer);
+    MemTags::free(downscaledBuffer);
+    MemTags::free(fullBuffer);
     
     if (compressedSize <= 0) {
         LOG_E(Log::UI, "LZ4 compression failed");
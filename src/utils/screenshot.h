@@ -7,6 +7,13 @@
  * 
  * Returns LZ4-compressed image. Caller owns the buffer.
  * Transport (BinTransfer) handles chunked delivery.
+ *
+ * mode "band": the screen is rendered BAND_LINES rows at a time into one
+ * band buffer, downscaled/converted/compressed per band, and appended to
+ * the output. Work memory ~ 2 bands + LZ4 state, independent of
+ * resolution. Output format "lz4b" = sequence of
+ *   [u16 rows][u8 color][u8 0][u32 raw size][u32 lz4 size][lz4 block]
+ * each block decompresses on its own to that band's rows.
  */
 
 namespace Screenshot {
@@ -26,13 +33,16 @@ struct CaptureResult {
     uint32_t width = 0;          // output width
     uint32_t height = 0;         // output height
     const char* color = "rgb16"; // color format name
+    const char* format = "lz4";  // "lz4" (one block) or "lz4b" (bands)
 };
 
+static constexpr uint32_t BAND_LINES = 16;  // rounded up to a multiple of scale
+
 /**
  * Capture screenshot to PSRAM buffer
  * 
  * @param out       result struct (buffer ownership transfers to caller)
- * @param mode      "tiny" (auto-fit one BLE frame) or "fixed" 
+ * @param mode      "tiny" (auto-fit one BLE frame), "fixed" or "band"
  * @param scale     0 = full size, 2-32 = downscale factor
  * @param color     "rgb16", "rgb8", "gray", "bw"
  * @return true on success
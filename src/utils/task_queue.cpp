@@ -1,13 +1,37 @@
 #include "utils/task_queue.h"
 #include "utils/log_config.h"
+#include <esp_heap_caps.h>
+#include <algorithm>
+#include <cstring>
 
 static const char* TAG = "TaskQueue";
-static const char* VERSION = "1.2.0";
+static const char* VERSION = "1.3.0";
 
 TaskQueue* TaskQueue::s_instance = nullptr;
 
+// One-time buffers: PSRAM when present
+static void* allocBuf(size_t bytes) {
+    void* p = heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM);
+    if (!p) p = heap_caps_calloc(1, bytes, MALLOC_CAP_DEFAULT);
+    return p;
+}
+
+static uint32_t hashName(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) h = (h ^ (uint8_t)*s++) * 16777619u;
+    return h;
+}
+
 TaskQueue::TaskQueue() {
     m_mutex = xSemaphoreCreateMutex();
+    for (auto& f : m_frames) {
+        f.records = (Record*)allocBuf(MAX_RECORDS * sizeof(Record));
+        f.values = (char*)allocBuf(VALUE_ARENA);
+        f.pending = (uint16_t*)allocBuf(m_maxKeys * 2 * sizeof(uint16_t));
+    }
+    m_hashSlots = (uint16_t*)allocBuf(m_maxKeys * 2 * sizeof(uint16_t));
+    m_nameOff = (uint16_t*)allocBuf(m_maxKeys * sizeof(uint16_t));
+    m_names = (char*)allocBuf(m_nameArena);
 }
 
 TaskQueue& TaskQueue::instance() {
@@ -18,11 +42,133 @@ TaskQueue& TaskQueue::instance() {
     return *s_instance;
 }
 
+// ============ FAST PATH (mutex held) ============
+
+// Interned id, or -1 when the table is full
+int TaskQueue::intern(const char* name) {
+    if (!m_hashSlots || !m_nameOff || !m_names) return -1;
+
+    size_t mask = m_maxKeys * 2 - 1;
+    for (size_t i = hashName(name) & mask;; i = (i + 1) & mask) {
+        uint16_t slot = m_hashSlots[i];
+        if (!slot) {
+            size_t len = strlen(name) + 1;
+            if (m_keyCount >= m_maxKeys || m_namesUsed + len > m_nameArena) {
+                m_internFull = true;
+                return -1;
+            }
+            memcpy(m_names + m_namesUsed, name, len);
+            m_nameOff[m_keyCount] = m_namesUsed;
+            m_namesUsed += len;
+            m_hashSlots[i] = ++m_keyCount;
+            return m_keyCount - 1;
+        }
+        if (strcmp(m_names + m_nameOff[slot - 1], name) == 0) return slot - 1;
+    }
+}
+
+// Double whichever of the key table / name arena is 3/4 full and rehash.
+// process() only, lock held: it is also the only unlocked reader of names.
+bool TaskQueue::growNames() {
+    size_t keys = m_keyCount > m_maxKeys * 3 / 4 ? std::min(m_maxKeys * 2, MAX_KEYS) : m_maxKeys;
+    size_t arena = m_namesUsed > m_nameArena * 3 / 4 ? std::min(m_nameArena * 2, MAX_NAME_ARENA) : m_nameArena;
+    if (keys == m_maxKeys && arena == m_nameArena) return false;
+
+    uint16_t* slots = (uint16_t*)allocBuf(keys * 2 * sizeof(uint16_t));
+    uint16_t* nameOff = (uint16_t*)allocBuf(keys * sizeof(uint16_t));
+    char* names = (char*)allocBuf(arena);
+    uint16_t* pending[2] = {(uint16_t*)allocBuf(keys * 2 * sizeof(uint16_t)),
+                            (uint16_t*)allocBuf(keys * 2 * sizeof(uint16_t))};
+    if (!slots || !nameOff || !names || !pending[0] || !pending[1]) {
+        free(slots);
+        free(nameOff);
+        free(names);
+        free(pending[0]);
+        free(pending[1]);
+        return false;
+    }
+
+    // Ids stay the same: records and pending entries remain valid
+    memcpy(nameOff, m_nameOff, m_keyCount * sizeof(uint16_t));
+    memcpy(names, m_names, m_namesUsed);
+    for (int i = 0; i < 2; i++) {
+        memcpy(pending[i], m_frames[i].pending, m_maxKeys * 2 * sizeof(uint16_t));
+        free(m_frames[i].pending);
+        m_frames[i].pending = pending[i];
+    }
+    size_t mask = keys * 2 - 1;
+    for (size_t k = 0; k < m_keyCount; k++) {
+        size_t i = hashName(names + nameOff[k]) & mask;
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = k + 1;
+    }
+
+    free(m_hashSlots);
+    free(m_nameOff);
+    free(m_names);
+    m_hashSlots = slots;
+    m_nameOff = nameOff;
+    m_names = names;
+    m_maxKeys = keys;
+    m_nameArena = arena;
+    LOG_D(Log::APP, "Name table grown: %d keys, %d bytes", (int)keys, (int)arena);
+    return true;
+}
+
+bool TaskQueue::pushFast(Kind kind, const char* name, const char* value) {
+    Frame& f = m_frames[m_back];
+    if (!f.records || !f.values || !f.pending || f.overflow) return false;
+
+    // Once a frame spills, later updates must not overtake slow-path ones
+    int key = intern(name);
+    size_t len = strlen(value);
+    if (key < 0 || len > 0xFFFF) {
+        f.overflow = true;
+        return false;
+    }
+
+    uint16_t& pending = f.pending[key * 2 + (int)kind];
+    Record* rec = pending ? &f.records[pending - 1] : nullptr;
+    // Dedupe: keep position, take new value (in place when it fits)
+    if (rec && len <= rec->valueCap) {
+        memcpy(f.values + rec->valueOff, value, len + 1);
+        rec->valueLen = len;
+        return true;
+    }
+    if (f.valuesUsed + len + 1 > VALUE_ARENA || (!rec && f.count >= MAX_RECORDS)) {
+        f.overflow = true;
+        return false;
+    }
+    if (!rec) {
+        rec = &f.records[f.count++];
+        rec->key = key;
+        rec->kind = kind;
+        pending = f.count;
+    }
+    memcpy(f.values + f.valuesUsed, value, len + 1);
+    rec->valueOff = f.valuesUsed;
+    rec->valueLen = len;
+    rec->valueCap = len;
+    f.valuesUsed += len + 1;
+    return true;
+}
+
+void TaskQueue::resetFrame(Frame& f) {
+    for (size_t i = 0; i < f.count; i++) {
+        f.pending[f.records[i].key * 2 + (int)f.records[i].kind] = 0;
+    }
+    f.count = 0;
+    f.valuesUsed = 0;
+    f.overflow = false;
+}
+
+// ============ API ============
+
 void TaskQueue::push(std::unique_ptr<ITask> task) {
     if (!task) return;
-    
+
     P::String k = task->key();
-    
+
     xSemaphoreTake(m_mutex, portMAX_DELAY);
     if (k.empty()) {
         m_unkeyed.push_back(std::move(task));
@@ -32,32 +178,75 @@ void TaskQueue::push(std::unique_ptr<ITask> task) {
     xSemaphoreGive(m_mutex);
 }
 
+void TaskQueue::push(Kind kind, const char* name, const char* value) {
+    if (!name) name = "";
+    if (!value) value = "";
+
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    bool ok = pushFast(kind, name, value);
+    xSemaphoreGive(m_mutex);
+    if (ok) return;
+
+    // Frame full / too many names: slow path keeps the update
+    LOG_D(Log::APP, "Fast queue full, slow path for %s", name);
+    if (kind == Kind::Label) push(makeUpdateLabel(name, value));
+    else push(makeUpdateBinding(name, value));
+}
+
 void TaskQueue::process() {
     P::Map<P::String, std::unique_ptr<ITask>> keyed;
     std::vector<std::unique_ptr<ITask>> unkeyed;
-    
+
     xSemaphoreTake(m_mutex, portMAX_DELAY);
-    keyed.swap(m_keyed);
-    unkeyed.swap(m_unkeyed);
+    Frame& f = m_frames[m_back];
+    m_back ^= 1;
+    if (!m_keyed.empty()) keyed.swap(m_keyed);
+    if (!m_unkeyed.empty()) unkeyed.swap(m_unkeyed);
     xSemaphoreGive(m_mutex);
-    
+
+    // Names are only added, never moved: safe to read without the lock
+    for (size_t i = 0; i < f.count; i++) {
+        const Record& r = f.records[i];
+        const char* name = m_names + m_nameOff[r.key];
+        const char* value = f.values + r.valueOff;
+        if (r.kind == Kind::Label) ui_set_text_internal(name, value);
+        else ui_update_bindings(name, value);
+    }
+
     for (auto& [key, task] : keyed) {
         if (task) task->execute();
     }
     for (auto& task : unkeyed) {
         if (task) task->execute();
     }
+
+    xSemaphoreTake(m_mutex, portMAX_DELAY);
+    resetFrame(f);
+    if (m_hashSlots && (m_keyCount > m_maxKeys * 3 / 4 || m_namesUsed > m_nameArena * 3 / 4)) {
+        // Can't grow (limit or no memory) and full: names of a previous app
+        // fill the table, forget them once nothing refers to them
+        if (!growNames() && m_internFull && m_frames[m_back].count == 0) {
+            memset(m_hashSlots, 0, m_maxKeys * 2 * sizeof(uint16_t));
+            m_keyCount = 0;
+            m_namesUsed = 0;
+        }
+    }
+    m_internFull = false;
+    xSemaphoreGive(m_mutex);
 }
 
 size_t TaskQueue::size() {
     xSemaphoreTake(m_mutex, portMAX_DELAY);
-    size_t sz = m_keyed.size() + m_unkeyed.size();
+    size_t sz = m_frames[0].count + m_frames[1].count + m_keyed.size() + m_unkeyed.size();
     xSemaphoreGive(m_mutex);
     return sz;
 }
 
 void TaskQueue::clear() {
     xSemaphoreTake(m_mutex, portMAX_DELAY);
+    for (auto& f : m_frames) {
+        if (f.pending) resetFrame(f);
+    }
     m_keyed.clear();
     m_unkeyed.clear();
     xSemaphoreGive(m_mutex);
@@ -66,6 +255,14 @@ void TaskQueue::clear() {
 void TaskQueue::destroy() {
     if (s_instance) {
         s_instance->clear();
+        for (auto& f : s_instance->m_frames) {
+            free(f.records);
+            free(f.values);
+            free(f.pending);
+        }
+        free(s_instance->m_hashSlots);
+        free(s_instance->m_nameOff);
+        free(s_instance->m_names);
         vSemaphoreDelete(s_instance->m_mutex);
         delete s_instance;
         s_instance = nullptr;
@@ -78,12 +275,20 @@ void postTask(std::unique_ptr<ITask> task) {
     TaskQueue::instance().push(std::move(task));
 }
 
+void updateLabel(const char* labelId, const char* value) {
+    TaskQueue::instance().push(TaskQueue::Kind::Label, labelId, value);
+}
+
+void updateBinding(const char* varName, const char* value) {
+    TaskQueue::instance().push(TaskQueue::Kind::Binding, varName, value);
+}
+
 void updateLabel(const P::String& labelId, const P::String& value) {
-    TaskQueue::instance().push(std::make_unique<UpdateLabelTask>(labelId, value));
+    updateLabel(labelId.c_str(), value.c_str());
 }
 
 void updateBinding(const P::String& varName, const P::String& value) {
-    TaskQueue::instance().push(std::make_unique<UpdateBindingTask>(varName, value));
+    updateBinding(varName.c_str(), value.c_str());
 }
 
 void processTasks() {
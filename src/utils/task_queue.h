@@ -10,21 +10,85 @@
 
 /**
  * TaskQueue - потокобезопасная очередь задач с дедупликацией
+ *
+ * Fast path (updateLabel / updateBinding): fixed-size record ring per frame,
+ * value bytes in a frame arena, names interned once into an open-addressed
+ * table; dedupe is an array lookup by interned id. Enqueue and process do
+ * no heap operations in steady state. Two frames: producers fill the back
+ * one while the main loop executes the front one.
+ *
+ * The name table starts at INITIAL_KEYS and doubles (rehash) from process()
+ * once 3/4 full, up to MAX_KEYS; names that don't fit meanwhile take the
+ * slow path for the rest of that frame. Only a full table at the limit is
+ * reset (names of a previous app).
+ *
+ * Slow path: any ITask (keyed -> map, unkeyed -> vector). Also used when a
+ * fast frame overflows, so nothing is dropped.
+ *
+ * Order per process(): fast records (first-enqueue order, last value wins),
+ * then keyed ITask by key, then unkeyed ITask.
  */
 class TaskQueue {
+public:
+    enum class Kind : uint8_t { Label = 0, Binding = 1 };
+
+    static constexpr size_t MAX_RECORDS = 512;       // per frame
+    static constexpr size_t VALUE_ARENA = 8 * 1024;  // per frame, value bytes + NUL
+    static constexpr size_t INITIAL_KEYS = 256;      // interned names, power of two
+    static constexpr size_t MAX_KEYS = 4096;
+    static constexpr size_t INITIAL_NAME_ARENA = 4 * 1024;
+    static constexpr size_t MAX_NAME_ARENA = 64 * 1024;  // uint16_t offsets
+
 private:
+    struct Record {
+        uint16_t key;           // interned id
+        Kind kind;
+        uint8_t reserved;
+        uint16_t valueOff;
+        uint16_t valueLen;
+        uint16_t valueCap;      // bytes reserved at valueOff (without NUL)
+    };
+
+    struct Frame {
+        Record* records = nullptr;
+        char* values = nullptr;
+        uint16_t* pending = nullptr;   // [key * 2 + kind] -> record index + 1
+        size_t count = 0;
+        size_t valuesUsed = 0;
+        bool overflow = false;         // rest of the frame goes to slow path
+    };
+
+    Frame m_frames[2];
+    uint8_t m_back = 0;
+
+    // Interned names
+    uint16_t* m_hashSlots = nullptr;   // m_maxKeys * 2: key id + 1, 0 = empty
+    uint16_t* m_nameOff = nullptr;
+    char* m_names = nullptr;
+    size_t m_maxKeys = INITIAL_KEYS;
+    size_t m_nameArena = INITIAL_NAME_ARENA;
+    size_t m_namesUsed = 0;
+    size_t m_keyCount = 0;
+    bool m_internFull = false;         // a name didn't fit since the last process()
+
     P::Map<P::String, std::unique_ptr<ITask>> m_keyed;
     std::vector<std::unique_ptr<ITask>> m_unkeyed;
     SemaphoreHandle_t m_mutex = nullptr;
-    
+
     static TaskQueue* s_instance;
     TaskQueue();
-    
+
+    int intern(const char* name);
+    bool growNames();
+    bool pushFast(Kind kind, const char* name, const char* value);
+    void resetFrame(Frame& f);
+
 public:
     static TaskQueue& instance();
     static void destroy();
-    
+
     void push(std::unique_ptr<ITask> task);
+    void push(Kind kind, const char* name, const char* value);
     void process();
     size_t size();
     void clear();
@@ -32,6 +96,8 @@ public:
 
 namespace UI {
     void postTask(std::unique_ptr<ITask> task);
+    void updateLabel(const char* labelId, const char* value);
+    void updateBinding(const char* varName, const char* value);
     void updateLabel(const P::String& labelId, const P::String& value);
     void updateBinding(const P::String& varName, const P::String& value);
     void processTasks();
@@ -0,0 +1,158 @@
+#include "utils/trace.h"
+#include "console/console.h"
+#include "utils/log_config.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <cstdio>
+
+static const char* TAG = "Trace";
+
+namespace Trace {
+
+bool g_on = false;
+static Event* s_ring = nullptr;
+static std::atomic<uint32_t> s_head{0};
+
+uint32_t nowUs() {
+    return (uint32_t)esp_timer_get_time();
+}
+
+void record(const char* name, uint32_t ts, uint32_t dur) {
+    if (!s_ring) return;
+    uint32_t idx = s_head.fetch_add(1, std::memory_order_relaxed);
+    Event& e = s_ring[idx & (RING_EVENTS - 1)];
+    e.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    e.name = name;
+    e.ts = ts;
+    e.dur = dur;
+    e.tid = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+    e.seq.store(idx + 1, std::memory_order_release);
+}
+
+bool setEnabled(bool on) {
+    if (on && !s_ring) {
+        size_t bytes = RING_EVENTS * sizeof(Event);
+        s_ring = (Event*)heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM);
+        if (!s_ring) s_ring = (Event*)heap_caps_calloc(1, bytes, MALLOC_CAP_DEFAULT);
+        if (!s_ring) return false;
+    }
+    g_on = on;
+    LOG_I(Log::APP, "Tracing %s", on ? "on" : "off");
+    return true;
+}
+
+void clear() {
+    if (!s_ring) return;
+    bool was = g_on;
+    g_on = false;
+    for (uint32_t i = 0; i < RING_EVENTS; i++) s_ring[i].seq.store(0, std::memory_order_relaxed);
+    s_head.store(0, std::memory_order_release);
+    g_on = was;
+}
+
+uint32_t recorded() {
+    return s_head.load(std::memory_order_relaxed);
+}
+
+// ---- Chrome Trace Event JSON ----
+
+struct Rec {
+    const char* name;
+    uint32_t ts;
+    uint32_t dur;
+    uint32_t tid;
+};
+
+// Snapshot of the ring, formatted one line at a time on read(). size() is
+// known up front (BLE sends it first), so every line is formatted twice.
+class JsonSource : public Console::PayloadSource {
+public:
+    JsonSource(Rec* recs, uint32_t count) : m_recs(recs), m_count(count) {
+        m_loopTid = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+        m_loopName = pcTaskGetName(nullptr);
+        m_base = count ? recs[0].ts : 0;
+        for (uint32_t i = 0; i < count; i++) {
+            if ((int32_t)(recs[i].ts - m_base) < 0) m_base = recs[i].ts;
+        }
+        char line[LINE];
+        for (uint32_t i = 0; i < count + 2; i++) m_size += format(i, line);
+    }
+
+    ~JsonSource() override { heap_caps_free(m_recs); }
+
+    uint32_t size() const override { return m_size; }
+
+    size_t read(uint8_t* dst, size_t max) override {
+        size_t n = 0;
+        while (n < max) {
+            if (m_pos == m_len) {
+                if (m_next >= m_count + 2) break;
+                m_len = format(m_next++, m_line);
+                m_pos = 0;
+            }
+            size_t take = m_len - m_pos < max - n ? m_len - m_pos : max - n;
+            memcpy(dst + n, m_line + m_pos, take);
+            m_pos += take;
+            n += take;
+        }
+        return n;
+    }
+
+private:
+    static constexpr size_t LINE = 160;
+
+    Rec* m_recs;
+    uint32_t m_count;
+    uint32_t m_base = 0;
+    uint32_t m_loopTid = 0;
+    const char* m_loopName = "";
+    uint32_t m_size = 0;
+    uint32_t m_next = 0;        // line index: 0 = head, 1..count = spans, count+1 = tail
+    char m_line[LINE];
+    size_t m_len = 0;
+    size_t m_pos = 0;
+
+    size_t format(uint32_t i, char* out) const {
+        int n;
+        if (i == 0) {
+            n = snprintf(out, LINE, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        } else if (i <= m_count) {
+            const Rec& r = m_recs[i - 1];
+            n = snprintf(out, LINE, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":%u},\n",
+                         r.name ? r.name : "?", (unsigned)(r.ts - m_base), (unsigned)r.dur, (unsigned)r.tid);
+        } else {
+            n = snprintf(out, LINE, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                         "\"args\":{\"name\":\"%s\"}}\n]}\n", (unsigned)m_loopTid, m_loopName);
+        }
+        return n < 0 ? 0 : (size_t)n < LINE ? (size_t)n : LINE - 1;
+    }
+};
+
+Console::PayloadSource* dumpJson() {
+    if (!s_ring) return nullptr;
+
+    uint32_t head = s_head.load(std::memory_order_acquire);
+    uint32_t from = head > RING_EVENTS ? head - RING_EVENTS : 0;
+    size_t bytes = (size_t)(head - from) * sizeof(Rec);
+    Rec* recs = (Rec*)heap_caps_malloc(bytes ? bytes : 1, MALLOC_CAP_SPIRAM);
+    if (!recs) recs = (Rec*)heap_caps_malloc(bytes ? bytes : 1, MALLOC_CAP_DEFAULT);
+    if (!recs) return nullptr;
+
+    // Committed, not overwritten while copying (same check as Log::dump)
+    uint32_t count = 0;
+    for (uint32_t idx = from; idx != head; idx++) {
+        const Event& e = s_ring[idx & (RING_EVENTS - 1)];
+        uint32_t seq = e.seq.load(std::memory_order_acquire);
+        if (seq != idx + 1) continue;
+        Rec r = { e.name, e.ts, e.dur, e.tid };
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e.seq.load(std::memory_order_relaxed) != seq) continue;
+        recs[count++] = r;
+    }
+    return new JsonSource(recs, count);
+}
+
+} // namespace Trace
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Trace — scoped spans dumped as Chrome Trace Event JSON (Perfetto,
+ * chrome://tracing)
+ *
+ *   void Foo::process() {
+ *       TRACE_SCOPE("foo");
+ *       ...
+ *   }
+ *
+ * A span records {name, start us, duration us, task} into a PSRAM ring
+ * when it closes: one fetch_add, no formatting, any task. "trace on"
+ * allocates the ring, "trace dump" streams {"traceEvents":[...]} with
+ * "ph":"X" events; when the ring laps, the oldest spans are lost.
+ * Names must be string literals without quotes — only the pointer is kept.
+ *
+ * Off at runtime a span costs one bool check. -DTRACE_ENABLED=0 in
+ * build_flags removes every TRACE_SCOPE / TRACE_SPAN from the build.
+ */
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+namespace Console { class PayloadSource; }
+
+namespace Trace {
+
+static constexpr uint32_t RING_EVENTS = 4096;   // power of two
+
+struct Event {
+    std::atomic<uint32_t> seq;  // index + 1 when committed, 0 while written
+    const char* name;
+    uint32_t ts;                // us, esp_timer (wraps after ~71 min)
+    uint32_t dur;
+    uint32_t tid;               // FreeRTOS task handle
+};
+
+extern bool g_on;
+
+uint32_t nowUs();
+void record(const char* name, uint32_t ts, uint32_t dur);
+
+/// Allocates the ring on first use; off keeps recorded spans for dump
+bool setEnabled(bool on);
+inline bool enabled() { return g_on; }
+void clear();
+uint32_t recorded();            // spans since clear (including lost)
+
+/// JSON of the spans still in the ring (transport deletes it), nullptr if never on
+Console::PayloadSource* dumpJson();
+
+class Span {
+public:
+    explicit Span(const char* name) : m_name(g_on ? name : nullptr), m_t0(m_name ? nowUs() : 0) {}
+    ~Span() { end(); }
+
+    /// Close early (e.g. before the loop's idle delay)
+    void end() {
+        if (!m_name) return;
+        record(m_name, m_t0, nowUs() - m_t0);
+        m_name = nullptr;
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* m_name;
+    uint32_t m_t0;
+};
+
+} // namespace Trace
+
+#if TRACE_ENABLED
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) Trace::Span TRACE_CONCAT(_traceSpan, __LINE__)(name)
+#define TRACE_SPAN(var, name) Trace::Span var(name)
+#define TRACE_END(var) var.end()
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_SPAN(var, name) do {} while (0)
+#define TRACE_END(var) do {} while (0)
+#endif
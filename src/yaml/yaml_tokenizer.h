@@ -0,0 +1,149 @@
+/**
+ * yaml_tokenizer.h - Single-pass line scanner over a YAML buffer
+ *
+ * Cursor walks the text once and never copies it: every significant line
+ * comes out as views into the original buffer (indent, key, value with the
+ * comment stripped but quotes kept). Blank and comment lines are skipped.
+ *
+ * Used by YamlParser (Lua tables) and YamlConfig (flat settings).
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace YamlTokenizer {
+
+using std::string_view;
+
+// ─── Helpers ────────────────────────────────────────────
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+inline string_view trim(string_view s) {
+    size_t start = 0, end = s.size();
+    while (start < end && isBlank(s[start])) start++;
+    while (end > start && isBlank(s[end - 1])) end--;
+    return s.substr(start, end - start);
+}
+
+inline bool isQuoted(string_view s) {
+    return s.size() >= 2 &&
+        ((s.front() == '"' && s.back() == '"') ||
+         (s.front() == '\'' && s.back() == '\''));
+}
+
+inline string_view unquote(string_view s) {
+    return isQuoted(s) ? s.substr(1, s.size() - 2) : s;
+}
+
+// Cut "  # comment" off a trimmed value ('#' inside quotes is kept)
+inline string_view stripComment(string_view s) {
+    bool inSingle = false, inDouble = false;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '\'' && !inDouble) inSingle = !inSingle;
+        else if (s[i] == '"' && !inSingle) inDouble = !inDouble;
+        else if (s[i] == '#' && !inSingle && !inDouble) {
+            // Must be preceded by space or be at start
+            if (i == 0 || isBlank(s[i - 1])) return trim(s.substr(0, i));
+        }
+    }
+    return s;
+}
+
+// ─── Line representation ────────────────────────────────
+
+struct Line {
+    int indent = 0;         // spaces, tab = 2
+    string_view key;        // empty for plain array items
+    string_view value;      // empty for section headers
+    bool isArrayItem = false;
+    bool isSection = false; // key: (no value, next lines are children)
+};
+
+// One raw line (without '\n'). False for blank and comment lines.
+inline bool scanLine(string_view raw, Line& line) {
+    if (!raw.empty() && raw.back() == '\r') raw.remove_suffix(1);
+
+    int indent = 0;
+    for (char c : raw) {
+        if (c == ' ') indent++;
+        else if (c == '\t') indent += 2;
+        else break;
+    }
+    string_view trimmed = trim(raw);
+    if (trimmed.empty() || trimmed[0] == '#') return false;
+
+    line = Line();
+    line.indent = indent;
+
+    // Array item: "- value" or "- key: value"
+    if (trimmed.size() >= 2 && trimmed[0] == '-' && trimmed[1] == ' ') {
+        line.isArrayItem = true;
+        string_view rest = trim(trimmed.substr(2));
+
+        // "- key: value" (map inside array), but not "- http://url"
+        size_t colonPos = rest.find(':');
+        if (colonPos != string_view::npos && colonPos > 0 &&
+            !isQuoted(rest) && rest[0] != '[') {
+            if (colonPos + 1 < rest.size() && rest[colonPos + 1] == ' ') {
+                line.key = trim(rest.substr(0, colonPos));
+                line.value = stripComment(trim(rest.substr(colonPos + 1)));
+                line.isSection = line.value.empty();
+                return true;
+            }
+            if (colonPos + 1 == rest.size()) {
+                line.key = trim(rest.substr(0, colonPos));
+                line.isSection = true;
+                return true;
+            }
+        }
+        line.value = stripComment(rest);
+        return true;
+    }
+
+    // Key: value pair
+    size_t colonPos = trimmed.find(':');
+    if (colonPos != string_view::npos && colonPos > 0 && !isQuoted(trimmed)) {
+        line.key = trim(trimmed.substr(0, colonPos));
+        line.value = stripComment(trim(trimmed.substr(colonPos + 1)));
+        line.isSection = line.value.empty();
+        return true;
+    }
+
+    // Plain value (shouldn't happen in valid YAML at top level)
+    line.value = stripComment(trimmed);
+    return true;
+}
+
+// ─── Cursor ─────────────────────────────────────────────
+
+// Current significant line; next() moves on. The text must outlive
+// the views handed out.
+class Cursor {
+public:
+    Cursor(const char* text, size_t len) : m_p(text), m_end(text + len) { next(); }
+
+    bool done() const { return m_done; }
+    const Line& line() const { return m_line; }
+
+    void next() {
+        while (m_p < m_end) {
+            const char* eol = static_cast<const char*>(memchr(m_p, '\n', m_end - m_p));
+            if (!eol) eol = m_end;
+            string_view raw(m_p, eol - m_p);
+            m_p = eol < m_end ? eol + 1 : m_end;
+            if (scanLine(raw, m_line)) return;
+        }
+        m_done = true;
+    }
+
+private:
+    const char* m_p;
+    const char* m_end;
+    Line m_line;
+    bool m_done = false;
+};
+
+} // namespace YamlTokenizer
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+Deferred log decoder v1.0
+
+Turns a "log dump" capture back into text. Records hold flash addresses of
+the format string and TAG, so the firmware ELF of the same build is needed
+to resolve them (without it, addresses are printed instead).
+
+Usage:
+    python log_decode.py dump.bin [.pio/build/<env>/firmware.elf]
+
+Dump layout (src/utils/log_ring.h / log_ring.cpp):
+    header: "BLOG", u16 version, u16 slot size, u32 count, u32 dropped
+    slot:   u32 seq, u32 ms, u32 fmt, u32 tag, u8 level, u8 cat, u8 nargs,
+            u8 used, u8 types[8], u8 data[36]
+"""
+
+import re
+import struct
+import sys
+from typing import Dict, List, Optional, Tuple
+
+HEADER = struct.Struct('<4sHHII')
+SLOT = struct.Struct('<IIIIBBBB8s36s')
+LEVELS = '-EWIDV'
+CATS = ['UI', 'LUA', 'STATE', 'APP', 'BLE']
+
+SPEC_RE = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcsfFeEgGaAp%])')
+
+
+class Elf32:
+    """Minimal ELF32 reader: allocated sections, string at address."""
+
+    def __init__(self, path: str):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1:
+            raise ValueError(f'{path}: not an ELF32 file')
+        (shoff,) = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', self.data, 0x2E)
+        self.sections: List[Tuple[int, int, int]] = []  # (addr, size, file offset)
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from('<IIIIII', self.data, shoff + i * shentsize)
+            # SHF_ALLOC, not NOBITS (.bss)
+            if flags & 0x2 and sh_type != 8 and addr and size:
+                self.sections.append((addr, size, offset))
+
+    def string(self, addr: int) -> Optional[str]:
+        for base, size, offset in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                end = self.data.find(b'\0', start, offset + size)
+                if end < 0:
+                    end = offset + size
+                return self.data[start:end].decode('utf-8', 'replace')
+        return None
+
+
+def read_args(types: bytes, nargs: int, data: bytes) -> List:
+    args = []
+    off = 0
+    for t in types[:nargs]:
+        t = chr(t)
+        if off >= len(data):
+            break
+        if t == 's':
+            n = data[off]
+            args.append(data[off + 1:off + 1 + n].decode('utf-8', 'replace'))
+            off += 1 + n
+        elif t == 'I':
+            args.append(struct.unpack_from('<q', data, off)[0])
+            off += 8
+        elif t == 'd':
+            args.append(struct.unpack_from('<d', data, off)[0])
+            off += 8
+        elif t == 'p':
+            args.append(('p', struct.unpack_from('<I', data, off)[0]))
+            off += 4
+        else:
+            args.append(struct.unpack_from('<i', data, off)[0])
+            off += 4
+    return args
+
+
+def c_format(fmt: str, args: List) -> str:
+    """printf replay with the same rules as Log::drain on the device."""
+    it = iter(args)
+    missing = object()
+
+    def repl(m: re.Match) -> str:
+        flags, width, prec, _, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(next(it, 0))
+        if prec == '*':
+            prec = str(next(it, 0))
+        value = next(it, missing)
+        if value is missing:
+            return '<?>'
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        if isinstance(value, tuple):
+            return f'0x{value[1]:08x}' if conv == 'p' else str(value[1])
+        if isinstance(value, str):
+            return (spec + 's') % value
+        if isinstance(value, float):
+            conv = conv if conv in 'fFeEgG' else 'g'
+            return (spec + conv) % value
+        if conv in 'ouxX' and value < 0:
+            value &= 0xFFFFFFFF
+        if conv == 'c':
+            return chr(value & 0xFF)
+        conv = conv if conv in 'diouxX' else 'd'
+        return (spec + conv.replace('u', 'd')) % value
+
+    return SPEC_RE.sub(repl, fmt)
+
+
+def decode(dump: bytes, elf: Optional[Elf32]) -> List[str]:
+    magic, version, slot_size, count, dropped = HEADER.unpack_from(dump, 0)
+    if magic != b'BLOG' or version != 1 or slot_size != SLOT.size:
+        raise ValueError(f'unsupported dump: {magic!r} v{version} slot={slot_size}')
+
+    lines = []
+    if dropped:
+        lines.append(f'# {dropped} records dropped on device')
+    cache: Dict[int, str] = {}
+
+    def resolve(addr: int) -> Optional[str]:
+        if addr not in cache:
+            cache[addr] = elf.string(addr) if elf else None
+        return cache[addr]
+
+    for i in range(count):
+        _, ms, fmt_addr, tag_addr, level, cat, nargs, _, types, data = \
+            SLOT.unpack_from(dump, HEADER.size + i * SLOT.size)
+        args = read_args(types, nargs, data)
+        fmt = resolve(fmt_addr)
+        tag = resolve(tag_addr) or f'0x{tag_addr:08x}'
+        if fmt is None:
+            text = f'<fmt 0x{fmt_addr:08x}> ' + ' '.join(str(a[1] if isinstance(a, tuple) else a) for a in args)
+        else:
+            text = c_format(fmt, args)
+        letter = LEVELS[level] if level < len(LEVELS) else '?'
+        cat_name = CATS[cat] if cat < len(CATS) else str(cat)
+        lines.append(f'[{ms:6d}][{letter}][{tag}] {text}' + ('' if elf else f'  ({cat_name})'))
+    return lines
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+    with open(sys.argv[1], 'rb') as f:
+        dump = f.read()
+    elf = Elf32(sys.argv[2]) if len(sys.argv) > 2 else None
+    for line in decode(dump, elf):
+        print(line)
+
+
+if __name__ == '__main__':
+    main()
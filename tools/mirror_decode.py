@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+Screen mirror decoder v1.0 — reference client for "mirror start"
+
+Rebuilds the screen from 'M' frames (src/utils/mirror.h) and writes the
+latest complete frame as a PPM image, so any viewer that reloads the file
+(or a test comparing images) can follow the device.
+
+Usage:
+    python mirror_decode.py /dev/ttyACM0 [out.ppm] [fps]   # live, Ctrl+C stops
+    python mirror_decode.py --file capture.bin [out.ppm] [W H]
+
+--file decodes raw serial bytes captured earlier (e.g. with a logic
+analyzer or `cat /dev/ttyACM0 > capture.bin` after "mirror start").
+
+Strip data: [x u16][y u16][w u16][rows u16][flags u8][0 u8][lz4 block]
+flags: 1 = last strip of the frame, 2 = key frame (whole screen).
+"""
+
+import json
+import os
+import struct
+import sys
+import time
+from typing import Iterator, Tuple
+
+from serial_console import FrameReader, parse_frame, run
+
+STRIP_HEAD = struct.Struct('<HHHHBB')
+
+
+def lz4_block_decompress(src: bytes, raw_size: int) -> bytes:
+    """Plain LZ4 block format (what LZ4_compress_* produces)."""
+    out = bytearray()
+    i = 0
+    n = len(src)
+    while i < n:
+        token = src[i]
+        i += 1
+        lit = token >> 4
+        if lit == 15:
+            while True:
+                b = src[i]
+                i += 1
+                lit += b
+                if b != 255:
+                    break
+        out += src[i:i + lit]
+        i += lit
+        if i >= n:
+            break                       # last sequence is literals only
+        offset = src[i] | (src[i + 1] << 8)
+        i += 2
+        if offset == 0 or offset > len(out):
+            raise ValueError('lz4: bad match offset')
+        match = (token & 15) + 4
+        if match == 19:
+            while True:
+                b = src[i]
+                i += 1
+                match += b
+                if b != 255:
+                    break
+        start = len(out) - offset
+        for k in range(match):          # may overlap itself
+            out.append(out[start + k])
+    if len(out) != raw_size:
+        raise ValueError(f'lz4: {len(out)} bytes, expected {raw_size}')
+    return bytes(out)
+
+
+class Mirror:
+    """RGB565 screen rebuilt from strips."""
+
+    def __init__(self, width: int, height: int):
+        self.width = width
+        self.height = height
+        self.fb = bytearray(width * height * 2)
+        self.frame = -1
+        self.frames = 0
+        self.synced = False             # seen a key frame
+
+    def apply(self, frame_no: int, data: bytes) -> bool:
+        """Apply one strip; True when it completed a frame."""
+        x, y, w, rows, flags, _ = STRIP_HEAD.unpack_from(data, 0)
+        if x + w > self.width or y + rows > self.height:
+            raise ValueError(f'strip {w}x{rows} at {x},{y} outside {self.width}x{self.height}')
+        raw = lz4_block_decompress(data[STRIP_HEAD.size:], w * rows * 2)
+        row_bytes = w * 2
+        for r in range(rows):
+            dst = ((y + r) * self.width + x) * 2
+            self.fb[dst:dst + row_bytes] = raw[r * row_bytes:(r + 1) * row_bytes]
+        self.frame = frame_no
+        if flags & 2:
+            self.synced = True
+        if flags & 1:
+            self.frames += 1
+            return True
+        return False
+
+    def rgb888(self) -> bytes:
+        out = bytearray(self.width * self.height * 3)
+        for i, (p,) in enumerate(struct.iter_unpack('<H', self.fb)):
+            r, g, b = p >> 11, (p >> 5) & 0x3F, p & 0x1F
+            out[i * 3:i * 3 + 3] = bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+        return bytes(out)
+
+    def save_ppm(self, path: str):
+        tmp = path + '.tmp'
+        with open(tmp, 'wb') as f:
+            f.write(b'P6\n%d %d\n255\n' % (self.width, self.height))
+            f.write(self.rgb888())
+        os.replace(tmp, path)           # viewers never see a half-written file
+
+
+def frames_from_bytes(stream: bytes) -> Iterator[Tuple[str, int, int, bytes]]:
+    for segment in stream.split(b'\0'):
+        if segment:
+            frame = parse_frame(segment)
+            if frame:
+                yield frame
+
+
+def decode_file(path: str, out: str, width: int, height: int) -> Mirror:
+    with open(path, 'rb') as f:
+        stream = f.read()
+    mirror = Mirror(width, height)
+    for ftype, fid, _, data in frames_from_bytes(stream):
+        if ftype == 'M' and mirror.apply(fid, data):
+            mirror.save_ppm(out)
+    return mirror
+
+
+def live(port_name: str, out: str, fps: int):
+    import serial  # pyserial
+
+    port = serial.Serial(port_name, 115200, timeout=0.1)
+    port.write(f'mirror start {fps}\n'.encode())
+    # One reader for the reply and the strips right behind it
+    reader = FrameReader(port)
+    mirror = None
+    for ftype, _, _, data in reader.frames(timeout=5.0):
+        if ftype == 'J':
+            response = json.loads(data)
+            info = response[2] if len(response) > 2 else None
+            if response[1] != 'ok' or not isinstance(info, dict):
+                sys.exit(f'mirror start failed: {response}')
+            mirror = Mirror(info['w'], info['h'])
+            print(f"{info['w']}x{info['h']} @ {info['fps']} fps -> {out}")
+            break
+    if mirror is None:
+        sys.exit('no reply to mirror start')
+
+    started = time.time()
+    received = 0
+    try:
+        while True:
+            for ftype, fid, _, data in reader.frames(timeout=1.0):
+                if ftype != 'M':
+                    continue
+                received += len(data)
+                if mirror.apply(fid, data):
+                    mirror.save_ppm(out)
+                    elapsed = time.time() - started
+                    sys.stdout.write(f'\rframe {fid:5d}  {mirror.frames / elapsed:5.1f} fps  '
+                                     f'{received / elapsed / 1024:7.1f} KB/s')
+                    sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    print()
+    port.reset_input_buffer()
+    response, _ = run(port, 'mirror stop', timeout=1.0)
+    if response:
+        print(response[2])
+    run(port, 'sys serial text', timeout=0.5)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+    if sys.argv[1] == '--file':
+        out = sys.argv[3] if len(sys.argv) > 3 else 'mirror.ppm'
+        width = int(sys.argv[4]) if len(sys.argv) > 4 else 480
+        height = int(sys.argv[5]) if len(sys.argv) > 5 else 480
+        mirror = decode_file(sys.argv[2], out, width, height)
+        print(f'{mirror.frames} frames, last #{mirror.frame} -> {out}')
+    else:
+        out = sys.argv[2] if len(sys.argv) > 2 else 'mirror.ppm'
+        fps = int(sys.argv[3]) if len(sys.argv) > 3 else 10
+        live(sys.argv[1], out, fps)
+
+
+if __name__ == '__main__':
+    main()
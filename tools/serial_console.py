@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+Serial Console v1.0 — framed binary mode client
+
+Switches the device to "sys serial framed", runs one command and writes
+the binary/string payload to a file. Frames: src/console/serial_frame.h.
+
+Usage:
+    python serial_console.py /dev/ttyACM0 "sys screen rgb16" [out.bin]
+    python serial_console.py /dev/ttyACM0 "log dump" dump.bin
+"""
+
+import json
+import struct
+import sys
+import time
+import zlib
+from typing import Iterator, List, Optional, Tuple
+
+FRAME_HEAD = struct.Struct('<BHHH')   # type, id, seq, len
+
+
+def cobs_decode(data: bytes) -> Optional[bytes]:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_frame(segment: bytes) -> Optional[Tuple[str, int, int, bytes]]:
+    """(type, id, seq, data) or None when segment is not a valid frame."""
+    body = cobs_decode(segment)
+    if body is None or len(body) < FRAME_HEAD.size + 4:
+        return None
+    ftype, fid, seq, length = FRAME_HEAD.unpack_from(body, 0)
+    if len(body) != FRAME_HEAD.size + length + 4:
+        return None
+    (crc,) = struct.unpack_from('<I', body, len(body) - 4)
+    if zlib.crc32(body[:-4]) != crc:
+        return None
+    return chr(ftype), fid, seq, body[FRAME_HEAD.size:FRAME_HEAD.size + length]
+
+
+class FrameReader:
+    """Splits a byte stream on 0x00; non-frame segments are device text."""
+
+    def __init__(self, port):
+        self.port = port
+        self.buf = bytearray()
+
+    def frames(self, timeout: float) -> Iterator[Tuple[str, int, int, bytes]]:
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            chunk = self.port.read(self.port.in_waiting or 1)
+            if not chunk:
+                continue
+            self.buf += chunk
+            while True:
+                end = self.buf.find(0)
+                if end < 0:
+                    break
+                segment = bytes(self.buf[:end])
+                del self.buf[:end + 1]
+                if not segment:
+                    continue
+                frame = parse_frame(segment)
+                if frame:
+                    deadline = time.time() + timeout
+                    yield frame
+                else:
+                    sys.stderr.write(segment.decode('utf-8', 'replace'))
+
+
+def run(port, command: str, timeout: float = 5.0) -> Tuple[Optional[list], bytes]:
+    """Send a command, return (v2 JSON response, payload bytes)."""
+    port.write(command.encode() + b'\n')
+    reader = FrameReader(port)
+    response = None
+    chunks: List[bytes] = []
+    expected_seq = 0
+    for ftype, _, seq, data in reader.frames(timeout):
+        if ftype == 'J':
+            msg = json.loads(data)
+            if isinstance(msg, list):
+                response = msg
+                info = msg[2] if len(msg) > 2 and isinstance(msg[2], dict) else {}
+                if msg[1] != 'ok' or 'bytes' not in info:
+                    break
+        elif ftype in 'BT':
+            if seq != expected_seq:
+                raise IOError(f'lost chunk {expected_seq} (got {seq})')
+            chunks.append(data)
+            expected_seq += 1
+        elif ftype == 'E':
+            total, crc = struct.unpack('<II', data)
+            payload = b''.join(chunks)
+            if len(payload) != total or zlib.crc32(payload) != crc:
+                raise IOError('payload size/crc mismatch')
+            return response, payload
+    return response, b''
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+    import serial  # pyserial
+
+    port = serial.Serial(sys.argv[1], 115200, timeout=0.1)
+    run(port, 'sys serial framed')
+    started = time.time()
+    response, payload = run(port, sys.argv[2])
+    elapsed = time.time() - started
+    print(json.dumps(response, ensure_ascii=False))
+    if payload:
+        print(f'{len(payload)} bytes in {elapsed:.2f}s ({len(payload) / elapsed / 1024:.1f} KB/s)')
+        if len(sys.argv) > 3:
+            with open(sys.argv[3], 'wb') as f:
+                f.write(payload)
+    run(port, 'sys serial text', timeout=0.5)
+
+
+if __name__ == '__main__':
+    main()